@@ -426,17 +426,17 @@ void Ctxt::keySwitchPart(const CtxtPart& p, const KeySwitch& W)
   // FIXME: This is a bug waiting to happen.
   DoubleCRT ai(context);
 
-  // Set the first ai using the seed, subsequent ai's (if any) will
-  // use the evolving RNG state (NOTE: this is not thread-safe)
-
-  RandomState state;
-  SetSeed(W.prgSeed);
+  // The ai's are regenerated from a local stream keyed by the seed, so
+  // concurrent key-switching operations do not share any PRG state
+  unsigned char key[NTL_PRG_KEYLEN];
+  seedToStreamKey(key, W.prgSeed);
+  RandomStream stream(key);
 
   // Add the columns in, one by one
   DoubleCRT tmp(context, IndexSet::emptySet());
   
   for (unsigned long i=0; i<polyDigits.size(); i++) {
-    ai.randomize();
+    ai.randomize(stream);
     tmp = polyDigits[i];
   
     // The operations below all use the IndexSet of tmp
@@ -450,7 +450,7 @@ void Ctxt::keySwitchPart(const CtxtPart& p, const KeySwitch& W)
     addPart(polyDigits[i], SKHandle(), /*matchPrimeSet=*/true);
   }
   noiseVar += addedNoise;
-} // restore random state upon destruction of the RandomState, see NumbTh.h
+}
 
 // Find the IndexSet such that modDown to that set of primes makes the
 // additive term due to rounding into the dominant noise term 
@@ -533,7 +533,7 @@ void Ctxt::addPart(const DoubleCRT& part, const SKHandle& handle,
   if (parts.size()==0) { // inserting 1st part 
     primeSet = part.getIndexSet();
     parts.push_back(CtxtPart(part,handle));
-    if (negative) parts.back().Negate(); // not thread-safe??
+    if (negative) parts.back().Negate();
   } else {               // adding to a ciphertext with existing parts
     assert(part.getIndexSet() <= primeSet);  // Sanity check
 
@@ -553,7 +553,7 @@ void Ctxt::addPart(const DoubleCRT& part, const SKHandle& handle,
       else          parts[j] += *ptr;
     } else {    // no mathing part found, just append this part
       parts.push_back(CtxtPart(*ptr,handle));
-      if (negative) parts.back().Negate(); // not thread-safe??
+      if (negative) parts.back().Negate();
     }
   }
 }
@@ -644,7 +644,7 @@ void Ctxt::addCtxt(const Ctxt& other, bool negative)
       else          parts[j] += part;
     } else {    // no mathing part found, just append this part
       parts.push_back(part);
-      if (negative) parts.back().Negate(); // not thread safe??
+      if (negative) parts.back().Negate();
     }
   }
   noiseVar += other_pt->noiseVar;
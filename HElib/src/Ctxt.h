@@ -633,6 +633,12 @@ void CheckCtxt(const Ctxt& c, const char* label);
 void extractDigits(vector<Ctxt>& digits, const Ctxt& c, long r=0);
 // implemented in extractDigits.cpp
 
+//! @brief Extract the digits of many ciphertexts, digits[k] gets the digits
+//! of c[k] as above. The ciphertexts are processed concurrently on the NTL
+//! thread pool.
+void extractDigits(vector< vector<Ctxt> >& digits, const vector<Ctxt>& c,
+                   long r=0);
+
 inline void extractDigits(vector<Ctxt>& digits, const Ctxt& c, long r, bool shortCut){
 	if (shortCut)
 		std::cerr << "extractDigits: the shortCut flag is disabled\n";
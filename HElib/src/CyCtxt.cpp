@@ -33,10 +33,292 @@
  *  --------------------------------------------------------------------
  */
 
+#include <cassert>
+#include <cmath>
+#include <mutex>
+#include <map>
+#include <memory>
+#include <sstream>
+
 #include "CyCtxt.h"
+#include "permutations.h"
 
 using namespace std;
 
+// The automatic recryption policy, shared by all the CyCtxt. Off until setAutoRecrypt is called.
+static mutex autoRecryptMutex;
+static bool autoRecryptEnabled = false;
+static long autoRecryptMinLevel = 0;
+static double autoRecryptMinCapacityBits = 0;
+
+// The permutation networks of permute. The generator trees only depend on the structure of Zm*: they are shared by
+// the contexts with the same contextFingerprint (computed once per context), and searched through the memo of the
+// fingerprint, which can be calibrated, saved and loaded. The plans hold masks encoded as DoubleCRT on one context: they
+// are kept per context (by address), encoding of the slots (see encodingOf) and hash of the permutation, and dropped
+// when their context is destroyed (see forgetContextCaches) or rebuilt by Cyfhel. At most maxPermutationPlans plans are
+// kept, the least recently used one is dropped first.
+typedef pair<FHEcontext const*, unsigned long> EncodingKey;
+typedef pair<EncodingKey, unsigned long> PermutationPlanKey;
+struct PermutationPlanEntry {
+	shared_ptr<PermNetworkPlan> plan;
+	unsigned long fingerprint;// contextFingerprint of the context of the plan
+	unsigned long lastUse;// Value of permutationPlanClock at the last use
+};
+static mutex permutationCacheMutex;
+static map< FHEcontext const*, unsigned long > contextFingerprints;
+static map< unsigned long, shared_ptr<GeneratorTreesMemo> > permutationMemos;
+static map< unsigned long, shared_ptr<GeneratorTrees> > permutationTrees;
+static map< PermutationPlanKey, PermutationPlanEntry > permutationPlans;
+static unsigned long permutationPlanClock = 0;
+static const unsigned long maxPermutationPlans = 64;
+
+// The encoding of the slots of ea on its context: the plaintext space p^r and the polynomial G. The masks encoded by
+// two EncryptedArrays of the same context with the same encoding are the same.
+static EncodingKey encodingOf(EncryptedArray const& ea){
+	ostringstream G;
+	if(ea.getTag() == PA_GF2_tag)
+	{
+		G << ea.getDerived(PA_GF2()).getG();
+	}
+	else
+	{
+		G << ea.getDerived(PA_zz_p()).getG();
+	}
+	string g = G.str();
+	long pPowR = ea.getAlMod().getPPowR();
+	return EncodingKey(&ea.getContext(), fnv1a(g.data(), g.size(), fnv1a(&pPowR, sizeof(pPowR))));
+}
+
+// The masks of segmentSum, per context, encoding of the slots (see encodingOf) and segment width: 1 in the first slot
+// of each segment. They are dropped with the permutation plans of their context (see forgetContextCaches). The mutex
+// also guards the masks of prefixSum.
+static mutex segmentMaskMutex;
+static map< pair<EncodingKey, long>, shared_ptr<DoubleCRT> > segmentMasks;
+
+// The masks of prefixSum, per context, encoding of the slots, dimension d and shift k: for k > 0 the slots whose
+// coordinate c along d is below size-k, for k < 0 the slots with c >= -k, for k = 0 the slots with c = size-1. They are
+// dropped with the segmentSum masks of their context.
+static map< pair<EncodingKey, pair<long, long> >, shared_ptr<DoubleCRT> > prefixMasks;
+
+// Drop the objects cached for context, called when it is destroyed (see addContextCleanup) and by clearContextCaches.
+static void forgetContextCaches(FHEcontext const& context){
+	{
+		lock_guard<mutex> lock(segmentMaskMutex);
+		map< pair<EncodingKey, long>, shared_ptr<DoubleCRT> >::iterator it = segmentMasks.begin();
+		while(it != segmentMasks.end())
+		{
+			if(it->first.first.first == &context)
+			{
+				segmentMasks.erase(it++);
+			}
+			else
+			{
+				++it;
+			}
+		}
+		map< pair<EncodingKey, pair<long, long> >, shared_ptr<DoubleCRT> >::iterator jt = prefixMasks.begin();
+		while(jt != prefixMasks.end())
+		{
+			if(jt->first.first.first == &context)
+			{
+				prefixMasks.erase(jt++);
+			}
+			else
+			{
+				++jt;
+			}
+		}
+	}
+	lock_guard<mutex> lock(permutationCacheMutex);
+	contextFingerprints.erase(&context);
+	map< PermutationPlanKey, PermutationPlanEntry >::iterator it = permutationPlans.begin();
+	while(it != permutationPlans.end())
+	{
+		if(it->first.first.first == &context)
+		{
+			permutationPlans.erase(it++);
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
+static const bool forgetContextCachesRegistered = (addContextCleanup(&forgetContextCaches), true);
+
+// The contextFingerprint of context, computed at its first use (the context is complete by then: CyCtxt are only built
+// on a context with its modulus chain).
+static unsigned long fingerprintOf(FHEcontext const& context){
+	{
+		lock_guard<mutex> lock(permutationCacheMutex);
+		map< FHEcontext const*, unsigned long >::iterator it = contextFingerprints.find(&context);
+		if(it != contextFingerprints.end())
+		{
+			return it->second;
+		}
+	}
+	const unsigned long fingerprint = contextFingerprint(context);
+	lock_guard<mutex> lock(permutationCacheMutex);
+	contextFingerprints[&context] = fingerprint;
+	return fingerprint;
+}
+
+// The mask of the first slots of the nslots/width segments of ea, encoded at its first use.
+static shared_ptr<DoubleCRT> segmentMaskOf(EncryptedArray const& ea, long width){
+	const pair<EncodingKey, long> key(encodingOf(ea), width);
+	{
+		lock_guard<mutex> lock(segmentMaskMutex);
+		map< pair<EncodingKey, long>, shared_ptr<DoubleCRT> >::iterator it = segmentMasks.find(key);
+		if(it != segmentMasks.end())
+		{
+			return it->second;
+		}
+	}
+	vector<long> mask(ea.size(), 0);
+	for(long i=0; i + width <= ea.size(); i += width)
+	{
+		mask[i] = 1;
+	}
+	ZZX poly;
+	ea.encode(poly, mask);
+	shared_ptr<DoubleCRT> dcrt(new DoubleCRT(poly, ea.getContext()));
+	lock_guard<mutex> lock(segmentMaskMutex);
+	return segmentMasks.insert(make_pair(key, dcrt)).first->second;
+}
+
+// The mask of prefixSum for the dimension d of ea and the shift k, encoded at its first use.
+static shared_ptr<DoubleCRT> prefixMaskOf(EncryptedArray const& ea, long d, long k){
+	const pair<EncodingKey, pair<long, long> > key(encodingOf(ea), make_pair(d, k));
+	{
+		lock_guard<mutex> lock(segmentMaskMutex);
+		map< pair<EncodingKey, pair<long, long> >, shared_ptr<DoubleCRT> >::iterator it = prefixMasks.find(key);
+		if(it != prefixMasks.end())
+		{
+			return it->second;
+		}
+	}
+	const long size = ea.sizeOfDimension(d);
+	vector<long> mask(ea.size(), 0);
+	for(long i=0; i<ea.size(); i++)
+	{
+		long c = ea.coordinate(d, i);
+		mask[i] = (k > 0) ? (c < size - k) : (k < 0) ? (c >= -k) : (c == size - 1);
+	}
+	ZZX poly;
+	ea.encode(poly, mask);
+	shared_ptr<DoubleCRT> dcrt(new DoubleCRT(poly, ea.getContext()));
+	lock_guard<mutex> lock(segmentMaskMutex);
+	return prefixMasks.insert(make_pair(key, dcrt)).first->second;
+}
+
+// Move the slots k steps along the dimension d with zero fill (as shift1D): the slots which would wrap around are masked
+// first, so a single automorphism is needed even along a bad dimension.
+static void maskedShift1D(EncryptedArray const& ea, Ctxt& ctxt, long d, long k){
+	const PAlgebra& al = ea.getContext().zMStar;
+	ctxt.multByConstant(*prefixMaskOf(ea, d, k));
+	ctxt.smartAutomorph(PowerMod(al.ZmStarGen(d), k, al.getM()));
+}
+
+// The memo of the generator trees of the context with this fingerprint, created with the static costs at its first use.
+static shared_ptr<GeneratorTreesMemo> permutationMemoOf(unsigned long fingerprint){
+	lock_guard<mutex> lock(permutationCacheMutex);
+	shared_ptr<GeneratorTreesMemo>& memo = permutationMemos[fingerprint];
+	if(!memo)
+	{
+		memo.reset(new GeneratorTreesMemo(fingerprint));
+	}
+	return memo;
+}
+
+// Install the memo of its context, the trees and plans of this context built with the previous one are dropped.
+static void installPermutationMemo(shared_ptr<GeneratorTreesMemo> const& memo){
+	const unsigned long fingerprint = memo->getFingerprint();
+	lock_guard<mutex> lock(permutationCacheMutex);
+	permutationMemos[fingerprint] = memo;
+	permutationTrees.erase(fingerprint);
+	map< PermutationPlanKey, PermutationPlanEntry >::iterator it = permutationPlans.begin();
+	while(it != permutationPlans.end())
+	{
+		if(it->second.fingerprint == fingerprint)
+		{
+			permutationPlans.erase(it++);
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
+
+// The generator trees of the context of ea, whose fingerprint is given, built at the first permutation (the same width
+// bound as Test_Permutations).
+static shared_ptr<GeneratorTrees> permutationTreesOf(EncryptedArray const& ea, unsigned long fingerprint){
+	{
+		lock_guard<mutex> lock(permutationCacheMutex);
+		map< unsigned long, shared_ptr<GeneratorTrees> >::iterator it = permutationTrees.find(fingerprint);
+		if(it != permutationTrees.end())
+		{
+			return it->second;
+		}
+	}
+	Vec<GenDescriptor> vec(INIT_SIZE, ea.dimension());
+	for(long i=0; i<ea.dimension(); i++)
+	{
+		vec[i] = GenDescriptor(ea.sizeOfDimension(i), ea.nativeDimension(i), i);
+	}
+	shared_ptr<GeneratorTrees> trees(new GeneratorTrees());
+	if(permutationMemoOf(fingerprint)->buildOptimalTrees(*trees, vec, 1 + (long) log2((double) ea.size())) == NTL_MAX_LONG)
+	{
+		return shared_ptr<GeneratorTrees>();
+	}
+	lock_guard<mutex> lock(permutationCacheMutex);
+	return permutationTrees.insert(make_pair(fingerprint, trees)).first->second;
+}
+
+// The plan of pi for ea, built at its first use.
+static shared_ptr<PermNetworkPlan> permutationPlanOf(EncryptedArray const& ea, vector<long> const& pi){
+	Permut perm(INIT_SIZE, pi.size());
+	for(unsigned long i=0; i<pi.size(); i++)
+	{
+		perm[i] = pi[i];
+	}
+	const unsigned long fingerprint = fingerprintOf(ea.getContext());
+	const PermutationPlanKey key(encodingOf(ea), fnv1a(pi.data(), pi.size()*sizeof(long)));
+	{
+		lock_guard<mutex> lock(permutationCacheMutex);
+		map< PermutationPlanKey, PermutationPlanEntry >::iterator it = permutationPlans.find(key);
+		if(it != permutationPlans.end() && it->second.plan->getPerm() == perm)
+		{
+			it->second.lastUse = ++permutationPlanClock;
+			return it->second.plan;
+		}
+	}
+	shared_ptr<GeneratorTrees> trees = permutationTreesOf(ea, fingerprint);
+	if(!trees)
+	{
+		return shared_ptr<PermNetworkPlan>();
+	}
+	shared_ptr<PermNetworkPlan> plan(new PermNetworkPlan(perm, *trees, ea));
+	lock_guard<mutex> lock(permutationCacheMutex);
+	if(permutationPlans.size() >= maxPermutationPlans && permutationPlans.find(key) == permutationPlans.end())
+	{
+		map< PermutationPlanKey, PermutationPlanEntry >::iterator oldest = permutationPlans.begin();
+		for(map< PermutationPlanKey, PermutationPlanEntry >::iterator it = permutationPlans.begin(); it != permutationPlans.end(); ++it)
+		{
+			if(it->second.lastUse < oldest->second.lastUse)
+			{
+				oldest = it;
+			}
+		}
+		permutationPlans.erase(oldest);
+	}
+	PermutationPlanEntry& entry = permutationPlans[key];
+	entry.plan = plan;
+	entry.fingerprint = fingerprint;
+	entry.lastUse = ++permutationPlanClock;
+	return plan;
+}
+
 /******CONSTRUCTOR BY DEFAULT******/
 
 
@@ -158,6 +440,169 @@ CyCtxt CyCtxt::scalarProd(long const& a){
 	return *this;
 }
 
+// SEGMENTED REDUCTIONS
+/*
+	@name: segmentSum
+	@description: Sum within the segments of width slots: the segment s holds the slots s*width, ..., (s+1)*width-1, for
+	              s < nslots/width. Each slot of a segment is replaced by the sum of the segment, the slots after the
+	              last segment by 0: segmentSum([1, 2, 3, 4, 5], 2) = [3, 3, 7, 7, 0].
+	              The slot i first gets the sum of the width slots from i on (shift-and-add on the bits of width, as
+	              totalSums), which is the sum of its segment in the first slot of each segment. Only these slots are
+	              kept, by a mask cached per width, then copied to the other slots of their segment the same way. All
+	              the rotations are by less than width slots, about 4*log2(width) of them.
+
+	@param: The method segmentSum takes one mandatory parameter: a long.
+	-param1: a mandatory long which corresponds to the width of the segments, between 1 and nslots.
+*/
+CyCtxt CyCtxt::segmentSum(long width){
+	EncryptedArray const& ea = m_encryptedArray ? *m_encryptedArray : *getContext().ea;
+	if(width < 1 || width > ea.size())
+	{
+		cerr<<"Error: segmentSum expects a width between 1 and "<<ea.size()<<"."<<endl;
+		return *this;
+	}
+	const long k = NumBits(width);
+
+	// Slot i: x[i] + ... + x[i+e-1], e -> 2e then e -> e+1 following the bits of width.
+	Ctxt orig(*this);
+	long e = 1;
+	for(long j=k-2; j>=0; j--)
+	{
+		Ctxt tmp(*this);
+		ea.rotate(tmp, -e);
+		*this += tmp;
+		e = 2*e;
+		if(bit(width, j))
+		{
+			ea.rotate(*this, -1);
+			*this += orig;
+			e++;
+		}
+	}
+
+	// Keep the first slot of each segment, then slot i: y[i-e+1] + ... + y[i], the same way.
+	multByConstant(*segmentMaskOf(ea, width));
+	orig = *this;
+	e = 1;
+	for(long j=k-2; j>=0; j--)
+	{
+		Ctxt tmp(*this);
+		ea.rotate(tmp, e);
+		*this += tmp;
+		e = 2*e;
+		if(bit(width, j))
+		{
+			ea.rotate(*this, 1);
+			*this += orig;
+			e++;
+		}
+	}
+	return *this;
+}
+
+/*
+	@name: segmentScalarProd
+	@description: Scalar products of the segments of width slots of this and cy (see segmentSum), computed by one
+	              multiplication and one segmentSum: the nslots/width scalar products of one ciphertext cost the same
+	              as one.
+
+	@param: The method segmentScalarProd takes two mandatory parameters: a CyCtxt and a long.
+	-param1: a mandatory CyCtxt which corresponds to the other vectors.
+	-param2: a mandatory long which corresponds to the width of the segments, between 1 and nslots.
+*/
+CyCtxt CyCtxt::segmentScalarProd(CyCtxt const& cy, long width){
+	this->multiplyBy(cy);
+	return segmentSum(width);
+}
+
+// PREFIX SUMS
+/*
+	@name: prefixSum
+	@description: Running sums over the slots: the slot i is replaced by the sum of the slots 0, ..., i, e.g.
+	              prefixSum([1, 2, 3, 4]) = [1, 3, 6, 10]. Same result as runningSums, which shifts the whole slot
+	              vector log2(nslots) times, every shift rotating along all the dimensions of the hypercube with its
+	              masks encoded again.
+	              Here the slots are seen as a hypercube, the last dimension the fastest. From the last dimension to
+	              the first, the running sums along a dimension are added to the result, minus what was already
+	              counted: those of the entries themselves for the last one, those of the totals of the dimensions
+	              after it for the other ones. A step is a shift along one dimension, i.e. a mask and a single
+	              automorphism, even along a bad dimension. The totals use rotate1D along the native dimensions, and
+	              the running sums again along the others. The masks are encoded once per context and encoding (see
+	              clearMaskCache).
+
+	@param: null.
+*/
+CyCtxt CyCtxt::prefixSum(){
+	EncryptedArray const& ea = m_encryptedArray ? *m_encryptedArray : *getContext().ea;
+	const long nd = ea.dimension();
+	if(nd == 0)
+	{
+		return *this;
+	}
+
+	Ctxt total(*this);// Along the dimensions after d: totals, replicated over these dimensions
+	for(long d=nd-1; d>=0; d--)
+	{
+		const long size = ea.sizeOfDimension(d);
+
+		// Running sums of total along d: 2^t steps at once, for the slots which have them.
+		Ctxt running(total);
+		for(long k=1; k<size; k*=2)
+		{
+			Ctxt tmp(running);
+			maskedShift1D(ea, tmp, d, k);
+			running += tmp;
+		}
+		if(d == nd-1)
+		{
+			Ctxt::operator=(running);
+		}
+		else
+		{
+			*this += running;
+			*this -= total;
+		}
+		if(d == 0)
+		{
+			break;
+		}
+
+		// Totals along d, replicated along d.
+		if(ea.nativeDimension(d))
+		{
+			Ctxt orig(total);
+			long e = 1;
+			for(long j=NumBits(size)-2; j>=0; j--)
+			{
+				Ctxt tmp(total);
+				ea.rotate1D(tmp, d, e);
+				total += tmp;
+				e = 2*e;
+				if(bit(size, j))
+				{
+					tmp = orig;
+					ea.rotate1D(tmp, d, e);
+					total += tmp;
+					e++;
+				}
+			}
+		}
+		else
+		{
+			// The last running sum is the total, copied backwards along d.
+			total = running;
+			total.multByConstant(*prefixMaskOf(ea, d, 0));
+			for(long k=1; k<size; k*=2)
+			{
+				Ctxt tmp(total);
+				maskedShift1D(ea, tmp, d, -k);
+				total += tmp;
+			}
+		}
+	}
+	return *this;
+}
+
 // Negate (what does it do?).
 CyCtxt CyCtxt::returnNegate() const{
     // Empty cyphertext object. Use of the copy constructor of class CyCtxt inherit from class Ctxt.
@@ -227,11 +672,439 @@ CyCtxt CyCtxt::returnCube() const{
 }
 
 
+// COMPARISONS
+/*
+	@name: comparisonBits
+	@description: Nº of bits of the slot values compared by compareGT. The slots of c hold integers mod 2^r and the comparisons
+	              only use the nbits lowest bits: the bits extracted by extractDigits live mod 2^{r-nbits+1}, which must hold
+	              any value of nbits bits, so nbits <= (r+1)/2.
+
+	@param: The method comparisonBits takes one mandatory parameter and one optional parameter: a Ctxt and a long.
+	-param1: a mandatory Ctxt which corresponds to a ciphertext to compare.
+	-param2 (optional)(Default: 0): a long which corresponds to the number of bits. If 0, the maximum (r+1)/2.
+
+	@return: Return a long, 0 if the ciphertext cannot be compared (p != 2, or nbits too large).
+*/
+long CyCtxt::comparisonBits(Ctxt const& c, long nbits){
+	const long p = c.getContext().zMStar.getP();
+	const long r = c.effectiveR();
+	if(p != 2)
+	{
+		cerr<<"Error: the comparisons need a plaintext space 2^r, here p = "<<p<<"."<<endl;
+		return 0;
+	}
+	if(nbits <= 0)
+	{
+		nbits = (r+1)/2;
+	}
+	if(nbits > (r+1)/2)
+	{
+		cerr<<"Error: cannot compare "<<nbits<<" bits with a plaintext space 2^"<<r<<", at most "<<(r+1)/2<<" bits."<<endl;
+		return 0;
+	}
+	return nbits;
+}
+
+/*
+	@name: compareBits
+	@description: Compare x and y given by their bits (lowest first, 0/1 in each slot, e.g. from extractDigits). With
+	              g_i = x_i(1-y_i) and e_i = 1-x_i-y_i+2x_iy_i, the pairs (g, e) of consecutive bits are merged by
+	              (g_h + e_h g_l, e_h e_l) as a binary tree, so the depth is log(nbits)+1 instead of nbits.
+
+	@param: The method compareBits takes two mandatory parameters: a vector of Ctxt and a vector of Ctxt of the same size.
+	-param1: a mandatory vector of Ctxt which corresponds to the bits of x.
+	-param2: a mandatory vector of Ctxt which corresponds to the bits of y.
+
+	@return: Return a Ctxt: 1 in the slots where x > y, 0 elsewhere.
+*/
+Ctxt CyCtxt::compareBits(vector<Ctxt> const& x, vector<Ctxt> const& y){
+	assert(!x.empty() && x.size() == y.size());
+	vector<Ctxt> greater, equal;
+	for(unsigned long i=0; i<x.size(); i++)
+	{
+		Ctxt xy = x[i];
+		xy.multiplyBy(y[i]);
+		Ctxt g = x[i];
+		g -= xy;
+		Ctxt e = xy;
+		e.multByConstant(to_ZZ(2));
+		e -= x[i];
+		e -= y[i];
+		e.addConstant(to_ZZ(1));
+		greater.push_back(g);
+		equal.push_back(e);
+	}
+	while(greater.size() > 1)
+	{
+		vector<Ctxt> nextGreater, nextEqual;
+		for(unsigned long i=0; i+1<greater.size(); i+=2)
+		{
+			// Bit i+1 is above bit i.
+			Ctxt g = equal[i+1];
+			g.multiplyBy(greater[i]);
+			g += greater[i+1];
+			nextGreater.push_back(g);
+			if(greater.size() > 2)// The last equal is not needed.
+			{
+				Ctxt e = equal[i+1];
+				e.multiplyBy(equal[i]);
+				nextEqual.push_back(e);
+			}
+		}
+		if(greater.size() % 2 == 1)
+		{
+			nextGreater.push_back(greater.back());
+			nextEqual.push_back(equal.back());
+		}
+		greater.swap(nextGreater);
+		equal.swap(nextEqual);
+	}
+	return greater[0];
+}
+
+// Comparison: compareGT([5, 2, 7], [3, 2, 9]) = [1, 0, 0].
+CyCtxt CyCtxt::compareGT(CyCtxt const& cy, long nbits) const{
+    CyCtxt result(*this);
+    nbits = comparisonBits(*this, nbits);
+    if(nbits == 0)
+    {
+        return result;
+    }
+    // Bits of both ciphertexts for all the slots at once, both extractions run concurrently.
+    vector<Ctxt> inputs;
+    inputs.push_back(*this);
+    inputs.push_back(cy);
+    vector< vector<Ctxt> > bits;
+    extractDigits(bits, inputs, nbits);
+    Ctxt& resultCtxt = result;
+    resultCtxt = compareBits(bits[0], bits[1]);
+    return result;
+}
+
+// Maximum: max([5, 2, 7], [3, 2, 9]) = [5, 2, 9].
+CyCtxt CyCtxt::max(CyCtxt const& cy, long nbits) const{
+    // this + [cy > this] * (cy - this)
+    CyCtxt greater = cy.compareGT(*this, nbits);
+    CyCtxt result(*this);
+    CyCtxt difference(cy);
+    difference -= *this;
+    difference.multiplyBy(greater);
+    result += difference;
+    return result;
+}
+
+
+
+// PERMUTATIONS
+/*
+	@name: permute
+	@description: Move the slots: the slot i gets the value of the slot pi[i] (as applyPermToVec). The permutation is
+	              done by a Benes permutation network along the dimensions of the hypercube, with one level per layer.
+	              The network of pi is built at its first use and kept (see PermNetworkPlan), so that the next
+	              permutations by pi only run its layers, with precomputed masks.
+
+	@param: The method permute takes one mandatory parameter: a vector of long.
+	-param1: a mandatory vector of long which corresponds to the permutation of the nslots slots.
+*/
+void CyCtxt::permute(vector<long> const& pi){
+	EncryptedArray const& ea = m_encryptedArray ? *m_encryptedArray : *getContext().ea;
+	vector<bool> seen(ea.size(), false);
+	bool isPermutation = ((long) pi.size() == ea.size());
+	for(unsigned long i=0; i<pi.size() && isPermutation; i++)
+	{
+		isPermutation = (pi[i] >= 0 && pi[i] < ea.size() && !seen[pi[i]]);
+		if(isPermutation)
+		{
+			seen[pi[i]] = true;
+		}
+	}
+	if(!isPermutation)
+	{
+		cerr<<"Error: permute expects a permutation of the "<<ea.size()<<" slots."<<endl;
+		return;
+	}
+	if(ea.size() == 1)
+	{
+		return;
+	}
+	shared_ptr<PermNetworkPlan> plan = permutationPlanOf(ea, pi);
+	if(!plan)
+	{
+		cerr<<"Error: no permutation network for this hypercube."<<endl;
+		return;
+	}
+	plan->applyToCtxt(*this);
+	recryptIfNeeded();
+}
+
+/*
+	@name: clearPermutationCache
+	@description: Forget the generator trees and the permutation networks built by permute, to free their memory.
+
+	@param: null.
+*/
+void CyCtxt::clearPermutationCache(){
+	lock_guard<mutex> lock(permutationCacheMutex);
+	permutationPlans.clear();
+	permutationTrees.clear();
+}
+
+/*
+	@name: clearContextCaches
+	@description: Forget the permutation networks and the masks built for context, e.g. when the context is replaced but
+	              kept alive (the caches of a context are dropped anyway when it is destroyed).
+
+	@param: The method clearContextCaches takes one mandatory parameter: a FHEcontext.
+	-param1: the context whose objects are forgotten.
+*/
+void CyCtxt::clearContextCaches(FHEcontext const& context){
+	forgetContextCaches(context);
+}
+
+/*
+	@name: clearMaskCache
+	@description: Forget the masks encoded by segmentSum and prefixSum for all the contexts, to free their memory (the
+	              masks of a context are dropped anyway when it is destroyed, see clearContextCaches).
+
+	@param: null.
+*/
+void CyCtxt::clearMaskCache(){
+	lock_guard<mutex> lock(segmentMaskMutex);
+	segmentMasks.clear();
+	prefixMasks.clear();
+}
+
+/*
+	@name: calibratePermutations
+	@description: Time the shifts along each dimension of the hypercube on this ciphertext (see PermCostModel), and
+	              search the generator trees of the next permutations of this context with these costs instead of
+	              the static ones (every shift counted as 1). The trees already searched are forgotten.
+
+	@param: null.
+*/
+void CyCtxt::calibratePermutations() const {
+	EncryptedArray const& ea = m_encryptedArray ? *m_encryptedArray : *getContext().ea;
+	PermCostModel model = PermCostModel::calibrate(ea, *this);
+	installPermutationMemo(shared_ptr<GeneratorTreesMemo>(new GeneratorTreesMemo(fingerprintOf(getContext()), model)));
+}
+
+/*
+	@name: savePermutationMemo
+	@description: Write the cost model and the generator trees searched so far for the context of this ciphertext,
+	              to be loaded by loadPermutationMemo in a later run.
+
+	@param: The method savePermutationMemo takes one mandatory parameter: an ostream.
+	-param1: a mandatory ostream where the memo is written.
+*/
+void CyCtxt::savePermutationMemo(ostream& out) const {
+	permutationMemoOf(fingerprintOf(getContext()))->write(out);
+}
+
+/*
+	@name: loadPermutationMemo
+	@description: Replace the cost model and the generator trees of the context of this ciphertext by the ones written
+	              by savePermutationMemo. A memo written for another context, or on a different build of it, is
+	              ignored.
+
+	@param: The method loadPermutationMemo takes one mandatory parameter: an istream.
+	-param1: a mandatory istream from which the memo is read.
+	@return: Return a bool, true if the memo was loaded.
+*/
+bool CyCtxt::loadPermutationMemo(istream& in) const {
+	shared_ptr<GeneratorTreesMemo> memo(new GeneratorTreesMemo(fingerprintOf(getContext())));
+	if(!memo->read(in))
+	{
+		return false;
+	}
+	installPermutationMemo(memo);
+	return true;
+}
+
+// BOOTSTRAPPING
+/*
+	@name: recrypt
+	@description: Refresh the ciphertext with the bootstrapping: the result encrypts the same slots at a high level, so
+	              that more multiplications can follow. The ciphertext must come from a Cyfhel object (m_publicKey), whose
+	              public key is bootstrappable (genRecryptData).
+
+	@param: null.
+*/
+void CyCtxt::recrypt(){
+	if(!m_publicKey)
+	{
+		cerr<<"Error: cannot recrypt, the CyCtxt was not encrypted by a Cyfhel object."<<endl;
+		return;
+	}
+	if(!m_publicKey->isBootstrappable())
+	{
+		cerr<<"Error: cannot recrypt, the public key has no bootstrapping data."<<endl;
+		return;
+	}
+	// reCrypt returns a ciphertext mod p^r: keep a smaller plaintext space (e.g. the digits of extractDigits).
+	const long ptxtSpace = getPtxtSpace();
+	m_publicKey->reCrypt(*this);
+	if(getPtxtSpace() != ptxtSpace)
+	{
+		reducePtxtSpace(ptxtSpace);
+	}
+}
+
+/*
+	@name: needsRecrypt
+	@description: Tell if the automatic recryption is on and the ciphertext is below one of its thresholds: less than
+	              minLevel levels left (findBaseLevel), or less than minCapacityBits bits between the noise and the modulus.
+
+	@param: null.
+*/
+bool CyCtxt::needsRecrypt() const{
+	long minLevel;
+	double minCapacityBits;
+	{
+		lock_guard<mutex> lock(autoRecryptMutex);
+		if(!autoRecryptEnabled)
+		{
+			return false;
+		}
+		minLevel = autoRecryptMinLevel;
+		minCapacityBits = autoRecryptMinCapacityBits;
+	}
+	if(isEmpty() || !m_publicKey || !m_publicKey->isBootstrappable())
+	{
+		return false;
+	}
+	double capacityBits = -log_of_ratio()/log(2.0);
+	return findBaseLevel() < minLevel || capacityBits < minCapacityBits;
+}
+
+/*
+	@name: recryptIfNeeded
+	@description: Recrypt the ciphertext if needsRecrypt(). The CyCtxt products call it on their results.
+
+	@param: null.
+
+	@return: Return true if the ciphertext was recrypted.
+*/
+bool CyCtxt::recryptIfNeeded(){
+	if(!needsRecrypt())
+	{
+		return false;
+	}
+	recrypt();
+	return true;
+}
+
+/*
+	@name: multiplyBy
+	@description: Same as Ctxt::multiplyBy (multiplication and relinearization), then recryptIfNeeded().
+
+	@param: The method multiplyBy takes one mandatory parameter: a Ctxt.
+	-param1: a mandatory Ctxt which corresponds to the other factor.
+*/
+void CyCtxt::multiplyBy(Ctxt const& other){
+	Ctxt::multiplyBy(other);
+	recryptIfNeeded();
+}
+
+/*
+	@name: multiplyBy2
+	@description: Same as Ctxt::multiplyBy2 (product by two ciphertexts), then recryptIfNeeded().
+
+	@param: The method multiplyBy2 takes two mandatory parameters: a Ctxt and a Ctxt.
+	-param1: a mandatory Ctxt which corresponds to the second factor.
+	-param2: a mandatory Ctxt which corresponds to the third factor.
+*/
+void CyCtxt::multiplyBy2(Ctxt const& other1, Ctxt const& other2){
+	Ctxt::multiplyBy2(other1, other2);
+	recryptIfNeeded();
+}
+
+// Square in place, recrypted if needed.
+void CyCtxt::square(){
+	multiplyBy(*this);
+}
+
+// Cube in place, recrypted if needed.
+void CyCtxt::cube(){
+	multiplyBy2(*this, *this);
+}
+
+/*
+	@name: multByConstant
+	@description: Same as Ctxt::multByConstant, then recryptIfNeeded(): the product by a constant adds noise too.
+
+	@param: The method multByConstant takes one mandatory parameter and one optional parameter: a DoubleCRT and a double.
+	-param1: a mandatory DoubleCRT which corresponds to the constant.
+	-param2 (optional)(Default: -1): the size of the constant, -1 for phi(m)*ptxtSpace^2 (see Ctxt::multByConstant).
+*/
+void CyCtxt::multByConstant(DoubleCRT const& dcrt, double size){
+	Ctxt::multByConstant(dcrt, size);
+	recryptIfNeeded();
+}
+
+void CyCtxt::multByConstant(ZZX const& poly, double size){
+	Ctxt::multByConstant(poly, size);
+	recryptIfNeeded();
+}
+
+void CyCtxt::multByConstant(zzX const& poly, double size){
+	Ctxt::multByConstant(poly, size);
+	recryptIfNeeded();
+}
+
+void CyCtxt::multByConstant(ZZ const& c){
+	Ctxt::multByConstant(c);
+	recryptIfNeeded();
+}
+
+/*
+	@name: setAutoRecrypt
+	@description: Turn on the automatic recryption of the CyCtxt products (and of the Cyfhel operations that check it).
+
+	@param: The method setAutoRecrypt takes one mandatory parameter and one optional parameter: a long and a double.
+	-param1: a long which corresponds to the minimal number of levels left.
+	-param2 (optional)(Default: 0): a double which corresponds to the minimal capacity in bits. If 0, only the levels are checked.
+*/
+void CyCtxt::setAutoRecrypt(long minLevel, double minCapacityBits){
+	lock_guard<mutex> lock(autoRecryptMutex);
+	autoRecryptEnabled = true;
+	autoRecryptMinLevel = minLevel;
+	autoRecryptMinCapacityBits = minCapacityBits;
+}
+
+/*
+	@name: disableAutoRecrypt
+	@description: Turn off the automatic recryption.
+
+	@param: null.
+*/
+void CyCtxt::disableAutoRecrypt(){
+	lock_guard<mutex> lock(autoRecryptMutex);
+	autoRecryptEnabled = false;
+}
+
+/*
+	@name: isAutoRecryptEnabled
+	@description: Tell if the automatic recryption is on.
+
+	@param: null.
+*/
+bool CyCtxt::isAutoRecryptEnabled(){
+	lock_guard<mutex> lock(autoRecryptMutex);
+	return autoRecryptEnabled;
+}
+
 
 /******IMPLEMENTATION OF PUBLIC METHODS: COMPARISON OPERATORS OVERLOAD******/
 
 
 /******IMPLEMENTATION OF PUBLIC METHODS: SHORTCUT OPERATORS OVERLOAD******/
+// Multiplication by a Ctxt, recrypted if needed.
+CyCtxt& CyCtxt::operator*=(Ctxt const& other){
+	Ctxt::operator*=(other);
+	recryptIfNeeded();
+	return *this;
+}
+
 // Scalar product: [1, 2, 3].[4, 5, 6] = [32, 32, 32] (because (1 * 4) + (2 * 5) + (3 * 6) = 32).
 CyCtxt& CyCtxt::operator%=(CyCtxt const& cy){
 	// Called the operator scalarProd of class CyCtxt to modify the copy of cy1: cy1_copy.
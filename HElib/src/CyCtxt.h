@@ -64,8 +64,57 @@ class CyCtxt: public Ctxt {
 	CyCtxt returnSquare() const;
 	CyCtxt returnCube() const;
 
+	// SEGMENTED REDUCTIONS
+	CyCtxt segmentSum(long width);// Replace each slot by the sum of its segment: the nslots/width aligned segments of width slots
+	CyCtxt segmentScalarProd(CyCtxt const& cy, long width);// Scalar products of the segments of this and cy, in all their slots
+
+	// PREFIX SUMS
+	CyCtxt prefixSum();// Replace the slot i by the sum of the slots 0, ..., i (as runningSums), one hypercube dimension at a time
+
+	static void clearMaskCache();// Forget the masks of segmentSum and prefixSum
+
+	CyCtxt compareGT(CyCtxt const& cy, long nbits = 0) const;// 1 in the slots where this > cy, 0 elsewhere (p = 2)
+	CyCtxt max(CyCtxt const& cy, long nbits = 0) const;// Slot-wise maximum of this and cy (p = 2)
+
+	static long comparisonBits(Ctxt const& c, long nbits = 0);// Nº of bits compared by compareGT, 0 if c cannot be compared
+	static Ctxt compareBits(vector<Ctxt> const& x, vector<Ctxt> const& y);// [x > y] from their bits, lowest first
+
+	// PERMUTATIONS
+	void permute(vector<long> const& pi);// Slot i gets the value of the slot pi[i], with a cached permutation network
+
+	static void clearPermutationCache();// Forget the permutation networks built by permute
+
+	static void clearContextCaches(FHEcontext const& context);// Forget the objects built for context (done when it is destroyed)
+
+	void calibratePermutations() const;// Search the networks of this context with the shift costs timed on this
+
+	void savePermutationMemo(std::ostream& out) const;// Write the searched networks of this context and their costs
+
+	bool loadPermutationMemo(std::istream& in) const;// Read them back, false if written for another context
+
+	// BOOTSTRAPPING
+	void recrypt();// Refresh the noise, needs a bootstrappable key (see Cyfhel bootstrappable constructor)
+	bool needsRecrypt() const;// True if the automatic recryption is on and this is below its thresholds
+	bool recryptIfNeeded();// Recrypt if needsRecrypt(), return true if recrypted
+
+	static void setAutoRecrypt(long minLevel, double minCapacityBits = 0);// Recrypt automatically the results below minLevel levels or minCapacityBits bits
+	static void disableAutoRecrypt();// Stop the automatic recryption (default)
+	static bool isAutoRecryptEnabled();// True if the automatic recryption is on
+
+	// PRODUCTS IN PLACE: they hide the Ctxt ones to call recryptIfNeeded() on their result. Through a Ctxt& (HElib
+	// functions such as totalSums or polyEval), the Ctxt ones run and the automatic recryption is skipped.
+	void multiplyBy(Ctxt const& other);
+	void multiplyBy2(Ctxt const& other1, Ctxt const& other2);
+	void square();
+	void cube();
+	void multByConstant(DoubleCRT const& dcrt, double size = -1.0);
+	void multByConstant(ZZX const& poly, double size = -1.0);
+	void multByConstant(zzX const& poly, double size = -1.0);
+	void multByConstant(ZZ const& c);
+
 	/******PROTOTYPES OF PUBLIC METHODS: SHORTCUT OPERATORS OVERLOAD******/
 	CyCtxt& operator%=(CyCtxt const& cy);
+	CyCtxt& operator*=(Ctxt const& other);// Product recrypted if needed (see PRODUCTS IN PLACE)
 
 
 };
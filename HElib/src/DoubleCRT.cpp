@@ -23,6 +23,7 @@
 
 #include "DoubleCRT.h"
 #include "timing.h"
+#include "multicore.h"
 
 
 // A threaded implementation of DoubleCRT operations
@@ -53,7 +54,9 @@ void DoubleCRT::FFT(const ZZX& poly, const IndexSet& s)
   Vec<long>& ivec = tls_ivec;
 
   long icard = MakeIndexVector(s, ivec);
-  NTL_EXEC_RANGE(icard, first, last)
+  // small index sets (e.g. a few special primes) are not worth a dispatch
+  bool seq = (threadsForWork(icard, context.zMStar.getPhiM()) <= 1);
+  NTL_GEXEC_RANGE(seq, icard, first, last)
       for (long j = first; j < last; j++) {
         long i = ivec[j];
         context.ithModulus(i).FFT(map[i], poly); 
@@ -72,7 +75,9 @@ void DoubleCRT::FFT(const zzX& poly, const IndexSet& s)
   Vec<long>& ivec = tls_ivec;
 
   long icard = MakeIndexVector(s, ivec);
-  NTL_EXEC_RANGE(icard, first, last)
+  // small index sets (e.g. a few special primes) are not worth a dispatch
+  bool seq = (threadsForWork(icard, context.zMStar.getPhiM()) <= 1);
+  NTL_GEXEC_RANGE(seq, icard, first, last)
       for (long j = first; j < last; j++) {
         long i = ivec[j];
         context.ithModulus(i).FFT(map[i], poly); 
@@ -473,6 +478,17 @@ DoubleCRT& DoubleCRT::operator=(const ZZX&poly)
   return *this;
 }
 
+DoubleCRT& DoubleCRT::operator=(const zzX&poly)
+{
+  if (isDryRun()) return *this;
+
+  const IndexSet& s = map.getIndexSet();
+
+  FFT(poly, s);
+
+  return *this;
+}
+
 DoubleCRT& DoubleCRT::operator=(const ZZ& num)
 {
   const IndexSet& s = map.getIndexSet();
@@ -553,7 +569,7 @@ void DoubleCRT::toPoly(ZZX& poly, const IndexSet& s,
   long phim = context.zMStar.getPhiM();
   long icard = MakeIndexVector(s1, ivec);
 
-  PartitionInfo pinfo(icard);
+  PartitionInfo pinfo(icard, threadsForWork(icard, phim));
   long cnt = pinfo.NumIntervals();
 
   remtab.SetLength(phim);
@@ -584,7 +600,7 @@ void DoubleCRT::toPoly(ZZX& poly, const IndexSet& s,
 
   {FHE_NTIMER_START(toPoly_CRT);
 
-  PartitionInfo pinfo1(phim);
+  PartitionInfo pinfo1(phim, threadsForWork(phim, icard));
   long cnt1 = pinfo1.NumIntervals();
 
   static thread_local ZZ tls_prod;
@@ -774,17 +790,29 @@ void DoubleCRT::automorph(long k)
 
 // fills each row i with random integers mod pi
 void DoubleCRT::randomize(const ZZ* seed) 
+{
+  if (seed == NULL) {
+    randomize(GetCurrentRandomStream());
+    return;
+  }
+
+  // Use a local stream rather than SetSeed, so we do not clobber the
+  // state of the PRG that other threads may be using
+  unsigned char key[NTL_PRG_KEYLEN];
+  seedToStreamKey(key, *seed);
+  RandomStream stream(key);
+  randomize(stream);
+}
+
+void DoubleCRT::randomize(RandomStream& stream)
 {
   FHE_TIMER_START;
 
   if (isDryRun()) return;
 
-  if (seed != NULL) SetSeed(*seed);
-
   const IndexSet& s = map.getIndexSet();
   long phim = context.zMStar.getPhiM();
 
-  RandomStream& stream = GetCurrentRandomStream();
   const long bufsz = 2048;
 
   Vec<unsigned char> buf_storage;
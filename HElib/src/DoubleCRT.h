@@ -19,6 +19,7 @@
 #include "NumbTh.h"
 #include "IndexMap.h"
 #include "FHEContext.h"
+#include "sampling.h"
 
 /**
 * @class DoubleCRTHelper
@@ -156,6 +157,7 @@ public:
   //  void partialCopy(const DoubleCRT& other, const IndexSet& s);
 
   DoubleCRT& operator=(const ZZX& poly);
+  DoubleCRT& operator=(const zzX& poly);
   DoubleCRT& operator=(const ZZ& num);
   DoubleCRT& operator=(const long num) { *this = to_ZZ(num); return *this; }
 
@@ -324,19 +326,27 @@ public:
   // Choose random DoubleCRT's, either at random or with small/Gaussian
   // coefficients. 
 
-  //! @brief Fills each row i with random ints mod pi, uses NTL's PRG
+  //! @brief Fills each row i with random ints mod pi, uses NTL's PRG.
+  //! If seed!=NULL the bits come from a local stream keyed by *seed (the
+  //! same bits as after SetSeed(*seed)), and NTL's PRG is not modified
   void randomize(const ZZ* seed=NULL);
 
+  //! @brief Same as above, drawing the random bits from stream
+  void randomize(RandomStream& stream);
+
+  // The small samplers below write into a zzX (see sampling.h) and go
+  // straight to FFT, without building a ZZX first
+
   //! @brief Coefficients are -1/0/1, Prob[0]=1/2
   void sampleSmall() {
-    ZZX poly; 
+    zzX poly; 
     ::sampleSmall(poly,context.zMStar.getPhiM()); // degree-(phi(m)-1) polynomial
     *this = poly; // convert to DoubleCRT
   }
 
   //! @brief Coefficients are -1/0/1 with pre-specified number of nonzeros
   void sampleHWt(long Hwt) {
-    ZZX poly; 
+    zzX poly; 
     ::sampleHWt(poly,Hwt,context.zMStar.getPhiM());
     *this = poly; // convert to DoubleCRT
   }
@@ -344,7 +354,7 @@ public:
   //! @brief Coefficients are Gaussians
   void sampleGaussian(double stdev=0.0) {
     if (stdev==0.0) stdev=to_double(context.stdev); 
-    ZZX poly; 
+    zzX poly; 
     ::sampleGaussian(poly, context.zMStar.getPhiM(), stdev);
     *this = poly; // convert to DoubleCRT
   }
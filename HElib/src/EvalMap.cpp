@@ -11,6 +11,8 @@
  */
 #include "EvalMap.h"
 #include "matmul.h"
+#include "binio.h"
+#include <stdexcept>
 
 // Forward declerations
 static MatMulBase*
@@ -129,7 +131,90 @@ void EvalMap::buildCache(MatrixCacheType cType)
     buildCache4MatMul1D(*matvec[i], i, cType);
 }
 
+// The cache of one matrix: its giant step, the cache type and the
+// constants. The DCRT constants are written as their (small) coefficients.
+static void writeMatCache(ostream& str, const MatMulBase& mat)
+{
+  CachedzzxMatrix* zCache;
+  CachedDCRTMatrix* dCache;
+  mat.getCache(&zCache, &dCache);
+
+  write_raw_long(str, mat.getGstep());
+  if (dCache != nullptr) {
+    write_raw_long(str, cacheDCRT);
+    write_raw_long(str, dCache->length());
+    for (long i = 0; i < dCache->length(); i++) {
+      write_raw_long(str, (*dCache)[i] != nullptr);
+      if ((*dCache)[i] == nullptr) continue;
+      ZZX poly;
+      (*dCache)[i]->toPoly(poly);
+      zzX coeffs;
+      convert(coeffs, poly);
+      write_raw_vec_long(str, coeffs);
+    }
+  }
+  else if (zCache != nullptr) {
+    write_raw_long(str, cachezzX);
+    write_raw_long(str, zCache->length());
+    for (long i = 0; i < zCache->length(); i++) {
+      write_raw_long(str, (*zCache)[i] != nullptr);
+      if ((*zCache)[i] != nullptr) write_raw_vec_long(str, *(*zCache)[i]);
+    }
+  }
+  else
+    write_raw_long(str, cacheEmpty);
+}
+
+static void readMatCache(istream& str, MatMulBase& mat)
+{
+  mat.setGstep(read_raw_long(str));
+  long cType = read_raw_long(str);
+  if (cType == cacheEmpty) return;
+
+  long n = read_raw_long(str);
+  if (cType == cacheDCRT) {
+    std::unique_ptr<CachedDCRTMatrix> dCache(new CachedDCRTMatrix());
+    dCache->SetLength(n);
+    for (long i = 0; i < n; i++) {
+      if (!read_raw_long(str)) continue;
+      zzX coeffs;
+      read_raw_vec_long(str, coeffs);
+      (*dCache)[i].reset(new DoubleCRT(coeffs, mat.getEA().getContext()));
+    }
+    mat.installDCRTcache(dCache);
+  }
+  else {
+    std::unique_ptr<CachedzzxMatrix> zCache(new CachedzzxMatrix());
+    zCache->SetLength(n);
+    for (long i = 0; i < n; i++) {
+      if (!read_raw_long(str)) continue;
+      (*zCache)[i].reset(new zzX());
+      read_raw_vec_long(str, *(*zCache)[i]);
+    }
+    mat.installzzxcache(zCache);
+  }
+}
+
+void EvalMap::writeCache(ostream& str) const
+{
+  write_raw_long(str, nfactors);
+  writeMatCache(str, *mat1);
+  for (long i = 0; i < matvec.length(); i++)
+    writeMatCache(str, *matvec[i]);
+}
+
+void EvalMap::readCache(istream& str)
+{
+  if (read_raw_long(str) != nfactors)
+    throw runtime_error("EvalMap::readCache: the cache is for another mvec");
+  readMatCache(str, *mat1);
+  for (long i = 0; i < matvec.length(); i++)
+    readMatCache(str, *matvec[i]);
+}
+
 // Applying the evaluation (or its inverse) map to a ciphertext
+// The stages are applied one after the other. Inside a stage, the
+// rotations of a cached matrix run concurrently (see concurrentSteps).
 void EvalMap::apply(Ctxt& ctxt) const
 {
   if (!invert) { // forward direction
@@ -67,6 +67,11 @@ public:
 
   void buildCache(MatrixCacheType cType);
   void apply(Ctxt& ctxt) const;
+
+  //! Write the caches of the matrices (binary, see binio.h), and read them
+  //! back into an EvalMap built with the same ea, mvec and invert
+  void writeCache(ostream& str) const;
+  void readCache(istream& str);
 };
 
 #endif
@@ -133,13 +133,12 @@ void KeySwitch::verify(FHESecKey& sk)
   vector<DoubleCRT> a;
   a.resize(n, DoubleCRT(context, allPrimes)); // defined modulo all primes
 
-  { RandomState state;
-
-    SetSeed(prgSeed);
+  { unsigned char key[NTL_PRG_KEYLEN];
+    seedToStreamKey(key, prgSeed);
+    RandomStream stream(key);
     for (long i = 0; i < n; i++)
-      a[i].randomize();
-
-  } // the RandomState destructor "restores the state" (see NumbTh.h)
+      a[i].randomize(stream);
+  }
 
   vector<ZZX> A, B;
 
@@ -557,7 +556,8 @@ long FHESecKey::ImportSecKey(const DoubleCRT& sKey, long Hwt,
   }
   skHwts.push_back(Hwt); // record the Hamming weight of the new secret-key
   sKeys.push_back(sKey); // add to the list of secret keys
-  long keyID = sKeys.size()-1; // not thread-safe?
+  long keyID = sKeys.size()-1; // key generation is not reentrant, callers
+                               // must not import keys concurrently
 
   for (long e=2; e<=maxDegKswitch; e++)
     GenKeySWmatrix(e,1,keyID,keyID); // s^e -> s matrix
@@ -599,11 +599,13 @@ void FHESecKey::GenKeySWmatrix(long fromSPower, long fromXPower,
   vector<DoubleCRT> a; 
   a.resize(n, DoubleCRT(context));
 
-  { RandomState state;
-    SetSeed(ksMatrix.prgSeed);
+  { // same stream as the one that keySwitchPart uses to regenerate the ai's
+    unsigned char key[NTL_PRG_KEYLEN];
+    seedToStreamKey(key, ksMatrix.prgSeed);
+    RandomStream stream(key);
     for (long i = 0; i < n; i++) 
-      a[i].randomize();
-  } // restore state upon destruction of state
+      a[i].randomize(stream);
+  }
 
   // Record the plaintext space for this key-switching matrix
   if (p<2) {
@@ -85,7 +85,7 @@ public:
 
   vector<DoubleCRT> b;  // The top row, consisting of the bi's
   ZZ prgSeed;        // a seed to generate the random ai's in the bottom row
-                     // NOTE: THIS USE OF THE NTL PRG IS NOT THREAD-SAFE 
+                     // (from a local stream, see seedToStreamKey)
 
   explicit
   KeySwitch(long sPow=0, long xPow=0, long fromID=0, long toID=0, long p=0):
@@ -10,6 +10,8 @@
  * limitations under the License. See accompanying LICENSE file.
  */
 
+#include <sstream>
+#include <mutex>
 #include "FHEContext.h"
 #include "EvalMap.h"
 #include "powerful.h"
@@ -427,6 +429,12 @@ void readContextBase(istream& str, unsigned long& m, unsigned long& p,
 }
 
 istream& operator>> (istream &str, FHEcontext& context)
+{
+  readContext(str, context, true);
+  return str;
+}
+
+void readContext(istream& str, FHEcontext& context, bool bootstrap)
 {
   seekPastChar(str, '[');  // this function is defined in NumbTh.cpp
 
@@ -471,16 +479,52 @@ istream& operator>> (istream &str, FHEcontext& context)
   str >> consFlag;
   str >> cType;
   if (mv.length()>0) {
-    context.makeBootstrappable(mv, t, consFlag, cType);
+    if (bootstrap)
+      context.makeBootstrappable(mv, t, consFlag, cType);
+    else { // only record the parameters
+      context.rcData.mvec = mv;
+      context.rcData.hwt = t;
+      context.rcData.conservative = consFlag;
+      context.rcData.cacheType = cType;
+    }
   }
 
   seekPastChar(str, ']');
-  return str;
+}
+
+// FNV-1a hash of the text written by writeContextBase and <<
+unsigned long contextFingerprint(const FHEcontext& context)
+{
+  ostringstream str;
+  writeContextBase(str, context);
+  str << context;
+  string data = str.str();
+  return fnv1a(data.data(), data.size());
+}
+
+// The functions registered by addContextCleanup
+static mutex contextCleanupMutex;
+static vector<void (*)(const FHEcontext&)>& contextCleanups()
+{
+  static vector<void (*)(const FHEcontext&)> cleanups;
+  return cleanups;
+}
+
+void addContextCleanup(void (*cleanup)(const FHEcontext& context))
+{
+  lock_guard<mutex> lock(contextCleanupMutex);
+  contextCleanups().push_back(cleanup);
 }
 
 #include "EncryptedArray.h"
 FHEcontext::~FHEcontext()
 {
+  vector<void (*)(const FHEcontext&)> cleanups;
+  {
+    lock_guard<mutex> lock(contextCleanupMutex);
+    cleanups = contextCleanups();
+  }
+  for (long i=0; i<(long)cleanups.size(); i++) cleanups[i](*this);
   delete ea;
 }
 
@@ -251,6 +251,14 @@ public:
 
   //! @brief read all other data associated with context
   friend istream& operator>> (istream &str, FHEcontext& context);
+
+  //! @brief read all other data as >> does. If bootstrap is false, the
+  //! bootstrapping parameters are only recorded in rcData and the context
+  //! is not made bootstrappable (e.g. to use RecryptData::read instead)
+  friend void readContext(istream& str, FHEcontext& context, bool bootstrap);
+
+  //! @brief a hash of all the data written by writeContextBase and <<
+  friend unsigned long contextFingerprint(const FHEcontext& context);
   ///@}
 };
 
@@ -259,6 +267,13 @@ void writeContextBase(ostream& s, const FHEcontext& context);
 //! @brief read [m p r gens ords] data, needed to construct context
 void readContextBase(istream& s, unsigned long& m, unsigned long& p, unsigned long& r,
 		     vector<long>& gens, vector<long>& ords);
+//! @brief read all other data, making the context bootstrappable only if bootstrap
+void readContext(istream& str, FHEcontext& context, bool bootstrap);
+//! @brief a hash of all the data written by writeContextBase and <<
+unsigned long contextFingerprint(const FHEcontext& context);
+//! @brief register a function called by ~FHEcontext, e.g. to drop the
+//! objects built on this context that are cached elsewhere by its address
+void addContextCleanup(void (*cleanup)(const FHEcontext& context));
 
 // VJS: compiler seems to need these declarations out here...wtf...
 
@@ -10,6 +10,7 @@
  * limitations under the License. See accompanying LICENSE file.
  */
 #include "NumbTh.h"
+#include "sampling.h"
 
 #include "timing.h"
 
@@ -631,71 +632,31 @@ template bool intVecCRT(vec_ZZ&, const ZZ&, const Vec<zz_p>&, long);
 #endif
 #endif
 
+// The ZZX samplers are thin wrappers around the zzX ones from sampling.h,
+// which take their randomness from a per-thread stream
+
 void sampleHWt(ZZX &poly, long Hwt, long n)
 {
   if (n<=0) n=deg(poly)+1; if (n<=0) return;
-  clear(poly);          // initialize to zero
-  poly.SetMaxLength(n); // allocate space for degree-(n-1) polynomial
-
-  long b,u,i=0;
-  if (Hwt>n) Hwt=n;
-  while (i<Hwt) {  // continue until exactly Hwt nonzero coefficients
-    u=lrand48()%n; // The next coefficient to choose
-    if (IsZero(coeff(poly,u))) { // if we didn't choose it already
-      b = lrand48()&2; // b random in {0,2}
-      b--;             //   random in {-1,1}
-      SetCoeff(poly,u,b);
-
-      i++; // count another nonzero coefficient
-    }
-  }
-  poly.normalize(); // need to call this after we work on the coeffs
+  zzX tmp;
+  sampleHWt(tmp, Hwt, n);
+  convert(poly, tmp);
 }
 
 void sampleSmall(ZZX &poly, long n)
 {
   if (n<=0) n=deg(poly)+1; if (n<=0) return;
-  poly.SetMaxLength(n); // allocate space for degree-(n-1) polynomial
-
-  for (long i=0; i<n; i++) {    // Chosse coefficients, one by one
-    long u = lrand48();
-    if (u&1) {                 // with prob. 1/2 choose between -1 and +1
-      u = (u & 2) -1;
-      SetCoeff(poly, i, u);
-    }
-    else SetCoeff(poly, i, 0); // with ptob. 1/2 set to 0
-  }
-  poly.normalize(); // need to call this after we work on the coeffs
+  zzX tmp;
+  sampleSmall(tmp, n);
+  convert(poly, tmp);
 }
 
 void sampleGaussian(ZZX &poly, long n, double stdev)
 {
-  static double const Pi=4.0*atan(1.0); // Pi=3.1415..
-  static long const bignum = 0xfffffff;
-  // THREADS: C++11 guarantees these are initialized only once
-
   if (n<=0) n=deg(poly)+1; if (n<=0) return;
-  poly.SetMaxLength(n); // allocate space for degree-(n-1) polynomial
-  for (long i=0; i<n; i++) SetCoeff(poly, i, ZZ::zero());
-
-  // Uses the Box-Muller method to get two Normal(0,stdev^2) variables
-  for (long i=0; i<n; i+=2) {
-    double r1 = (1+RandomBnd(bignum))/((double)bignum+1);
-    double r2 = (1+RandomBnd(bignum))/((double)bignum+1);
-    double theta=2*Pi*r1;
-    double rr= sqrt(-2.0*log(r2))*stdev;
-
-    assert(rr < 8*stdev); // sanity-check, no more than 8 standard deviations
-
-    // Generate two Gaussians RV's, rounded to integers
-    long x = (long) floor(rr*cos(theta) +0.5);
-    SetCoeff(poly, i, x);
-    if (i+1 < n) {
-      x = (long) floor(rr*sin(theta) +0.5);
-      SetCoeff(poly, i+1, x);
-    }
-  }
-  poly.normalize(); // need to call this after we work on the coeffs
+  zzX tmp;
+  sampleGaussian(tmp, n, stdev);
+  convert(poly, tmp);
 }
 
 void sampleUniform(ZZX& poly, const ZZ& B, long n)
@@ -722,6 +683,18 @@ void sampleUniform(ZZX& poly, const ZZ& B, long n)
 
 
 
+void seedToStreamKey(unsigned char *key, const ZZ& seed)
+{
+  // Same derivation as NTL's SetSeed(const ZZ&)
+  long nb = NumBytes(seed);
+  Vec<unsigned char> buf;
+  buf.SetLength(nb);
+  BytesFromZZ(buf.elts(), seed, nb);
+  DeriveKey(key, NTL_PRG_KEYLEN, buf.elts(), nb);
+}
+
+
+
 // ModComp: a pretty lame implementation
 
 void ModComp(ZZX& res, const ZZX& g, const ZZX& h, const ZZX& f)
@@ -1432,6 +1405,16 @@ void rem(zz_pX& r, const zz_pX& a, const zz_pXModulus1& ff)
    r = P2;
 }
 
+unsigned long fnv1a(const void* data, size_t size, unsigned long hash)
+{
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  for (size_t i=0; i<size; i++) {
+    hash ^= bytes[i];
+    hash *= 1099511628211UL;
+  }
+  return hash;
+}
+
 // Debug printing routines for vectors, ZZX'es, print only a few entries
 
 template<class T> ostream& printVec(ostream& s, const Vec<T>& v,
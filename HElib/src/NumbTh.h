@@ -626,6 +626,23 @@ private:
   RandomState& operator=(const RandomState&); // disable assignment
 };
 
+/**
+ * @brief Key a local RandomStream from a seed, instead of calling SetSeed.
+ *
+ * The key is derived exactly as NTL's SetSeed(seed) derives the key of
+ * its own stream, so a RandomStream constructed from it produces the same
+ * bits as the global PRG would after SetSeed(seed). Unlike the
+ * RandomState/SetSeed pattern above, this leaves the global PRG untouched
+ * and is safe to use from several threads at once:
+ * \code
+ *   unsigned char key[NTL_PRG_KEYLEN];
+ *   seedToStreamKey(key, seed);
+ *   RandomStream stream(key);
+ *   ...                 // draw bits from stream
+ * \endcode
+ **/
+void seedToStreamKey(unsigned char *key, const ZZ& seed);
+
 //! @brief Advance the input stream beyond white spaces and a single instance of the char cc
 void seekPastChar(istream& str, int cc);
 
@@ -706,6 +723,11 @@ inline long divc(long a, long b)
   return (a + b - 1)/b;
 }
 
+//! @brief FNV-1a hash of the size bytes at data, continued from hash
+//! (the default is the FNV offset basis, to hash a single buffer)
+unsigned long fnv1a(const void* data, size_t size,
+                    unsigned long hash=14695981039346656037UL);
+
 ///@{
 //! @name The size of the coefficient vector of a polynomial.
 ZZ sumOfCoeffs(const ZZX& f);  // = f(1)
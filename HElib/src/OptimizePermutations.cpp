@@ -17,6 +17,7 @@
 #include <cassert>
 #include <list>
 #include <sstream>
+#include <stdexcept>
 using namespace std;
 #if (__cplusplus>199711L)
 #include <memory>
@@ -555,11 +556,12 @@ public:
 
 class UpperMemoEntry {
 public:
-  long cost;
+  long cost;       // number of 1D shifts
+  double weighted; // cost of these shifts in the PermCostModel
   GenNodePtr solution;
 
-  UpperMemoEntry(long _cost, GenNodePtr _solution) {
-    cost = _cost; solution = _solution;
+  UpperMemoEntry(long _cost, double _weighted, GenNodePtr _solution) {
+    cost = _cost; weighted = _weighted; solution = _solution;
   }
 
   UpperMemoEntry() { }
@@ -685,9 +687,13 @@ LowerMemoEntry optimalLower(long order, bool good, long budget, long mid,
 // Optimizing a list of trees, trying all the ways of allocating the bugdet
 // and mid token between the trees. This procedure splits the "current
 // remaining budget" between trees i through vec.length()-1.
+// All the shifts in the tree of one generator cost the same in the model,
+// so the optimal tree for a budget does not depend on the model: only the
+// allocation between the trees is weighted here.
 UpperMemoEntry 
 optimalUpperAux(const Vec<GenDescriptor>& vec, long i, long budget, long mid,
-		UpperMemoTable& upperMemoTable, LowerMemoTable& lowerMemoTable)
+		UpperMemoTable& upperMemoTable, LowerMemoTable& lowerMemoTable,
+		const PermCostModel& model)
 {
   assert(i >= 0 && i <= vec.length());
   assert(budget >= 0);
@@ -700,6 +706,7 @@ optimalUpperAux(const Vec<GenDescriptor>& vec, long i, long budget, long mid,
   }
 
   long cost;
+  double weighted = 0.0;
   GenNodePtr solution;
 
   if (i == vec.length()) {
@@ -718,6 +725,8 @@ optimalUpperAux(const Vec<GenDescriptor>& vec, long i, long budget, long mid,
     // allocate resources (budget, mid) between generator i and the rest
 
     long bestCost = NTL_MAX_LONG;
+    double bestWeighted = 0.0;
+    double shiftCost = model.cost(vec[i].genIdx);
     LowerMemoEntry bestS;
     UpperMemoEntry bestT;
 
@@ -731,10 +740,14 @@ optimalUpperAux(const Vec<GenDescriptor>& vec, long i, long budget, long mid,
 
 	// Optimize the rest of the list with the remaining budget and mid
         UpperMemoEntry t = optimalUpperAux(vec, i+1, budget-budget1, mid-mid1,
-                                           upperMemoTable, lowerMemoTable);
-        if (s.cost != NTL_MAX_LONG && t.cost != NTL_MAX_LONG &&
-            s.cost + t.cost < bestCost) {
+                                           upperMemoTable, lowerMemoTable,
+                                           model);
+        if (s.cost == NTL_MAX_LONG || t.cost == NTL_MAX_LONG) continue;
+
+        double w = s.cost*shiftCost + t.weighted;
+        if (bestCost == NTL_MAX_LONG || w < bestWeighted) {
           bestCost = s.cost + t.cost;
+          bestWeighted = w;
           bestS = s;
           bestT = t;
         }
@@ -742,6 +755,7 @@ optimalUpperAux(const Vec<GenDescriptor>& vec, long i, long budget, long mid,
     }
 
     cost = bestCost;
+    weighted = bestWeighted;
     if (cost == NTL_MAX_LONG) 
       solution = GenNodePtr();
     else 
@@ -750,7 +764,7 @@ optimalUpperAux(const Vec<GenDescriptor>& vec, long i, long budget, long mid,
 
   // Record the best solution in the upperMemoTable and return it
   return upperMemoTable[UpperMemoKey(i, budget, mid)] 
-           = UpperMemoEntry(cost, solution);
+           = UpperMemoEntry(cost, weighted, solution);
 }
                      
 
@@ -870,12 +884,153 @@ static long copyToGenTree(OneGeneratorTree& gTree, SplitNodePtr& solution)
   return len;
 }
 
+/********************************************************************/
+/***** Serialized solutions, for GeneratorTreesMemo             *****/
+/********************************************************************/
+
+// A solution of optimalUpperAux is written as the number of trees followed
+// by the trees in the order of the generators, -1 if there is no solution.
+// A tree is written in prefix order, "L order mid good" and the two Benes
+// solutions (each one as its length then its counts) for a leaf, and
+// "N order mid good" then the two children for an internal node.
+
+static void writeLongList(ostream& s, LongNodePtr p)
+{
+  s << " " << length(p);
+  for (; p != NULL; p = p->next) s << " " << p->count;
+}
+
+static LongNodePtr readLongList(istream& s)
+{
+  long len;
+  if (!(s >> len) || len < 0)
+    throw runtime_error("readSplitTree: malformed solution");
+  Vec<long> counts(INIT_SIZE, len);
+  for (long i = 0; i < len; i++)
+    if (!(s >> counts[i]))
+      throw runtime_error("readSplitTree: malformed solution");
+
+  LongNodePtr p;
+  for (long i = len-1; i >= 0; i--) p = LongNodePtr(new LongNode(counts[i], p));
+  return p;
+}
+
+static void writeSplitTree(ostream& s, SplitNodePtr p)
+{
+  s << (p->isLeaf()? " L " : " N ") << p->order << " " << p->mid
+    << " " << p->good;
+  if (p->isLeaf()) {
+    writeLongList(s, p->solution1);
+    writeLongList(s, p->solution2);
+  }
+  else {
+    writeSplitTree(s, p->left);
+    writeSplitTree(s, p->right);
+  }
+}
+
+static SplitNodePtr readSplitTree(istream& s)
+{
+  string tag;
+  long order, mid;
+  bool good;
+  if (!(s >> tag >> order >> mid >> good) || (tag != "L" && tag != "N"))
+    throw runtime_error("readSplitTree: malformed solution");
+
+  if (tag == "L") {
+    LongNodePtr solution1 = readLongList(s);
+    LongNodePtr solution2 = readLongList(s);
+    return SplitNodePtr(new SplitNode(order, mid, good, solution1, solution2));
+  }
+  SplitNodePtr left = readSplitTree(s);
+  SplitNodePtr right = readSplitTree(s);
+  return SplitNodePtr(new SplitNode(order, mid, good, left, right));
+}
+
+// Check that a tree read by readSplitTree is one that optimalLower could
+// have built for this order: the orders of the children multiply to the
+// order of their parent, the mid token goes down to exactly one child (if
+// any), and each Benes solution collapses all the levels of the network
+static void checkBenesSolution(LongNodePtr p, long order)
+{
+  long nlev = 2*GeneralBenesNetwork::depth(order) - 1;
+  for (; p != NULL; p = p->next) {
+    if (p->count <= 0 || p->count > nlev)
+      throw runtime_error("checkSplitTree: bad Benes solution");
+    nlev -= p->count;
+  }
+  if (nlev != 0)
+    throw runtime_error("checkSplitTree: bad Benes solution");
+}
+
+static void checkSplitTree(SplitNodePtr p, long order)
+{
+  if (p->order != order || order < 1 || (p->mid != 0 && p->mid != 1))
+    throw runtime_error("checkSplitTree: inconsistent solution");
+
+  if (p->isLeaf()) {
+    checkBenesSolution(p->solution1, order);
+    if (p->mid == 1) {
+      if (p->solution2 != NULL)
+        throw runtime_error("checkSplitTree: inconsistent solution");
+    }
+    else checkBenesSolution(p->solution2, order);
+    return;
+  }
+  long order1 = p->left->order;
+  if (order1 < 2 || order1 >= order || order % order1 != 0
+      || p->left->mid + p->right->mid != p->mid)
+    throw runtime_error("checkSplitTree: inconsistent solution");
+  checkSplitTree(p->left, order1);
+  checkSplitTree(p->right, order/order1);
+}
+
+// Run the search and write its solution, returns its cost (# of 1D shifts)
+static long searchOptimalTrees(const Vec<GenDescriptor>& gens, long depthBound,
+                               const PermCostModel& model, ostream& solution)
+{
+  if (gens.length()==0) {
+    solution << 0;
+    return 0;
+  }
+  assert(depthBound > 0);
+
+  UpperMemoTable upperMemoTable;
+  LowerMemoTable lowerMemoTable;
+
+  // Compute a solution in { t.cost, t.solution }
+  UpperMemoEntry t = optimalUpperAux(gens, 0, depthBound, 1, upperMemoTable,
+                                     lowerMemoTable, model);
+  if (t.cost == NTL_MAX_LONG) {
+    solution << -1;
+    return NTL_MAX_LONG;
+  }
+
+  solution << length(t.solution);
+  for (GenNodePtr genPtr = t.solution; genPtr!=NULL; genPtr = genPtr->next)
+    writeSplitTree(solution, genPtr->solution);
+  return t.cost;
+}
+
 // Compute the trees corresponding to the "optimal" way of breaking
 // a permutation into dimensions, subject to some constraints
 long GeneratorTrees::buildOptimalTrees(const Vec<GenDescriptor>& gens, 
-				       long depthBound)
+				       long depthBound,
+				       const PermCostModel& model)
 {
   assert(gens.length() >= 0);
+
+  stringstream solution;
+  long cost = searchOptimalTrees(gens, depthBound, model, solution);
+  buildFromSolution(gens, solution);
+  return cost;
+}
+
+// Copy the solution written by searchOptimalTrees into the trees, returns
+// NTL_MAX_LONG if there is no solution (and 0 otherwise)
+long GeneratorTrees::buildFromSolution(const Vec<GenDescriptor>& gens,
+                                       istream& str)
+{
   trees.SetLength(gens.length());    // allocate space if needed
 
   if (gens.length()==0) {
@@ -883,7 +1038,6 @@ long GeneratorTrees::buildOptimalTrees(const Vec<GenDescriptor>& gens,
     map2array.SetLength(1,0);
     return 0;
   }
-  assert(depthBound > 0);
 
   // reset the trees, starting from only the roots
   for (long i=0; i<trees.length(); i++) {
@@ -891,18 +1045,35 @@ long GeneratorTrees::buildOptimalTrees(const Vec<GenDescriptor>& gens,
       trees[i].collapseToRoot();
   }
 
-  UpperMemoTable upperMemoTable;
-  LowerMemoTable lowerMemoTable;
+  long nTrees;
+  if (!(str >> nTrees) || nTrees != gens.length()) {
+    // no solution, undo initialization and return
+    // NTL_MAX_LONG
 
-  // Compute a solution in { t.cost, t.solution }
-  UpperMemoEntry t = 
-    optimalUpperAux(gens, 0, depthBound, 1, upperMemoTable, lowerMemoTable);
+    depth = 0;
+    trees.kill();
+    map2cube.kill();
+    map2array.kill();
+    return NTL_MAX_LONG;
+  }
+  GenNodePtr solution;
+  Vec<SplitNodePtr> roots(INIT_SIZE, nTrees);
+  long nMid = 0;
+  for (long i=0; i<nTrees; i++) {
+    roots[i] = readSplitTree(str);
+    checkSplitTree(roots[i], gens[i].order);
+    nMid += roots[i]->mid;
+  }
+  if (nMid != 1)
+    throw runtime_error("buildFromSolution: no single middle tree");
+  for (long i=nTrees-1; i>=0; i--)
+    solution = GenNodePtr(new GenNode(roots[i], solution));
 
   // Copy the solution into the trees
   GenNodePtr midPtr;
   long i=0, treeIdx=0, midIdx=0;
   depth = 0; // Also compute the depth of the permutation network
-  for (GenNodePtr genPtr = t.solution;
+  for (GenNodePtr genPtr = solution;
        genPtr!=NULL; genPtr = genPtr->next, i++) {
     if (genPtr->solution->mid) { // Keep the "middle tree" for last
       midPtr = genPtr;
@@ -913,16 +1084,7 @@ long GeneratorTrees::buildOptimalTrees(const Vec<GenDescriptor>& gens,
     trees[treeIdx].setAuxKey(gens[i].genIdx);
     treeIdx++;
   }
-  if (!midPtr) {
-    // no solution, undo initialization and return
-    // NTL_MAX_LONG
-
-    depth = 0;
-    trees.kill();
-    map2cube.kill();
-    map2array.kill();
-    return NTL_MAX_LONG;
-  }
+  assert(midPtr);
 
   depth += copyToGenTree(trees[treeIdx], midPtr->solution);
   trees[treeIdx].setAuxKey(gens[midIdx].genIdx);
@@ -942,5 +1104,138 @@ long GeneratorTrees::buildOptimalTrees(const Vec<GenDescriptor>& gens,
   std::cerr << endl;
 #endif
 
-  return t.cost;
+  return 0;
+}
+
+
+/********************************************************************/
+/***** GeneratorTreesMemo                                       *****/
+/********************************************************************/
+
+// The key of a search: the generators and the depth bound
+static string memoKey(const Vec<GenDescriptor>& gens, long depthBound)
+{
+  stringstream s;
+  s << depthBound;
+  for (long i=0; i<gens.length(); i++)
+    s << " " << gens[i].genIdx << ":" << gens[i].order << ":" << gens[i].good;
+  return s.str();
+}
+
+// The generators of a key written by memoKey, false if it is malformed
+static bool readMemoKey(const string& key, Vec<GenDescriptor>& gens)
+{
+  stringstream s(key);
+  long depthBound;
+  if (!(s >> depthBound) || depthBound <= 0) return false;
+  gens.SetLength(0);
+  GenDescriptor g;
+  char sep1, sep2;
+  while (s >> g.genIdx >> sep1 >> g.order >> sep2 >> g.good) {
+    if (sep1 != ':' || sep2 != ':' || g.order < 1) return false;
+    gens.append(g);
+  }
+  return s.eof();
+}
+
+long GeneratorTreesMemo::size() const
+{
+  std::lock_guard<std::mutex> guard(lock);
+  return entries.size();
+}
+
+long GeneratorTreesMemo::buildOptimalTrees(GeneratorTrees& trees,
+                                           const Vec<GenDescriptor>& vec,
+                                           long depthBound)
+{
+  string key = memoKey(vec, depthBound);
+  Entry e;
+  bool found = false;
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    std::map<string, Entry>::const_iterator it = entries.find(key);
+    if (it != entries.end()) {
+      e = it->second;
+      found = true;
+    }
+  }
+
+  if (!found) { // search outside the lock, concurrent searches are harmless
+    stringstream solution;
+    e.cost = searchOptimalTrees(vec, depthBound, model, solution);
+    e.solution = solution.str();
+
+    std::lock_guard<std::mutex> guard(lock);
+    entries[key] = e;
+  }
+
+  stringstream solution(e.solution);
+  trees.buildFromSolution(vec, solution);
+  return e.cost;
+}
+
+// The memo is written as text: "GeneratorTreesMemo", the fingerprint,
+// the model and the number of entries, then one line per entry
+void GeneratorTreesMemo::write(ostream& str) const
+{
+  std::lock_guard<std::mutex> guard(lock);
+  std::streamsize prec = str.precision(17);
+  str << "GeneratorTreesMemo " << fingerprint << "\n"
+      << model.shiftCost.length();
+  for (long i=0; i<model.shiftCost.length(); i++)
+    str << " " << model.shiftCost[i];
+  str << "\n" << entries.size() << "\n";
+  for (std::map<string, Entry>::const_iterator it = entries.begin();
+       it != entries.end(); ++it)
+    str << it->first << "\n" << it->second.cost << " "
+        << it->second.solution << "\n";
+  str.precision(prec);
+}
+
+bool GeneratorTreesMemo::read(istream& str)
+{
+  string tag;
+  unsigned long fp;
+  long nCosts, nEntries;
+  if (!(str >> tag >> fp) || tag != "GeneratorTreesMemo" || fp != fingerprint)
+    return false;
+
+  PermCostModel m;
+  if (!(str >> nCosts) || nCosts < 0) return false;
+  m.shiftCost.SetLength(nCosts);
+  for (long i=0; i<nCosts; i++)
+    if (!(str >> m.shiftCost[i])) return false;
+
+  std::map<string, Entry> e;
+  if (!(str >> nEntries) || nEntries < 0) return false;
+  str >> ws;
+  for (long i=0; i<nEntries; i++) {
+    string key, line;
+    Entry entry;
+    if (!getline(str, key) || !getline(str, line)) return false;
+    stringstream s(line);
+    if (!(s >> entry.cost)) return false;
+    getline(s >> ws, entry.solution);
+
+    // Build the solution once, so that a corrupted memo is rejected here
+    // instead of failing in the first permutation that uses it
+    Vec<GenDescriptor> gens;
+    if (!readMemoKey(key, gens)) return false;
+    GeneratorTrees scratch;
+    stringstream solution(entry.solution);
+    try {
+      long built = scratch.buildFromSolution(gens, solution);
+      if ((built == NTL_MAX_LONG) != (entry.cost == NTL_MAX_LONG))
+        return false;
+    }
+    catch (const runtime_error&) {
+      return false;
+    }
+    e[key] = entry;
+  }
+
+  std::lock_guard<std::mutex> guard(lock);
+  model = m;
+  entries.swap(e);
+  return true;
 }
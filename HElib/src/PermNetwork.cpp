@@ -14,6 +14,7 @@ NTL_CLIENT
 #include "Ctxt.h"
 #include "permutations.h"
 #include "EncryptedArray.h"
+#include "matmul.h" // concurrentSteps
 
 ostream& operator<< (ostream &s, const PermNetwork &net)
 {
@@ -246,3 +247,101 @@ void PermNetwork::applyToCtxt(Ctxt& c, const EncryptedArray& ea) const
     c = sum; // update the cipehrtext c before the next layer
   }
 }
+
+PermCostModel PermCostModel::calibrate(const EncryptedArray& ea,
+                                       const Ctxt& ctxt)
+{
+  const PAlgebra& al = ea.getContext().zMStar;
+  PermCostModel model;
+  model.shiftCost.SetLength(ea.dimension());
+
+  // A term of a layer multiplies by a mask, then applies the automorphism
+  ZZX maskPoly;
+  vector<long> mask(ea.size(), 1);
+  ea.encode(maskPoly, mask);
+  DoubleCRT dcrt(maskPoly, ea.getContext(), ctxt.getPrimeSet());
+
+  for (long i = 0; i < ea.dimension(); i++) {
+    // The layers shift by amounts of both signs, and smartAutomorph may
+    // compose several key-switchings for the larger ones
+    long ord = ea.sizeOfDimension(i);
+    long amts[] = { 1, -1, ord/2 };
+    long reps = (ord > 2)? 3 : 1;
+
+    double start = GetTime();
+    for (long k = 0; k < reps; k++) {
+      Ctxt tmp(ctxt);
+      tmp.multByConstant(dcrt);
+      tmp.smartAutomorph(PowerMod(al.ZmStarGen(i), amts[k], al.getM()));
+    }
+    model.shiftCost[i] = (GetTime() - start)/reps;
+  }
+  return model;
+}
+
+PermNetworkPlan::PermNetworkPlan(const Permut& _pi,
+                                 const GeneratorTrees& trees,
+                                 const EncryptedArray& ea): pi(_pi)
+{
+  const PAlgebra& al = ea.getContext().zMStar;
+  net.buildNetwork(pi, trees);
+
+  // The same terms as PermNetwork::applyToCtxt, with the masks encoded
+  for (long i=0; i<net.depth(); i++) {
+    const PermNetLayer& lyr = net.getLayer(i);
+    if (lyr.isIdentity()) continue;
+
+    long g2e = PowerMod(al.ZmStarGen(lyr.getGenIdx()), lyr.getE(), al.getM());
+    Vec<long> unused = lyr.getShifts();
+    vector<long> mask(unused.length());
+    terms.push_back(std::vector<Term>());
+
+    long shamt = 0;
+    while (true) {
+      pair<long,bool> ret=makeMask(mask, unused, shamt);
+      if (ret.second) { // non-empty mask
+        ZZX maskPoly;
+        ea.encode(maskPoly, mask);
+        Term t;
+        t.autVal = (shamt!=0)? PowerMod(g2e, shamt, al.getM()) : 1;
+        t.mask.reset(new DoubleCRT(maskPoly, ea.getContext()));
+        terms.back().push_back(t);
+      }
+      if (ret.first >= 0)
+        shamt = unused[ret.first];
+      else break;
+    }
+  }
+}
+
+long PermNetworkPlan::numTerms() const
+{
+  long n = 0;
+  for (long i=0; i<(long)terms.size(); i++) n += terms[i].size();
+  return n;
+}
+
+void PermNetworkPlan::applyToCtxt(Ctxt& c) const
+{
+  for (long i=0; i<(long)terms.size(); i++) {
+    const std::vector<Term>& lyr = terms[i];
+    long n = lyr.size();
+    if (n == 0) continue;
+    std::vector<Ctxt> parts(n, Ctxt(ZeroCtxtLike, c));
+
+    // The terms only read c, ranges of them run concurrently
+    PartitionInfo pinfo(n, concurrentSteps(c, n));
+    NTL_EXEC_INDEX(pinfo.NumIntervals(), index)
+      long first, last;
+      pinfo.interval(first, last, index);
+      for (long k = first; k < last; k++) {
+        parts[k] = c;
+        parts[k].multByConstant(*lyr[k].mask);
+        if (lyr[k].autVal != 1) parts[k].smartAutomorph(lyr[k].autVal);
+      }
+    NTL_EXEC_INDEX_END
+
+    for (long k=1; k<n; k++) parts[0] += parts[k];
+    c = parts[0]; // update the cipehrtext c before the next layer
+  }
+}
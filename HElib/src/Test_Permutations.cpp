@@ -12,6 +12,7 @@
 
 /* Test_Permutations.cpp - Applying plaintext permutation to encrypted vector
  */
+#include <sstream>
 #include <NTL/ZZ.h>
 NTL_CLIENT
 
@@ -51,6 +52,31 @@ void testCube(Vec<GenDescriptor>& vec, long widthBound)
     cout << "@TestCube: trees=" << trees << endl;
     cout << " cost =" << cost << endl;
   }
+
+  // The memo gives the same trees, also after a write/read round trip,
+  // and rejects the memo of another context or a corrupted memo
+  {
+    GeneratorTreesMemo memo(/*fingerprint=*/1), memo2(1), other(2),
+      corrupted(1);
+    GeneratorTrees trees1, trees2;
+    long cost1 = memo.buildOptimalTrees(trees1, vec, widthBound);
+    stringstream str;
+    memo.write(str);
+    stringstream str2(str.str());
+    string text = str.str(); // drop the last count of the solution
+    stringstream str3(text.substr(0, text.find_last_of(' ')) + "\n");
+    bool ok = memo2.read(str) && !other.read(str2) && memo2.size()==1
+      && !corrupted.read(str3) && corrupted.size()==0;
+    long cost2 = memo2.buildOptimalTrees(trees2, vec, widthBound);
+    stringstream s0, s1, s2;
+    s0 << trees; s1 << trees1; s2 << trees2;
+    if (ok && cost1==cost && cost2==cost && s1.str()==s0.str()
+        && s2.str()==s0.str())
+      cout << "GOOD\n";
+    else
+      cout << "BAD memo\n";
+  }
+
   Vec<long> dims;
   trees.getCubeDims(dims);
   CubeSignature sig(dims);
@@ -152,6 +178,22 @@ void testCtxt(long m, long p, long widthBound, long L, long r)
       cout << "done in " << t << " seconds" << endl;
     ea.decrypt(ctxt, secretKey, out2);
 
+    if (out1==out2) cout << "GOOD\n";
+    else {
+      cout << "************ BAD\n";
+    }
+
+    // Same permutation with the precomputed masks of PermNetworkPlan
+    PermNetworkPlan plan(pi, trees, ea);
+    ea.encrypt(ctxt, publicKey, in);
+    t = GetTime();
+    plan.applyToCtxt(ctxt);
+    t = GetTime() -t;
+    if (!noPrint)
+      cout << "  ** PermNetworkPlan ("<<plan.numTerms()<<" terms) applied in "
+           << t << " seconds" << endl;
+    ea.decrypt(ctxt, secretKey, out2);
+
     if (out1==out2) cout << "GOOD\n";
     else {
       cout << "************ BAD\n";
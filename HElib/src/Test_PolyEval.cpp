@@ -101,17 +101,30 @@ void testIt(long d, long k, long p, long r, long m, long L,
     SetCoeff(poly, i, RandomBnd(p2r)); // coefficients are random
   if (isMonic) SetCoeff(poly, d);    // set top coefficient to 1
 
-  // Evaluate poly on the ciphertext
-  polyEval(outCtxt, poly, inCtxt, k);
-
-  // Check the result
-  vector<long> y;
-  ea.decrypt(outCtxt, secretKey, y);
-  for (long i=0; i<ea.size(); i++) {
-    long ret = polyEvalMod(poly, x[i], p2r);
-    if (ret != y[i]) {
-      std::cout << "plaintext poly MISMATCH\n";
-      exit(0);
+  // Evaluate poly on the ciphertext, with the given k and with the
+  // parameters chosen by the cost model
+  PolyEvalPlan plan = optimizePolyEval(poly, p2r);
+  PolyEvalPlan defaultPlan; // k=0: sqrt(d/2) rounded to a power of two
+  polyEvalCost(defaultPlan, poly, p2r);
+  if (!noPrint) std::cout << "  plan "<<plan<<" vs "<<defaultPlan<<endl;
+  if (plan.depth > defaultPlan.depth) {
+    std::cout << "optimized plan is DEEPER\n";
+    exit(0);
+  }
+
+  for (long pass=0; pass<2; pass++) {
+    if (pass==0) polyEval(outCtxt, poly, inCtxt, k);
+    else         polyEval(outCtxt, poly, inCtxt, plan);
+
+    // Check the result
+    vector<long> y;
+    ea.decrypt(outCtxt, secretKey, y);
+    for (long i=0; i<ea.size(); i++) {
+      long ret = polyEvalMod(poly, x[i], p2r);
+      if (ret != y[i]) {
+        std::cout << "plaintext poly MISMATCH\n";
+        exit(0);
+      }
     }
   }
   std::cout << "plaintext poly match\n" << std::flush;
@@ -129,6 +142,7 @@ void usage(char *prog)
   std::cout << "    d=undefined means trying a few powers d=1,...,4,25,...,34"<<endl;
   std::cout << "  k is the baby-step parameter [default=undefined]" << endl;
   std::cout << "    if k is undefined it is computed from d" << endl;
+  std::cout << "  nthreads is the number of threads [default=1]" << endl;
   std::cout << "  noPrint suppresses printouts [default=0]" << endl;
   exit(0);
 }
@@ -142,6 +156,7 @@ int main(int argc, char *argv[])
   argmap["d"] = "-1";
   argmap["k"] = "0";
   argmap["dry"] = "0";
+  argmap["nthreads"] = "1";
   argmap["noPrint"] = "0";
 
   // get parameters from the command line
@@ -154,6 +169,7 @@ int main(int argc, char *argv[])
   long k = atoi(argmap["k"]);
   bool dry = atoi(argmap["dry"]);
   noPrint = atoi(argmap["noPrint"]);
+  SetNumThreads(atoi(argmap["nthreads"]));
 
   long max_d = (d<=0)? 35 : d;
   long L = 5+NextPowerOfTwo(max_d);
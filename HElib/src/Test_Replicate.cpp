@@ -16,7 +16,10 @@
  */
 
 #include <cassert>
+#include <algorithm>
+#include <mutex>
 #include <NTL/lzz_pXFactoring.h>
+#include <NTL/BasicThreadPool.h>
 NTL_CLIENT
 
 #include "FHE.h"
@@ -88,6 +91,40 @@ public:
 };
 
 
+// The same checks for replicateAllConcurrent, which calls the handler
+// from several threads: the results are checked concurrently, and the
+// handler records under a lock which slots it received
+class ConcurrentReplicateTester : public ConcurrentReplicateHandler {
+public:
+  const FHESecKey& sKey;
+  const EncryptedArray& ea;
+  const NewPlaintextArray& pa;
+
+  std::mutex lock;
+  vector<bool> seen;
+  bool error;
+
+  ConcurrentReplicateTester(const FHESecKey& _sKey, const EncryptedArray& _ea,
+                            const NewPlaintextArray& _pa)
+  : sKey(_sKey), ea(_ea), pa(_pa), seen(_ea.size(), false), error(false) {}
+
+  virtual void handle(const Ctxt& ctxt, long pos) {
+    NewPlaintextArray pa1 = pa;
+    replicate(ea, pa1, pos);
+    NewPlaintextArray pa2(ea);
+    ea.decrypt(ctxt, sKey, pa2);
+    bool ok = equals(ea, pa1, pa2);
+
+    std::lock_guard<std::mutex> guard(lock);
+    if (!ok || pos < 0 || pos >= ea.size() || seen[pos]) error = true;
+    else seen[pos] = true;
+  }
+
+  bool succeeded() const {
+    return !error && std::find(seen.begin(), seen.end(), false) == seen.end();
+  }
+};
+
 
 void  TestIt(long m, long p, long r, long d, long L, long bnd, long B)
 {
@@ -177,6 +214,16 @@ void  TestIt(long m, long p, long r, long d, long L, long bnd, long B)
 	    << ((B>0)? B : ea.size())
 	    << " vectors)\n";
   delete handler;
+
+  if (B > 0) return; // the concurrent replication has no early stop
+
+  ConcurrentReplicateTester concurrentHandler(secretKey, ea, xp0);
+  double t = GetTime();
+  replicateAllConcurrent(ea, xc0, &concurrentHandler, bnd);
+  t = GetTime() - t;
+  std::cout << "  replicateAllConcurrent() "
+	    << (concurrentHandler.succeeded()? "succeeded :)" : "failed :(\n")
+	    << ", total time=" << t << " (" << ea.size() << " vectors)\n";
 }
 
 int main(int argc, char *argv[]) 
@@ -208,10 +255,14 @@ int main(int argc, char *argv[])
   long B = 0;
   amap.arg("B", B, "bound for # of replications", "all");
 
+  long nthreads=1;
+  amap.arg("nthreads", nthreads, "number of threads");
+
   amap.arg("noPrint", noPrint, "suppress printouts");
 
   amap.parse(argc, argv);
   setDryRun(dry);
+  SetNumThreads(nthreads);
 
   TestIt(m, p, r, d, L, bnd, B);
   cout << endl;
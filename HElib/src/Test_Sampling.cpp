@@ -0,0 +1,148 @@
+/* Copyright (C) 2012-2017 IBM Corp.
+ * This program is Licensed under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. See accompanying LICENSE file.
+ */
+/**
+ * Test_Sampling.cpp - Sanity checks for the zzX noise samplers
+ */
+#include <NTL/ZZ.h>
+NTL_CLIENT
+#include "sampling.h"
+#include "FHE.h"
+#include "timing.h"
+
+static bool noPrint = false;
+
+static bool check(bool cond, const char *what)
+{
+  if (!noPrint || !cond)
+    std::cout << "  " << what << (cond? ": ok" : ": FAILED") << endl;
+  return cond;
+}
+
+// The same seed must give the same samples
+static bool testDeterminism(long n)
+{
+  zzX a, b;
+  setSamplerSeed(conv<ZZ>(17));
+  sampleGaussian(a, n, 3.2);
+  setSamplerSeed(conv<ZZ>(17));
+  sampleGaussian(b, n, 3.2);
+  bool same = (a == b);
+
+  setSamplerSeed(conv<ZZ>(18));
+  sampleGaussian(b, n, 3.2);
+  bool differ = (a != b);
+  resetSamplerSeed();
+
+  return check(same && differ, "seeded streams are reproducible");
+}
+
+static bool testSmall(long n)
+{
+  zzX a;
+  sampleSmall(a, n);
+  long zeros = 0;
+  bool inRange = (a.length() == n);
+  for (long i = 0; i < a.length(); i++) {
+    if (a[i] < -1 || a[i] > 1) inRange = false;
+    if (a[i] == 0) zeros++;
+  }
+  // Prob[0]=1/2, allow 5 standard deviations
+  bool balanced = fabs(zeros - n/2.0) < 5*sqrt(n/4.0);
+  return check(inRange && balanced, "sampleSmall");
+}
+
+static bool testHWt(long n, long hwt)
+{
+  zzX a;
+  sampleHWt(a, hwt, n);
+  long nonzero = 0;
+  bool inRange = (a.length() == n);
+  for (long i = 0; i < a.length(); i++) {
+    if (a[i] < -1 || a[i] > 1) inRange = false;
+    if (a[i] != 0) nonzero++;
+  }
+  return check(inRange && nonzero == min(hwt,n), "sampleHWt");
+}
+
+static bool testGaussian(long n, double stdev)
+{
+  zzX a;
+  sampleGaussian(a, n, stdev);
+  double sum = 0, sum2 = 0;
+  for (long i = 0; i < a.length(); i++) {
+    sum += a[i];
+    sum2 += double(a[i])*a[i];
+  }
+  double mean = sum/n;
+  double sd = sqrt(sum2/n - mean*mean);
+  if (!noPrint)
+    std::cout << "  Gaussian: mean=" << mean << ", stdev=" << sd
+              << " (expected " << stdev << ")\n";
+  return check(fabs(mean) < 0.1*stdev && fabs(sd-stdev) < 0.05*stdev,
+               "sampleGaussian");
+}
+
+// Sample through DoubleCRT and compare against the ZZX conversion
+static bool testDoubleCRT(long m, long p)
+{
+  FHEcontext context(m, p, 1);
+  buildModChain(context, 3);
+
+  setSamplerSeed(conv<ZZ>(5));
+  DoubleCRT d(context);
+  d.sampleGaussian();
+
+  setSamplerSeed(conv<ZZ>(5));
+  ZZX poly;
+  sampleGaussian(poly, context.zMStar.getPhiM(), to_double(context.stdev));
+  resetSamplerSeed();
+
+  DoubleCRT d2(poly, context);
+  return check(d == d2, "DoubleCRT::sampleGaussian");
+}
+
+void usage(char *prog)
+{
+  std::cout << "Usage: "<<prog<<" [ optional parameters ]...\n";
+  std::cout << "  optional parameters have the form 'attr1=val1 attr2=val2 ...'\n";
+  std::cout << "  n is the number of samples [default=100000]" << endl;
+  std::cout << "  m is the cyclotomic ring for the DoubleCRT test [default=91]\n";
+  std::cout << "  noPrint suppresses printouts [default=0]" << endl;
+  exit(0);
+}
+
+int main(int argc, char *argv[])
+{
+  argmap_t argmap;
+  argmap["n"] = "100000";
+  argmap["m"] = "91";
+  argmap["noPrint"] = "0";
+
+  if (!parseArgs(argc, argv, argmap)) usage(argv[0]);
+
+  long n = atoi(argmap["n"]);
+  long m = atoi(argmap["m"]);
+  noPrint = atoi(argmap["noPrint"]);
+
+  setTimersOn();
+  bool ok = testDeterminism(1024);
+  ok = testSmall(n) && ok;
+  ok = testHWt(n, 64) && ok;
+  ok = testHWt(50, 64) && ok;
+  ok = testGaussian(n, 3.2) && ok;
+  ok = testGaussian(n, 20.0) && ok;
+  ok = testDoubleCRT(m, 2) && ok;
+
+  if (!noPrint) printAllTimers();
+  std::cout << (ok? "sampling tests passed\n" : "sampling tests FAILED\n");
+  return ok? 0 : -1;
+}
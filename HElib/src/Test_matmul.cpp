@@ -23,6 +23,7 @@
 #include "matmul.h"
 
 static MatMulBase* buildRandomMatrix(EncryptedArray& ea);
+static MatMulBase* buildBandedMatrix(EncryptedArray& ea);
 static MatMulBase* buildRandomBlockMatrix(const EncryptedArray& ea);
 
 
@@ -182,6 +183,96 @@ void  TestIt(long m, long p, long r, long d, long L, bool verbose)
       cout << "Grrr@*\n";
   }
 
+  // Test a "dense" matrix in baby-step/giant-step order
+  {
+    // choose a random plaintext square matrix
+    unique_ptr<MatMulBase> ptr(buildRandomMatrix(ea));
+
+    // choose a random plaintext vector
+    NewPlaintextArray v(ea);
+    random(ea, v);
+
+    // encrypt the random vector
+    Ctxt ctxt(publicKey);
+    ea.encrypt(ctxt, publicKey, v);
+    Ctxt ctxt2 = ctxt;
+
+    cout << "\n Multiplying with BSGS MatMulBase... " << std::flush;
+    matMul_bsgs(ctxt2, *ptr, cachezzX); // multiply ciphertext and build cache
+    matMul(v, *ptr);     // multiply the plaintext vector
+
+    NewPlaintextArray v1(ea);
+    ea.decrypt(ctxt2, secretKey, v1); // decrypt the ciphertext vector
+
+    if (equals(ea, v, v1))        // check that we've got the right answer
+      cout << "Nice!!\n";
+    else
+      cout << "Grrr@*\n";
+
+    cout << " Multiplying with BSGS MatMulBase+dcrt cache... " << std::flush;
+    ctxt2 = ctxt;
+    matMul_bsgs(ctxt2, *ptr, cacheDCRT); // upgrade the cache
+
+    ea.decrypt(ctxt2, secretKey, v1); // decrypt the ciphertext vector
+
+    if (equals(ea, v, v1))        // check that we've got the right answer
+      cout << "Nice!!\n";
+    else
+      cout << "Grrr@*\n";
+  }
+
+  // Test the planner on a banded matrix: 3 non-zero diagonals
+  {
+    unique_ptr<MatMulBase> ptr(buildBandedMatrix(ea));
+
+    NewPlaintextArray v(ea);
+    random(ea, v);
+
+    Ctxt ctxt(publicKey);
+    ea.encrypt(ctxt, publicKey, v);
+
+    const MatMulPlan& plan = planMatMul(*ptr);
+    if (verbose) cout << "\n Plan of the banded matrix: " << plan << endl;
+    cout << "\n Multiplying with planned MatMulBase... " << std::flush;
+    matMul_auto(ctxt, *ptr, cacheDCRT); // multiply and build the cache
+    matMul(v, *ptr);
+
+    NewPlaintextArray v1(ea);
+    ea.decrypt(ctxt, secretKey, v1);
+
+    if (equals(ea, v, v1) && plan.nonZeroDiags == min(3L, ea.size()))
+      cout << "Nice!!\n";
+    else
+      cout << "Grrr@*\n";
+  }
+
+  // Plan the banded matrix again with the costs measured on this context:
+  // the scan is shared, the costs follow the model
+  {
+    unique_ptr<MatMulBase> ptr(buildBandedMatrix(ea));
+
+    Ctxt ctxt(publicKey);
+    NewPlaintextArray v(ea);
+    random(ea, v);
+    ea.encrypt(ctxt, publicKey, v);
+
+    MatMulCostModel model = MatMulCostModel::calibrate(ea, ctxt);
+    const MatMulPlan& byDefault = planMatMul(*ptr);
+    const MatMulPlan& measured = planMatMul(*ptr, model);
+    if (verbose) cout << "\n Calibrated plan of the banded matrix: "
+                      << measured << endl;
+    cout << "\n Planning with a calibrated cost model... " << std::flush;
+
+    if (model.rotateGood > 0 && model.rotateBad > 0 && model.multConst > 0
+        && measured.model == model && byDefault.model == MatMulCostModel()
+        && &planMatMul(*ptr, model) == &measured
+        && measured.nonZeroDiags == byDefault.nonZeroDiags
+        && measured.nonZeroGenDiags == byDefault.nonZeroGenDiags)
+      cout << "Nice!!\n";
+    else
+      cout << "Grrr@*\n";
+  }
+
   // Test a "block matrix" over the base field
   {
     // choose a random plaintext square matrix
@@ -338,6 +429,41 @@ static MatMulBase* buildRandomMatrix(EncryptedArray& ea)
 }
 
 
+template<class type> class BandedMatrix : public MatMul<type> {
+  PA_INJECT(type)
+  vector< vector< RX > > data; // data[k][j] = mat[j-k+1, j], k=0,1,2
+
+public:
+  BandedMatrix(const EncryptedArray& _ea): MatMul<type>(_ea) {
+    long n = _ea.size();
+    long d = _ea.getDegree();
+
+    RBak bak; bak.save(); _ea.getContext().alMod.restoreContext();
+    data.resize(3);
+    for (long k = 0; k < 3; k++) {
+      data[k].resize(n);
+      for (long j = 0; j < n; j++) random(data[k][j], d);
+    }
+  }
+
+  virtual bool get(RX& out, long i, long j) const {
+    long n = this->getEA().size();
+    long k = mcMod(j-i+1, n);
+    if (k > 2 || IsZero(data[k][j])) return true;
+    out = data[k][j];
+    return false;
+  }
+};
+static MatMulBase* buildBandedMatrix(EncryptedArray& ea)
+{
+  switch (ea.getTag()) {
+    case PA_GF2_tag: { return new BandedMatrix<PA_GF2>(ea); }
+    case PA_zz_p_tag:{ return new BandedMatrix<PA_zz_p>(ea); }
+    default: return nullptr;
+  }
+}
+
+
 template<class type> class RandomBlockMatrix : public BlockMatMul<type> {
   PA_INJECT(type)
 
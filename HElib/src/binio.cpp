@@ -0,0 +1,119 @@
+/* Copyright (C) 2012-2017 IBM Corp.
+ * This program is Licensed under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. See accompanying LICENSE file.
+ */
+/* binio.cpp - Raw binary I/O of integers, vectors and polynomials
+ */
+#include <stdexcept>
+#include "binio.h"
+
+NTL_CLIENT
+
+static void readBytes(istream& str, void* buf, long n)
+{
+  str.read(reinterpret_cast<char*>(buf), n);
+  if (!str) throw runtime_error("binio: unexpected end of stream");
+}
+
+void write_raw_long(ostream& str, long n)
+{
+  str.write(reinterpret_cast<const char*>(&n), sizeof(n));
+}
+
+long read_raw_long(istream& str)
+{
+  long n;
+  readBytes(str, &n, sizeof(n));
+  return n;
+}
+
+void write_raw_double(ostream& str, double d)
+{
+  str.write(reinterpret_cast<const char*>(&d), sizeof(d));
+}
+
+double read_raw_double(istream& str)
+{
+  double d;
+  readBytes(str, &d, sizeof(d));
+  return d;
+}
+
+void write_raw_vec_long(ostream& str, const Vec<long>& v)
+{
+  write_raw_long(str, v.length());
+  if (v.length() > 0)
+    str.write(reinterpret_cast<const char*>(v.elts()), v.length()*sizeof(long));
+}
+
+void read_raw_vec_long(istream& str, Vec<long>& v)
+{
+  long n = read_raw_long(str);
+  if (n < 0) throw runtime_error("binio: bad vector length");
+  v.SetLength(n);
+  if (n > 0) readBytes(str, v.elts(), n*sizeof(long));
+}
+
+void write_raw_ZZ(ostream& str, const ZZ& n)
+{
+  long nBytes = NumBytes(n);
+  write_raw_long(str, (sign(n) < 0)? -nBytes : nBytes);
+  if (nBytes > 0) {
+    Vec<unsigned char> bytes;
+    bytes.SetLength(nBytes);
+    BytesFromZZ(bytes.elts(), abs(n), nBytes);
+    str.write(reinterpret_cast<const char*>(bytes.elts()), nBytes);
+  }
+}
+
+void read_raw_ZZ(istream& str, ZZ& n)
+{
+  long signedBytes = read_raw_long(str);
+  long nBytes = (signedBytes < 0)? -signedBytes : signedBytes;
+  if (nBytes == 0) {
+    clear(n);
+    return;
+  }
+  Vec<unsigned char> bytes;
+  bytes.SetLength(nBytes);
+  readBytes(str, bytes.elts(), nBytes);
+  ZZFromBytes(n, bytes.elts(), nBytes);
+  if (signedBytes < 0) NTL::negate(n, n);
+}
+
+void write_raw_ZZX(ostream& str, const ZZX& poly)
+{
+  long n = deg(poly)+1;
+  write_raw_long(str, n);
+  for (long i=0; i<n; i++) write_raw_ZZ(str, poly.rep[i]);
+}
+
+void read_raw_ZZX(istream& str, ZZX& poly)
+{
+  long n = read_raw_long(str);
+  if (n < 0) throw runtime_error("binio: bad polynomial length");
+  poly.rep.SetLength(n);
+  for (long i=0; i<n; i++) read_raw_ZZ(str, poly.rep[i]);
+  poly.normalize();
+}
+
+void write_raw_vec_ZZX(ostream& str, const vector<ZZX>& v)
+{
+  write_raw_long(str, v.size());
+  for (long i=0; i<(long)v.size(); i++) write_raw_ZZX(str, v[i]);
+}
+
+void read_raw_vec_ZZX(istream& str, vector<ZZX>& v)
+{
+  long n = read_raw_long(str);
+  if (n < 0) throw runtime_error("binio: bad vector length");
+  v.resize(n);
+  for (long i=0; i<n; i++) read_raw_ZZX(str, v[i]);
+}
@@ -0,0 +1,46 @@
+/* Copyright (C) 2012-2017 IBM Corp.
+ * This program is Licensed under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. See accompanying LICENSE file.
+ */
+#ifndef _BINIO_H_
+#define _BINIO_H_
+/** @file binio.h
+ *  @brief Raw binary I/O of integers, vectors and polynomials
+ *
+ * The values are written in the native byte order, so the files are only
+ * meant to be read back on the same kind of machine (e.g. to cache
+ * precomputed tables). The read functions throw std::runtime_error on a
+ * truncated stream.
+ */
+#include <iostream>
+#include <vector>
+#include <NTL/ZZX.h>
+#include <NTL/vector.h>
+
+void write_raw_long(std::ostream& str, long n);
+long read_raw_long(std::istream& str);
+
+void write_raw_double(std::ostream& str, double d);
+double read_raw_double(std::istream& str);
+
+void write_raw_vec_long(std::ostream& str, const NTL::Vec<long>& v);
+void read_raw_vec_long(std::istream& str, NTL::Vec<long>& v);
+
+//! Sign, number of bytes and the bytes of |n|, lowest first
+void write_raw_ZZ(std::ostream& str, const NTL::ZZ& n);
+void read_raw_ZZ(std::istream& str, NTL::ZZ& n);
+
+void write_raw_ZZX(std::ostream& str, const NTL::ZZX& poly);
+void read_raw_ZZX(std::istream& str, NTL::ZZX& poly);
+
+void write_raw_vec_ZZX(std::ostream& str, const std::vector<NTL::ZZX>& v);
+void read_raw_vec_ZZX(std::istream& str, std::vector<NTL::ZZX>& v);
+
+#endif /* _BINIO_H_ */
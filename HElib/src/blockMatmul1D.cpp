@@ -176,6 +176,48 @@ public:
     return false; // a nonzero diagonal
   }
 
+  // The diagonals with the constants taken from the cache: they only read
+  // the cache and all rotate the same input, so each range of diagonals
+  // runs on its own thread with its own accumulators, summed at the end.
+  void accumulateConcurrent(std::vector<Ctxt>& acc, const Ctxt& ctxt,
+                            CachedzzxMatrix* zcp, CachedDCRTMatrix* dcp,
+                            long dim, long D, long d, long cnt)
+  {
+    PartitionInfo pinfo(D, cnt);
+    cnt = pinfo.NumIntervals();
+    std::vector< std::vector<Ctxt> > partial(cnt-1, acc);
+
+    NTL_EXEC_INDEX(cnt, index)
+      RBak bak; bak.save(); ea.getTab().restoreContext();
+      long first, last;
+      pinfo.interval(first, last, index);
+      std::vector<Ctxt>& myAcc = (index==0)? acc : partial[index-1];
+
+      Ctxt shCtxt(ZeroCtxtLike, ctxt);
+      for (long e = first; e < last; e++) {
+        bool rotated = false;
+        for (long f=0; f<d; f++) {
+          DoubleCRT* dp = (dcp!=nullptr)? (*dcp)[d*e +f].get() : nullptr;
+          zzX* zp = (dcp==nullptr)? (*zcp)[d*e +f].get() : nullptr;
+          if (dp==nullptr && zp==nullptr) continue;
+
+          if (!rotated) { // rotate only for a non-zero diagonal
+            shCtxt = ctxt;
+            if (e > 0) ea.rotate1D(shCtxt, dim, e);
+            rotated = true;
+          }
+          Ctxt tmp1(shCtxt);
+          if (dp != nullptr) tmp1.multByConstant(*dp);
+          else               tmp1.multByConstant(*zp);
+          myAcc[f] += tmp1;
+        }
+      }
+    NTL_EXEC_INDEX_END
+
+    for (long k = 0; k < cnt-1; k++)
+      for (long f = 0; f < d; f++) acc[f] += partial[k][f];
+  }
+
   void multiply(Ctxt* ctxt, long dim, bool oneTransform) 
   {
     assert(dim >= 0 && dim <= ea.dimension());
@@ -205,8 +247,15 @@ public:
     CachedDCRTMatrix* dcp;
     mat.getCache(&zcp, &dcp);
 
+    // With a cache (and none to build) the diagonals may run concurrently
+    long cnt = 1;
+    if (ctxt!=nullptr && buildCache==cacheEmpty && (zcp!=nullptr || dcp!=nullptr))
+      cnt = concurrentSteps(*ctxt, D);
+
     // Process the diagonals one at a time
-    for (long e = 0; e < D; e++) { // process diagonal e
+    if (cnt > 1)
+      accumulateConcurrent(acc, *ctxt, zcp, dcp, dim, D, d, cnt);
+    else for (long e = 0; e < D; e++) { // process diagonal e
       bool zeroDiag = true;
       // For each diagonal e, we update the d accumulators y_0,..,y_{d-1}
       // with y_f += \sigma^{-f}(\lambda_{e,f}) * \rho^e(x)
@@ -272,11 +321,18 @@ public:
 
     // Finally, compute the result as \sum_{f=0}^{d-1} \sigma_f(y_f)
     if (ctxt!=nullptr) {
-      *ctxt = acc[0];
-      for (long f = 1; f < d; f++) {
-	acc[f].frobeniusAutomorph(f);
-	*ctxt += acc[f];
+      // the Frobenius automorphisms are independent too
+      if (d > 1) {
+        PartitionInfo pinfo(d-1, concurrentSteps(*ctxt, d-1));
+        NTL_EXEC_INDEX(pinfo.NumIntervals(), index)
+          long first, last;
+          pinfo.interval(first, last, index);
+          for (long f = first+1; f < last+1; f++) acc[f].frobeniusAutomorph(f);
+        NTL_EXEC_INDEX_END
       }
+
+      *ctxt = acc[0];
+      for (long f = 1; f < d; f++) *ctxt += acc[f];
     }
     // "install" the cache (if needed)
     if (buildCache == cachezzX)
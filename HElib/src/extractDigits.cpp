@@ -15,9 +15,36 @@
 NTL_CLIENT
 #include "EncryptedArray.h"
 #include "polyEval.h"
+#include "multicore.h"
 
 static void buildDigitPolynomial(ZZX& result, long p, long e);
 
+// Replace digits[j] by digits[j]^p "in spirit", for j=0,...,n-1. The n
+// liftings are independent: they run concurrently when they keep more
+// threads of the pool busy than the DoubleCRT loops of a single lifting.
+// Inside the pool AvailableThreads()==1, so each lifting is then sequential.
+static void liftDigits(vector<Ctxt>& digits, long n, long p, const ZZX& x2p)
+{
+  long avail = AvailableThreads();
+  long inner = threadsForWork(digits[0].getPrimeSet().card(),
+                              digits[0].getContext().zMStar.getPhiM());
+  bool concurrent = (n > 1 && min(n, avail) > inner);
+
+  auto lift = [&](long j) {
+    if (p==2) digits[j].square();
+    else if (p==3) digits[j].cube();
+    else polyEval(digits[j], x2p, digits[j]); // digits[j] = digits[j]^p
+  };
+
+  if (!concurrent) {
+    for (long j=0; j<n; j++) lift(j);
+    return;
+  }
+  NTL_EXEC_RANGE(n, first, last)
+    for (long j=first; j<last; j++) lift(j);
+  NTL_EXEC_RANGE_END
+}
+
 // extractDigits assumes that the slots of *this contains integers mod p^r
 // i.e., that only the free terms are nonzero. (If that assumptions does
 // not hold then the result will not be a valid ciphertext anymore.)
@@ -27,8 +54,12 @@ static void buildDigitPolynomial(ZZX& result, long p, long e);
 // contains the j'th digit in the p-base expansion of the integer in the
 // i'th slot of the *this. The plaintext space of digits[j] is mod p^{r-j},
 // and all the digits are at the same level.
+//
+// At step i the digits 0,...,i-1 are all lifted once more, and these
+// liftings are independent of each other: they run on the NTL thread pool.
 void extractDigits(vector<Ctxt>& digits, const Ctxt& c, long r)
 {
+  FHE_TIMER_START;
   FHEcontext& context = (FHEcontext&) c.getContext();
   long rr = c.effectiveR();
   if (r<=0 || r>rr) r = rr; // how many digits to extract
@@ -43,15 +74,31 @@ void extractDigits(vector<Ctxt>& digits, const Ctxt& c, long r)
   digits.resize(r, tmp);      // allocate space
   for (long i=0; i<r; i++) {
     tmp = c;
+    if (i>0) liftDigits(digits, i, p, x2p);
     for (long j=0; j<i; j++) {
-      if (p==2) digits[j].square();
-      else if (p==3) digits[j].cube();
-      else polyEval(digits[j], x2p, digits[j]); // "in spirit" digits[j] = digits[j]^p
       tmp -= digits[j];
       tmp.divideByP();
     }
     digits[i] = tmp; // needed in the next round
   }
+  FHE_TIMER_STOP;
+}
+
+// Extract the digits of several ciphertexts: digits[k] gets the digits of
+// c[k]. The ciphertexts are processed concurrently on the NTL thread pool.
+void extractDigits(vector< vector<Ctxt> >& digits, const vector<Ctxt>& c,
+                   long r)
+{
+  long n = c.size();
+  digits.resize(n);
+  if (n == 0) return;
+  if (n == 1 || AvailableThreads() < 2) {
+    for (long k=0; k<n; k++) extractDigits(digits[k], c[k], r);
+    return;
+  }
+  NTL_EXEC_RANGE(n, first, last)
+    for (long k=first; k<last; k++) extractDigits(digits[k], c[k], r);
+  NTL_EXEC_RANGE_END
 }
 
 
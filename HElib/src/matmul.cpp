@@ -12,6 +12,7 @@
 /* matmul.cpp - Data-movement operations on arrays of slots
  */
 #include <algorithm>
+#include <cmath>
 #include <NTL/BasicThreadPool.h>
 #include "matmul.h"
 
@@ -442,6 +443,207 @@ void buildCache4MatMul_sparse(MatMulBase& mat, MatrixCacheType buildCache)
 { mat_mul_sparse(nullptr, mat, buildCache); }
 
 
+/********************************************************************
+ * An implementation class for dense matmul in baby-step/giant-step
+ * order. Writing the index of the diagonal as d = g*j + i, 0 <= i < g,
+ *
+ *   sum_d diag_d * rot^d(v)
+ *   = sum_j rot^{g*j}( sum_i rot^{-g*j}(diag_{g*j+i}) * rot^i(v) )
+ *
+ * so the only rotations are the g-1 baby steps rot^i(v), computed once,
+ * and one rotation per giant step j, i.e. about 2*sqrt(nslots) rather
+ * than one per diagonal. The cache holds the rotated constants
+ * rot^{-g*j}(diag_{g*j+i}) at index g*j+i.
+ *
+ * The giant steps are independent: ranges of them run on the NTL
+ * thread pool, each with its own partial sum. Hence mat.get() may be
+ * called from several threads.
+ ********************************************************************/
+template<class type> class matmul_bsgs_impl {
+  PA_INJECT(type)
+  const MatrixCacheType buildCache;
+  std::unique_ptr<CachedzzxMatrix> zCache;
+  std::unique_ptr<CachedDCRTMatrix> dCache;
+
+  MatMul<type>& mat;
+  const EncryptedArrayDerived<type>& ea;
+public:
+  matmul_bsgs_impl(MatMulBase& _mat, MatrixCacheType tag)
+    : buildCache(tag), mat(dynamic_cast< MatMul<type>& >(_mat)),
+      ea(_mat.getEA().getDerived(type()))
+  {
+    if (buildCache==cachezzX)
+      zCache.reset(new CachedzzxMatrix(NTL::INIT_SIZE,ea.size()));
+    else if (buildCache==cacheDCRT)
+      dCache.reset(new CachedDCRTMatrix(NTL::INIT_SIZE,ea.size()));
+  }
+
+  // Get the constant rot^{-jg}(diag_{jg+i}) encoded as a single
+  // polynomial, its k'th slot is mat[k-i, k+jg] (indexes mod nslots)
+  bool processDiagonal(zzX& cPoly, long i, long jg, long nslots)
+  {
+    bool zDiag = true; // is this a zero diagonal
+    vector<RX> diag(nslots);
+
+    for (long k = 0; k < nslots; k++) {
+      bool zEntry = mat.get(diag[k], mcMod(k-i, nslots), mcMod(k+jg, nslots));
+      assert(zEntry || deg(diag[k]) < ea.getDegree());
+
+      if (zEntry) clear(diag[k]);
+      else if (!IsZero(diag[k]))
+        zDiag = false; // diagonal is non-zero
+    }
+    if (!zDiag) {
+      ea.encode(cPoly, diag);
+    }
+    return zDiag;
+  }
+
+  // Process the giant steps first,...,last-1, adding their results to
+  // *acc (if acc!=nullptr) and/or storing their constants in the cache
+  void giantSteps(Ctxt* acc, const std::vector<Ctxt>& baby,
+                  long first, long last, long g,
+                  CachedzzxMatrix* zcp, CachedDCRTMatrix* dcp)
+  {
+    RBak bak; bak.save(); ea.getTab().restoreContext();
+    long nslots = ea.size();
+
+    for (long j = first; j < last; j++) {
+      long jg = j*g;
+      std::unique_ptr<Ctxt> inner; // sum_i const_{jg+i} * rot^i(v)
+
+      for (long i = 0; i < g && jg+i < nslots; i++) {
+        zzX cpoly;
+        zzX* zxPtr=nullptr;
+        DoubleCRT* dxPtr=nullptr;
+
+        if (dcp != nullptr)         // DoubleCRT cache exists
+          dxPtr = (*dcp)[jg+i].get();
+        else if (zcp != nullptr)    // zzx cache exists but no DoubleCRT
+          zxPtr = (*zcp)[jg+i].get();
+        else if (!processDiagonal(cpoly, i, jg, nslots)) // no cache
+          zxPtr = &cpoly; // if it is not a zero value, point to it
+
+        if (zxPtr==nullptr && dxPtr==nullptr)
+          continue;       // zero diagonal, nothing to do
+
+        if (acc!=nullptr) {
+          Ctxt tmp(baby[i]);
+          if (dxPtr!=nullptr) tmp.multByConstant(*dxPtr);
+          else                tmp.multByConstant(*zxPtr);
+          if (inner) *inner += tmp;
+          else       inner.reset(new Ctxt(tmp));
+        }
+        if (buildCache==cachezzX) {
+          (*zCache)[jg+i].reset(new zzX(*zxPtr));
+        }
+        else if (buildCache==cacheDCRT) {
+          (*dCache)[jg+i].reset(new DoubleCRT(*zxPtr, ea.getContext()));
+        }
+      }
+      if (inner) {      // a non-zero giant step
+        if (jg > 0) ea.rotate(*inner, jg);
+        *acc += *inner;
+      }
+    }
+  }
+
+  void multiply(Ctxt* ctxt)
+  {
+    RBak bak; bak.save(); ea.getTab().restoreContext();
+
+    long nslots = ea.size();
+    long g = mat.getGstep();
+    if (g<=1 || g>=nslots) g = max(1L, long(ceil(sqrt(double(nslots)))));
+    long nGiant = divc(nslots, g);
+
+    // Check if we have the relevant constant in cache
+    CachedzzxMatrix* zcp;
+    CachedDCRTMatrix* dcp;
+    mat.getCache(&zcp, &dcp);
+
+    std::vector<Ctxt> baby;   // the baby steps rot^i(v), 0 <= i < g
+    std::unique_ptr<Ctxt> res;
+    long cnt = min(nGiant, AvailableThreads()); // just building the cache
+    if (ctxt!=nullptr) { // we need to do an actual multiplication
+      ctxt->cleanUp(); // not sure, but this may be a good idea
+      res.reset(new Ctxt(ZeroCtxtLike, *ctxt));
+      baby.assign(g, *ctxt);
+      if (g > 1) {       // the baby steps all rotate the same input
+        PartitionInfo pinfo(g-1, concurrentSteps(*ctxt, g-1));
+        NTL_EXEC_INDEX(pinfo.NumIntervals(), index)
+          RBak bak1; bak1.save(); ea.getTab().restoreContext();
+          long first, last;
+          pinfo.interval(first, last, index);
+          for (long i = first+1; i < last+1; i++) ea.rotate(baby[i], i);
+        NTL_EXEC_INDEX_END
+      }
+      cnt = concurrentSteps(*ctxt, nGiant);
+    }
+
+    // Process the giant steps, each range into its own partial sum
+    PartitionInfo pinfo(nGiant, max(1L, cnt));
+    cnt = pinfo.NumIntervals();
+    std::vector<Ctxt> partial;
+    if (ctxt!=nullptr) partial.assign(cnt-1, *res);
+
+    NTL_EXEC_INDEX(cnt, index)
+      long first, last;
+      pinfo.interval(first, last, index);
+      Ctxt* acc = nullptr;
+      if (ctxt!=nullptr) acc = (index==0)? res.get() : &partial[index-1];
+      giantSteps(acc, baby, first, last, g, zcp, dcp);
+    NTL_EXEC_INDEX_END
+
+    if (ctxt!=nullptr) { // add the partial sums, copy the result to ctxt
+      for (long k = 0; k < cnt-1; k++) *res += partial[k];
+      *ctxt = *res;
+    }
+
+    // "install" the cache (if needed)
+    if (buildCache == cachezzX)
+      mat.installzzxcache(zCache);
+    else if (buildCache == cacheDCRT)
+      mat.installDCRTcache(dCache);
+  } // end of multiply(...)
+};
+
+// Wrapper functions around the implemenmtation class
+static void
+mat_mul_bsgs(Ctxt* ctxt, MatMulBase& mat, MatrixCacheType buildCache)
+{
+  MatMulLock locking(mat, buildCache);
+
+  // If locking.getType()!=cacheEmpty then we really do need to
+  // build the cache, and we also have the lock for it.
+
+  if (locking.getType() == cacheEmpty && ctxt==nullptr) //  nothing to do
+    return;
+
+  switch (mat.getEA().getTag()) {
+    case PA_GF2_tag: {
+      matmul_bsgs_impl<PA_GF2> M(mat, locking.getType());
+      M.multiply(ctxt);
+      break;
+    }
+    case PA_zz_p_tag: {
+      matmul_bsgs_impl<PA_zz_p> M(mat, locking.getType());
+      M.multiply(ctxt);
+      break;
+    }
+    default:
+      throw std::logic_error("mat_mul_bsgs: neither PA_GF2 nor PA_zz_p");
+  }
+}
+// Same as matMul, in baby-step/giant-step order
+void matMul_bsgs(Ctxt& ctxt, MatMulBase& mat, MatrixCacheType buildCache)
+{ mat_mul_bsgs(&ctxt, mat, buildCache); }
+
+// Build a cache without performing multiplication
+void buildCache4MatMul_bsgs(MatMulBase& mat, MatrixCacheType buildCache)
+{ mat_mul_bsgs(nullptr, mat, buildCache); }
+
+
 /********************************************************************
  ********************************************************************/
 // Applying matmul to plaintext, useful for debugging
@@ -19,6 +19,7 @@
 #include <mutex>
 #include <tuple>
 #include "EncryptedArray.h"
+#include "multicore.h"
 
 typedef std::shared_ptr< zzX > zzxptr; // zzX=Vec<long> defined in NumbTh.h
 typedef NTL::Vec<zzxptr> CachedzzxMatrix;
@@ -28,6 +29,46 @@ typedef NTL::Mat<DCRTptr> CachedDCRTBlockMatrix;
 
 enum MatrixCacheType : int { cacheEmpty=0, cachezzX=1, cacheDCRT=2 };
 
+//! The algorithms of matMul, matMul_sparse and matMul_bsgs (see planMatMul)
+enum MatMulAlgorithm : int { matMulDense=0, matMulSparse=1, matMulBSGS=2 };
+
+//! @brief Relative costs of the operations of the three algorithms. The
+//! defaults are typical ratios (a key-switch dominates everything else);
+//! calibrate() measures them on a given ciphertext instead.
+struct MatMulCostModel {
+  double rotateGood; // rotate1D along a native dimension
+  double rotateBad;  // rotate1D along a bad dimension (2 key-switches)
+  double multConst;  // multByConstant by a DoubleCRT, and the addition
+
+  MatMulCostModel(): rotateGood(1.0), rotateBad(2.5), multConst(0.1) {}
+
+  bool operator==(const MatMulCostModel& other) const
+  { return rotateGood == other.rotateGood && rotateBad == other.rotateBad
+           && multConst == other.multConst; }
+
+  //! Time the operations on copies of ctxt
+  static MatMulCostModel calibrate(const EncryptedArray& ea,const Ctxt& ctxt);
+
+  double rotate1D(const EncryptedArray& ea, long dim) const
+  { return ea.nativeDimension(dim)? rotateGood : rotateBad; }
+  double rotate(const EncryptedArray& ea) const; // ea.rotate, any amount
+};
+
+//! @brief The result of planMatMul: what the three algorithms would do
+//! with a given matrix, and their estimated cost for a cost model
+struct MatMulPlan {
+  MatMulAlgorithm algorithm; // the cheapest one
+  long nonZeroDiags;       // non-zero diagonals, as seen by matMul_sparse
+  bool hasDiag0;           // the diagonal 0 (no rotation) is non-zero
+  long gStep;              // giant-step size of matMul_bsgs
+  long nonZeroGiantSteps;  // giant steps with a non-zero diagonal
+  bool hasGiantStep0;      // the giant step 0 (no rotation) is non-zero
+  long nonZeroGenDiags;    // non-zero generalized diagonals (matMul)
+  MatMulCostModel model;   // the model of the costs below
+  double cost[3];          // estimated cost, indexed by MatMulAlgorithm
+};
+std::ostream& operator<<(std::ostream& s, const MatMulPlan& plan);
+
 /********************************************************************/
 /****************** Linear transformation classes *******************/
 
@@ -41,6 +82,8 @@ class MatMulBase {
   std::unique_ptr<CachedzzxMatrix> zzxCache;
   std::unique_ptr<CachedDCRTMatrix> dcrtCache;
   std::mutex cachelock;
+  std::vector< std::unique_ptr<MatMulPlan> > plans; // see planMatMul
+  std::mutex planlock;
 
   long gStep; // the giant-step parameter (if used)
 
@@ -64,12 +107,17 @@ public:
   void installDCRTcache(std::unique_ptr<CachedDCRTMatrix>& dc)
   { dcrtCache.swap(dc); }
 
+  // The plans are built and kept by planMatMul, one per cost model
+  friend const MatMulPlan& planMatMul(MatMulBase& mat,
+                                      const MatMulCostModel& model);
+
   // setGstep is *not* thread safe and should never be called if
   // there are threads using the current cache.
   void setGstep(long g) {
     if (g != gStep && g>0) {
       zzxCache.reset();
       dcrtCache.reset();
+      plans.clear();
       gStep = g;
     }
   }
@@ -122,9 +170,37 @@ void matMul_sparse(Ctxt& ctxt, MatMulBase& mat,
 //! Build a cache without performing multiplication
 void buildCache4MatMul_sparse(MatMulBase& mat, MatrixCacheType buildCache);
 
+//! @brief Same as matMul, in baby-step/giant-step order: about
+//! 2*sqrt(nslots) rotations of the whole slot vector instead of one
+//! rotate1D per diagonal. The giant-step size is mat.getGstep() if it is
+//! more than 1, and sqrt(nslots) otherwise. The giant steps run on the
+//! NTL thread pool, so mat.get() must be safe to call from several
+//! threads (it is for a matrix that only reads its entries).
+void matMul_bsgs(Ctxt& ctxt, MatMulBase& mat,
+                 MatrixCacheType buildCache=cacheEmpty);
+
+//! Build a cache without performing multiplication
+void buildCache4MatMul_bsgs(MatMulBase& mat, MatrixCacheType buildCache);
+
+//! @brief Scan mat once (nslots^2 calls to get) and estimate the cost of
+//! matMul, matMul_sparse and matMul_bsgs with model. The plans are kept
+//! with the caches of mat, one per model (until setGstep): the scan is
+//! done only once, a new model only recomputes the costs.
+const MatMulPlan& planMatMul(MatMulBase& mat,
+                             const MatMulCostModel& model=MatMulCostModel());
+
+//! Multiply with the algorithm chosen by planMatMul. The cache (if any)
+//! is built by that algorithm, so do not share it with the other ones.
+void matMul_auto(Ctxt& ctxt, MatMulBase& mat,
+                 MatrixCacheType buildCache=cacheEmpty);
+
+//! Build a cache without performing multiplication
+void buildCache4MatMul_auto(MatMulBase& mat, MatrixCacheType buildCache);
+
 //FIXME: With the interfaces above, an application can call buildCache4MatMul
-// and then use the cache with matMul_sparse (or vise versa), and currently
-// there is no run-time check to detect that we have the wrong cache.
+// and then use the cache with matMul_sparse or matMul_bsgs (or vise versa),
+// and currently there is no run-time check to detect that we have the wrong
+// cache.
 
 
 ///@{
@@ -237,6 +313,20 @@ void blockMatMulti1D(NewPlaintextArray& pa, MatMulBase& mat, long dim);
 ///@}
 
 
+//! @brief Into how many ranges n independent steps of a linear map (each
+//! a rotation of ctxt and some products by constants) are split to run
+//! on the NTL thread pool. Returns 1, i.e. run them one after the other,
+//! unless this keeps more threads busy than the DoubleCRT loops of a
+//! single step would.
+inline long concurrentSteps(const Ctxt& ctxt, long n)
+{
+  long avail = NTL::AvailableThreads();
+  long inner = threadsForWork(ctxt.getPrimeSet().card(),
+                              ctxt.getContext().zMStar.getPhiM());
+  long cnt = (n < avail)? n : avail;
+  return (n > 1 && cnt > inner)? cnt : 1;
+}
+
 /*********************************************************************
  * MatMulLock: A helper class that handles the lock in MatMulBase.
  * It is used in a function as follows:
@@ -173,6 +173,49 @@ public:
     return typ;
   }
 
+  // The giant steps with the constants taken from the cache: they only
+  // read the cache and all rotate the same input, so each range of steps
+  // runs on its own thread with its own accumulators, summed at the end.
+  void accumulateConcurrent(std::vector<Ctxt>& acc, const Ctxt& ctxt,
+                            CachedzzxMatrix* zcp, CachedDCRTMatrix* dcp,
+                            long dim, long D, long g, long dDivg, long cnt,
+                            bool oneTransform)
+  {
+    PartitionInfo pinfo(dDivg, cnt);
+    cnt = pinfo.NumIntervals();
+    std::vector< std::vector<Ctxt> > partial(cnt-1, acc);
+
+    NTL_EXEC_INDEX(cnt, index)
+      RBak bak; bak.save(); ea.getTab().restoreContext();
+      long first, last;
+      pinfo.interval(first, last, index);
+      std::vector<Ctxt>& myAcc = (index==0)? acc : partial[index-1];
+
+      std::vector<zzX> cpolys(g); // unused with a cache
+      std::vector<PtxtPtr> ptrs;
+      Ctxt shCtxt(ZeroCtxtLike, ctxt);
+      for (long j = first; j < last; j++) {
+        long jg = j*g;
+        PtxtPtr::Type ty = getConsts(ptrs, cpolys, zcp, dcp,
+                                     dim, jg, D, oneTransform);
+        if (ty==PtxtPtr::ZERO) continue;
+
+        shCtxt = ctxt;
+        if (j>0) ea.rotate1D(shCtxt, dim, jg);
+        for (long i=0; i<min(g,D-jg); i++) {
+          if (ptrs[i].dp==nullptr && ptrs[i].zp==nullptr) continue;
+          Ctxt tmp(shCtxt);
+          if (ty==PtxtPtr::DCRT) tmp.multByConstant(*(ptrs[i].dp));
+          else                   tmp.multByConstant(*(ptrs[i].zp));
+          myAcc[i] += tmp;
+        }
+      }
+    NTL_EXEC_INDEX_END
+
+    for (long k = 0; k < cnt-1; k++)
+      for (long i = 0; i < g; i++) acc[i] += partial[k][i];
+  }
+
   void multiply(Ctxt* ctxt, long dim, bool oneTransform) 
   {
     assert(dim >= 0 && dim <= ea.dimension());
@@ -211,10 +254,18 @@ public:
     CachedDCRTMatrix* dcp;
     mat.getCache(&zcp, &dcp);
 
+    // With a cache (and none to build) the giant steps may run concurrently
+    long cnt = 1;
+    if (ctxt!=nullptr && buildCache==cacheEmpty && (zcp!=nullptr || dcp!=nullptr))
+      cnt = concurrentSteps(*ctxt, dDivg);
+
     // Process the diagonals in giant-step/baby-step order
     std::vector<zzX> cpolys(g); // scratch space for encoding consts
     std::vector<PtxtPtr> ptrs;  // pointers to these constants
-    for (long j = 0; j < dDivg; j++) { // giant steps
+    if (cnt > 1)
+      accumulateConcurrent(acc, *ctxt, zcp, dcp, dim, D, g, dDivg, cnt,
+                           oneTransform);
+    else for (long j = 0; j < dDivg; j++) { // giant steps
       long jg = j*g;            // beginning index of this giant step
 
       // get all the constants rot^{-i}(const_{i+g*j}) for this step
@@ -261,11 +312,19 @@ public:
     }
     // Compute the result as \sum_{i=0}^{g-1} rho^i(Y_i)
     if (ctxt!=nullptr) {
-      *ctxt = acc[0];
-      for (long i = 1; i < g; i++) {
-        ea.rotate1D(acc[i], dim, i);
-        *ctxt += acc[i];
+      // the baby-step rotations are independent too
+      if (g > 1) {
+        PartitionInfo pinfo(g-1, concurrentSteps(*ctxt, g-1));
+        NTL_EXEC_INDEX(pinfo.NumIntervals(), index)
+          RBak bak1; bak1.save(); ea.getTab().restoreContext();
+          long first, last;
+          pinfo.interval(first, last, index);
+          for (long i = first+1; i < last+1; i++) ea.rotate1D(acc[i], dim, i);
+        NTL_EXEC_INDEX_END
       }
+
+      *ctxt = acc[0];
+      for (long i = 1; i < g; i++) *ctxt += acc[i];
     }
     // "install" the cache if needed
     if (buildCache == cachezzX)
@@ -0,0 +1,243 @@
+/* Copyright (C) 2012-2017 IBM Corp.
+ * This program is Licensed under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. See accompanying LICENSE file.
+ */
+/* matmulPlan.cpp - Choosing between matMul, matMul_sparse, matMul_bsgs
+ */
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+#include <NTL/BasicThreadPool.h>
+#include "matmul.h"
+
+
+// The cost of ea.rotate by a generic amount: the last dimension is
+// rotated once, each of the others twice with two masks (see
+// EncryptedArrayDerived::rotate)
+double MatMulCostModel::rotate(const EncryptedArray& ea) const
+{
+  long nd = ea.dimension();
+  if (nd == 0) return 0.0;
+  double cost = rotate1D(ea, nd-1);
+  for (long i = 0; i < nd-1; i++)
+    cost += 2*rotate1D(ea, i) + 2*multConst;
+  return cost;
+}
+
+MatMulCostModel
+MatMulCostModel::calibrate(const EncryptedArray& ea, const Ctxt& ctxt)
+{
+  MatMulCostModel model;
+  const long reps = 3;
+  double good = -1.0, bad = -1.0;
+
+  for (long i = 0; i < ea.dimension(); i++) {
+    double& t = ea.nativeDimension(i)? good : bad;
+    if (t >= 0 || ea.sizeOfDimension(i) < 2) continue; // measured already
+    Ctxt tmp(ctxt);
+    double start = NTL::GetTime();
+    for (long k = 0; k < reps; k++) ea.rotate1D(tmp, i, 1);
+    t = (NTL::GetTime() - start)/reps;
+  }
+
+  ZZX poly;
+  std::vector<long> ones(ea.size(), 1);
+  ea.encode(poly, ones);
+  DoubleCRT dcrt(poly, ctxt.getContext(), ctxt.getPrimeSet());
+  Ctxt acc(ctxt);
+  double start = NTL::GetTime();
+  for (long k = 0; k < reps; k++) {
+    Ctxt tmp(ctxt);
+    tmp.multByConstant(dcrt);
+    acc += tmp;
+  }
+  double mult = (NTL::GetTime() - start)/reps;
+
+  // Keep the default ratios for the kind of dimension we do not have
+  if (good <= 0 && bad <= 0) return model;
+  if (good <= 0) good = bad*model.rotateGood/model.rotateBad;
+  if (bad <= 0)  bad = good*model.rotateBad/model.rotateGood;
+  model.rotateGood = good;
+  model.rotateBad = bad;
+  model.multConst = mult;
+  return model;
+}
+
+
+/********************************************************************
+ * An implementation class for the planner: a single scan of the
+ * matrix, recording the non-zero diagonals as seen by each algorithm.
+ *
+ * The entry mat[i,j] is on the diagonal d = j-i (mod nslots) of the
+ * sparse and BSGS algorithms, and on the generalized diagonal of the
+ * dense algorithm given by the offsets coord_k(j)-coord_k(i) (mod the
+ * size of dimension k) along each dimension k.
+ ********************************************************************/
+template<class type> class matmul_plan_impl {
+  PA_INJECT(type)
+  MatMul<type>& mat;
+  const EncryptedArrayDerived<type>& ea;
+public:
+  matmul_plan_impl(MatMulBase& _mat)
+    : mat(dynamic_cast< MatMul<type>& >(_mat)),
+      ea(_mat.getEA().getDerived(type())) {}
+
+  void scan(MatMulPlan& res)
+  {
+    RBak bak; bak.save(); ea.getTab().restoreContext();
+
+    long nslots = ea.size();
+    long nd = ea.dimension();
+    long g = mat.getGstep();
+    if (g<=1 || g>=nslots) g = std::max(1L, long(ceil(sqrt(double(nslots)))));
+    long nGiant = divc(nslots, g);
+
+    // The coordinates of all the slots, computed once
+    std::vector< std::vector<long> > coord(nd, std::vector<long>(nslots));
+    for (long k = 0; k < nd; k++)
+      for (long j = 0; j < nslots; j++)
+        coord[k][j] = ea.coordinate(k, j);
+
+    std::vector<bool> diags(nslots, false), giants(nGiant, false);
+    std::unordered_set<long> genDiags;
+
+    for (long i = 0; i < nslots; i++) {
+      for (long j = 0; j < nslots; j++) {
+        RX val;
+        if (mat.get(val, i, j) || IsZero(val)) continue; // a zero entry
+
+        long d = mcMod(j-i, nslots);
+        diags[d] = true;
+        giants[d/g] = true;
+
+        long gd = 0; // the generalized diagonal, in mixed radix
+        for (long k = 0; k < nd; k++) {
+          long sz = ea.sizeOfDimension(k);
+          gd = gd*sz + mcMod(coord[k][j]-coord[k][i], sz);
+        }
+        genDiags.insert(gd);
+      }
+    }
+
+    res.gStep = g;
+    res.nonZeroDiags = std::count(diags.begin(), diags.end(), true);
+    res.hasDiag0 = diags[0];
+    res.nonZeroGiantSteps = std::count(giants.begin(), giants.end(), true);
+    res.hasGiantStep0 = giants[0];
+    res.nonZeroGenDiags = genDiags.size();
+  }
+};
+
+// The costs of the three algorithms for the diagonals found by the scan
+static void estimateCosts(MatMulPlan& res, const EncryptedArray& ea,
+                          const MatMulCostModel& model)
+{
+  long nd = ea.dimension();
+
+  // matMul: the recursion rotates along every dimension, in the order
+  // bad-before-good then small-before-large (see matmul_impl), whatever
+  // the entries; only the constants at the leaves are skipped when zero
+  std::vector<long> dims(nd);
+  for (long k = 0; k < nd; k++) dims[k] = k;
+  sort(dims.begin(), dims.end(), [&ea](long a, long b) {
+    return (!ea.nativeDimension(a) && ea.nativeDimension(b)) ||
+           (  (ea.nativeDimension(a) == ea.nativeDimension(b)) &&
+              (ea.sizeOfDimension(a) < ea.sizeOfDimension(b))  );
+  });
+  double dense = res.nonZeroGenDiags*model.multConst;
+  double branches = 1.0;
+  for (long k = 0; k < nd; k++) {
+    long sz = ea.sizeOfDimension(dims[k]);
+    dense += branches*(sz-1)*model.rotate1D(ea, dims[k]);
+    branches *= sz;
+  }
+
+  // matMul_sparse: one rotation per non-zero diagonal but the 0'th
+  double rot = model.rotate(ea);
+  double sparse = (res.nonZeroDiags - (res.hasDiag0? 1 : 0))*rot
+                + res.nonZeroDiags*model.multConst;
+
+  // matMul_bsgs: g-1 baby steps, one rotation per non-zero giant step
+  double bsgs = (res.gStep-1 + res.nonZeroGiantSteps
+                 - (res.hasGiantStep0? 1 : 0))*rot
+              + res.nonZeroDiags*model.multConst;
+
+  res.model = model;
+  res.cost[matMulDense] = dense;
+  res.cost[matMulSparse] = sparse;
+  res.cost[matMulBSGS] = bsgs;
+  res.algorithm = matMulDense;
+  if (res.cost[matMulBSGS] < res.cost[res.algorithm])
+    res.algorithm = matMulBSGS;
+  if (res.cost[matMulSparse] <= res.cost[res.algorithm])
+    res.algorithm = matMulSparse;
+}
+
+// The plans are never removed before setGstep, so the references
+// returned to the callers stay valid
+const MatMulPlan& planMatMul(MatMulBase& mat, const MatMulCostModel& model)
+{
+  std::lock_guard<std::mutex> lock(mat.planlock);
+  for (long i = 0; i < long(mat.plans.size()); i++)
+    if (mat.plans[i]->model == model) return *mat.plans[i];
+
+  std::unique_ptr<MatMulPlan> plan(new MatMulPlan());
+  if (!mat.plans.empty())
+    *plan = *mat.plans[0]; // the scan does not depend on the model
+  else {
+    switch (mat.getEA().getTag()) {
+      case PA_GF2_tag: {
+        matmul_plan_impl<PA_GF2> P(mat);
+        P.scan(*plan);
+        break;
+      }
+      case PA_zz_p_tag: {
+        matmul_plan_impl<PA_zz_p> P(mat);
+        P.scan(*plan);
+        break;
+      }
+      default:
+        throw std::logic_error("planMatMul: neither PA_GF2 nor PA_zz_p");
+    }
+  }
+  estimateCosts(*plan, mat.getEA(), model);
+  mat.plans.push_back(std::move(plan));
+  return *mat.plans.back();
+}
+
+void matMul_auto(Ctxt& ctxt, MatMulBase& mat, MatrixCacheType buildCache)
+{
+  switch (planMatMul(mat).algorithm) {
+    case matMulSparse: matMul_sparse(ctxt, mat, buildCache); break;
+    case matMulBSGS:   matMul_bsgs(ctxt, mat, buildCache);   break;
+    default:           matMul(ctxt, mat, buildCache);
+  }
+}
+
+void buildCache4MatMul_auto(MatMulBase& mat, MatrixCacheType buildCache)
+{
+  switch (planMatMul(mat).algorithm) {
+    case matMulSparse: buildCache4MatMul_sparse(mat, buildCache); break;
+    case matMulBSGS:   buildCache4MatMul_bsgs(mat, buildCache);   break;
+    default:           buildCache4MatMul(mat, buildCache);
+  }
+}
+
+std::ostream& operator<<(std::ostream& s, const MatMulPlan& plan)
+{
+  static const char* names[] = { "dense", "sparse", "bsgs" };
+  s << "[" << names[plan.algorithm]
+    << " diags=" << plan.nonZeroDiags
+    << " g=" << plan.gStep << " giantSteps=" << plan.nonZeroGiantSteps
+    << " genDiags=" << plan.nonZeroGenDiags
+    << " cost=(" << plan.cost[0] << "," << plan.cost[1] << ","
+    << plan.cost[2] << ")]";
+  return s;
+}
@@ -43,5 +43,38 @@
 #endif
 
 
+#include <NTL/BasicThreadPool.h>
+
+//! Default minimal amount of work, in coefficients mod a small prime, for
+//! which one more thread of the NTL pool is used by the DoubleCRT loops
+#ifndef FHE_MIN_PARALLEL_WORK
+#define FHE_MIN_PARALLEL_WORK 16384
+#endif
+
+//! @brief The minimal amount of work per thread for the DoubleCRT loops.
+//! The value is per thread, so that each thread running ciphertext
+//! operations can use its own setting.
+inline long& minParallelWorkRef()
+{
+  static thread_local long tls_minWork = FHE_MIN_PARALLEL_WORK;
+  return tls_minWork;
+}
+
+inline long getMinParallelWork() { return minParallelWorkRef(); }
+inline void setMinParallelWork(long work)
+{ minParallelWorkRef() = (work > 0)? work : 1; }
+
+//! @brief How many threads of the current NTL pool are worth using for a
+//! loop over n items of itemSize coefficients each. Returns 1 when the loop
+//! is too small to amortize dispatching it to the pool.
+inline long threadsForWork(long n, long itemSize)
+{
+  long avail = NTL::AvailableThreads();
+  if (avail <= 1 || n <= 1) return 1;
+  double t = double(n)*double(itemSize)/double(getMinParallelWork());
+  if (t < 2.0) return 1;
+  long nt = (t < avail)? long(t) : avail;
+  return (nt < n)? nt : n;
+}
 
 #endif
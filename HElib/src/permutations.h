@@ -16,6 +16,10 @@
 #ifndef _PERMUTATIONS_H_
 #define _PERMUTATIONS_H_
 
+#include <memory>
+#include <map>
+#include <mutex>
+#include <string>
 #include "PAlgebra.h"
 #include "matching.h"
 #include "hypercube.h"
@@ -408,6 +412,29 @@ class SubDimension {
 typedef FullBinaryTree<SubDimension> OneGeneratorTree;// tree for one generator
 
 
+class Ctxt;
+class EncryptedArray;
+
+//! @class PermCostModel
+//! @brief The cost of one shift along each generator, for buildOptimalTrees
+//!
+//! A shift in a layer of a permutation network is one mask multiplication
+//! and one automorphism. The default model counts every shift as 1, so the
+//! cost of a solution is its number of 1D shifts. The automorphisms of the
+//! generators are not equally expensive (bad dimensions, key-switching
+//! matrices that are missing and composed), calibrate() times them on a
+//! ciphertext instead. Only the ratios between generators matter.
+class PermCostModel {
+public:
+  Vec<double> shiftCost; // indexed by genIdx, 1.0 for the missing ones
+
+  double cost(long genIdx) const
+  { return (genIdx>=0 && genIdx<shiftCost.length())? shiftCost[genIdx] : 1.0; }
+
+  //! Time the shifts of the generators of ea on (copies of) ctxt
+  static PermCostModel calibrate(const EncryptedArray& ea, const Ctxt& ctxt);
+};
+
 //! A vector of generator trees, one per generator in Zm*/(p)
 class GeneratorTrees  {
   long depth; // How many layers in this permutation network
@@ -458,7 +485,11 @@ class GeneratorTrees  {
   //! a permutation into dimensions, subject to some constraints. Returns
   //! the cost (# of 1D shifts) of this colution.
   //! Returns NTL_MAX_LONG if no solution
-  long buildOptimalTrees(const Vec<GenDescriptor>& vec, long depthBound);
+  //! The budget is split between the generators so as to minimize the
+  //! cost of their shifts according to model (the # of 1D shifts with
+  //! the default model).
+  long buildOptimalTrees(const Vec<GenDescriptor>& vec, long depthBound,
+                         const PermCostModel& model = PermCostModel());
 
   /**
    * @brief Computes permutations mapping between linear array and the cube.
@@ -479,13 +510,57 @@ class GeneratorTrees  {
   void ComputeCubeMapping();
 
   friend ostream& operator<< (ostream &s, const GeneratorTrees &t);
+
+private:
+  // Copy a solution of the search, as written by OptimizePermutations.cpp
+  long buildFromSolution(const Vec<GenDescriptor>& vec, istream& solution);
+  friend class GeneratorTreesMemo;
+};
+
+//! @class GeneratorTreesMemo
+//! @brief The optimized trees of a context, kept across plans and runs
+//!
+//! buildOptimalTrees searches all the tree shapes and level collapsings
+//! each time it is called, which dominates one-off permutations. The memo
+//! keeps the solution of every (generators, depth bound) it has seen, for
+//! the cost model of the memo, under the fingerprint of the context (see
+//! contextFingerprint). write() and read() save it to a file, with its
+//! model: the calibration and the searches are then done once per context
+//! and machine.
+class GeneratorTreesMemo {
+  struct Entry {
+    long cost;            // as returned by buildOptimalTrees
+    std::string solution; // the serialized search result
+  };
+  unsigned long fingerprint;
+  PermCostModel model;
+  std::map<std::string, Entry> entries; // keyed by generators and bound
+  mutable std::mutex lock;
+
+public:
+  explicit GeneratorTreesMemo(unsigned long _fingerprint,
+                              const PermCostModel& _model = PermCostModel())
+    : fingerprint(_fingerprint), model(_model) {}
+
+  unsigned long getFingerprint() const { return fingerprint; }
+  const PermCostModel& getModel() const { return model; }
+  long size() const;
+
+  //! Same as trees.buildOptimalTrees(vec, depthBound, getModel()), the
+  //! search only runs the first time for this (vec, depthBound)
+  long buildOptimalTrees(GeneratorTrees& trees,
+                         const Vec<GenDescriptor>& vec, long depthBound);
+
+  void write(ostream& str) const;
+
+  //! Read a memo written by write(). Returns false and leaves this memo
+  //! unchanged if it was written for another fingerprint or is malformed.
+  bool read(istream& str);
 };
 
 
 // Permutation networks
 
-class Ctxt;
-class EncryptedArray;
 class PermNetwork;
 
 //! @class PermNetLayer
@@ -539,4 +614,35 @@ public:
   friend ostream& operator<< (ostream &s, const PermNetwork &net);
 };
 
+class DoubleCRT;
+
+//! @class PermNetworkPlan
+//! @brief A permutation network prepared to be applied many times.
+//!
+//! PermNetwork::applyToCtxt encodes the masks of every layer each time it
+//! is called, and computes the terms of a layer one after the other. Here
+//! the masks are encoded once as DoubleCRT, and the terms of a layer (one
+//! mask and one automorphism each, all on the same input) run concurrently
+//! on the NTL thread pool. The result is the same.
+class PermNetworkPlan {
+  struct Term {
+    long autVal;                     // the automorphism X -> X^autVal
+    std::shared_ptr<DoubleCRT> mask; // the slots shifted by autVal
+  };
+  Permut pi;
+  PermNetwork net;
+  std::vector< std::vector<Term> > terms; // one vector per non-ID layer
+
+public:
+  PermNetworkPlan(const Permut& _pi, const GeneratorTrees& trees,
+                  const EncryptedArray& ea);
+
+  const Permut& getPerm() const { return pi; }
+  const PermNetwork& getNetwork() const { return net; }
+  long numTerms() const; // number of mask/automorphism pairs
+
+  //! Permute c, out[i]=in[pi[i]] as in applyPermToVec
+  void applyToCtxt(Ctxt& c) const;
+};
+
 #endif /* ifndef _PERMUTATIONS_H_ */
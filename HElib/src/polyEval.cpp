@@ -9,28 +9,86 @@
  * See the License for the specific language governing permissions and
  * limitations under the License. See accompanying LICENSE file.
  */
+#include <functional>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <NTL/BasicThreadPool.h>
 #include "polyEval.h"
+#include "timing.h"
+
+// How many threads the DoubleCRT loops of one operation on c can use
+static long innerThreads(const Ctxt& c)
+{
+  return threadsForWork(c.getPrimeSet().card(),
+                        c.getContext().zMStar.getPhiM());
+}
+
+// Run two independent computations concurrently when the DoubleCRT loops
+// would not use the threads of the pool anyway, else one after the other.
+// Inside the pool AvailableThreads()==1, so only the top split is forked.
+static void parallelInvoke(const Ctxt& c, const std::function<void()>& f0,
+                           const std::function<void()>& f1)
+{
+  if (AvailableThreads() < 2 || innerThreads(c) >= 2) {
+    f0(); f1();
+    return;
+  }
+  NTL_EXEC_INDEX(2, index)
+    if (index == 0) f0(); else f1();
+  NTL_EXEC_INDEX_END
+}
 
 // Returns the e'th power of X, computing it as needed
 Ctxt& DynamicCtxtPowers::getPower(long e)
+{
+  FHE_MUTEX_GUARD(mtx);
+  return computePower(e);
+}
+
+Ctxt& DynamicCtxtPowers::computePower(long e)
 {
   if (v.at(e-1).isEmpty()) { // Not computed yet, compute it now
     
     long k = 1L<<(NextPowerOfTwo(e)-1); // largest power of two smaller than e
-    v[e-1] = getPower(e-k);             // compute X^e = X^{e-k} * X^k
-    v[e-1].multiplyBy(getPower(k));
+    v[e-1] = computePower(e-k);         // compute X^e = X^{e-k} * X^k
+    v[e-1].multiplyBy(computePower(k));
 
     v[e-1].modDownToLevel(v[e-1].findBaseLevel()); // mod-switch down to base level
   }
   return v[e-1];
 }
 
-// Local functions for polynomial evaluation in some special cases
-static void simplePolyEval(Ctxt& ret, const ZZX& poly, DynamicCtxtPowers& babyStep);
-static void PatersonStockmeyer(Ctxt& ret, const ZZX& poly, long k, long t, long delta, DynamicCtxtPowers& babyStep, DynamicCtxtPowers& giantStep);
-static void degPowerOfTwo(Ctxt& ret, const ZZX& poly, long k, DynamicCtxtPowers& babyStep, DynamicCtxtPowers& giantStep);
-static void recursivePolyEval(Ctxt& ret, const ZZX& poly, long k, DynamicCtxtPowers& babyStep, DynamicCtxtPowers& giantStep);
+// X^e for 2^{l-1} < e <= 2^l only depends on powers up to 2^{l-1}, so all
+// the powers of the same level l can be computed at the same time
+void DynamicCtxtPowers::computeAll(long e)
+{
+  FHE_TIMER_START;
+  FHE_MUTEX_GUARD(mtx);
+  if (e<=0 || e>(long)v.size()) e = v.size();
+
+  for (long lo = 1; lo < e; lo *= 2) { // level: lo < power <= min(2lo,e)
+    long hi = min(2*lo, e);
+    long width = hi - lo;
+    long outer = min(width, AvailableThreads());
+
+    if (outer < 2 || outer <= innerThreads(v[0])) {
+      for (long j = lo+1; j <= hi; j++) computePower(j);
+      continue;
+    }
+    NTL_EXEC_RANGE(width, first, last)
+      for (long j = lo+1+first; j <= lo+last; j++) {
+        if (!v[j-1].isEmpty()) continue;
+        Ctxt tmp = v[j-lo-1];      // X^{j-lo}, already computed
+        tmp.multiplyBy(v[lo-1]);   // times X^lo
+        tmp.modDownToLevel(tmp.findBaseLevel());
+        v[j-1] = tmp;
+      }
+    NTL_EXEC_RANGE_END
+  }
+}
 
+// Local function for the evaluation of an encrypted polynomial
 static void recursivePolyEval(Ctxt& ret, const Ctxt poly[], long nCoeffs,
 			      const Vec<Ctxt>& powers);
 
@@ -94,142 +152,94 @@ static void recursivePolyEval(Ctxt& ret, const Ctxt poly[], long nCoeffs,
 }
 
 
+// How many baby steps: set k~sqrt(n/2), rounded up/down to a power of two
+static long defaultBabySteps(long d)
+{
+  long kk = (long) sqrt(d/2.0);
+  long k = 1L << NextPowerOfTwo(kk);
+
+  // heuristic: if k>>kk then use a smaler power of two
+  if ((k==16 && d>167) || (k>16 && k>(1.44*kk)))
+    k /= 2;
+  return k;
+}
+
 // Main entry point: Evaluate a cleartext polynomial on an encrypted input
 void polyEval(Ctxt& ret, ZZX poly, const Ctxt& x, long k)
      // Note: poly is passed by value, so caller keeps the original
 {
-  if (deg(poly)<=2) {  // nothing to optimize here
-    if (deg(poly)<1) { // A constant
-      ret.clear();
-      ret.addConstant(coeff(poly, 0));
-    } else {           // A linear or quadratic polynomial
-      DynamicCtxtPowers babyStep(x, deg(poly));
-      simplePolyEval(ret, poly, babyStep);
-    }
-    return;
-  }
-
-  // How many baby steps: set k~sqrt(n/2), rounded up/down to a power of two
-
-  // FIXME: There may be some room for optimization here: it may be possible
-  // to choose k as something other than a power of two and still maintain
-  // optimal depth, in principle we can try all possible values of k between
-  // two consecutive powers of two and choose the one that gives the least
-  // number of multiplies, conditioned on minimum depth.
-
-  if (k<=0) {
-    long kk = (long) sqrt(deg(poly)/2.0);
-    k = 1L << NextPowerOfTwo(kk);
-
-    // heuristic: if k>>kk then use a smaler power of two
-    if ((k==16 && deg(poly)>167) || (k>16 && k>(1.44*kk)))
-      k /= 2;
-  }
-#ifdef DEBUG_PRINTOUT
-  cerr << "  k="<<k;
-#endif
-
-  long n = divc(deg(poly),k);      // n = ceil(deg(p)/k), deg(p) >= k*n
-  DynamicCtxtPowers babyStep(x, k);
-  const Ctxt& x2k = babyStep.getPower(k);
-
-  // Special case when deg(p)>k*(2^e -1)
-  if (n==(1L << NextPowerOfTwo(n))) { // n is a power of two
-    DynamicCtxtPowers giantStep(x2k, n/2);
-    degPowerOfTwo(ret, poly, k, babyStep, giantStep);
-    return;
-  }
-
-  // If n is not a power of two, ensure that poly is monic and that
-  // its degree is divisible by k, then call the recursive procedure
-
-  const ZZ p = to_ZZ(x.getPtxtSpace());
-  ZZ top = LeadCoeff(poly);
-  ZZ topInv; // the inverse mod p of the top coefficient of poly (if any)
-  bool divisible = (n*k == deg(poly)); // is the degree divisible by k?
-  long nonInvertibe = InvModStatus(topInv, top, p);
-       // 0 if invertible, 1 if not
-
-  // FIXME: There may be some room for optimization below: instead of
-  // adding a term X^{n*k} we can add X^{n'*k} for some n'>n, so long
-  // as n' is smaller than the next power of two. We could save a few
-  // multiplications since giantStep[n'] may be easier to compute than
-  // giantStep[n] when n' has fewer 1's than n in its binary expansion.
+  PolyEvalPlan plan; // k<=0: the default, see optimizePolyEval for better
+  plan.k = k;
+  polyEval(ret, poly, x, plan);
+}
 
-  ZZ extra = ZZ::zero();    // extra!=0 denotes an added term extra*X^{n*k}
-  if (!divisible || nonInvertibe) {  // need to add a term
-    top = to_ZZ(1);  // new top coefficient is one
-    topInv = top;    // also the new inverse is one
-    // set extra = 1 - current-coeff-of-X^{n*k}
-    extra = SubMod(top, coeff(poly,n*k), p);
-    SetCoeff(poly, n*k); // set the top coefficient of X^{n*k} to one
-  }
+void polyEval(Ctxt& ret, ZZX poly, const Ctxt& x, const PolyEvalPlan& plan)
+{
+  PolyEvalPrecomp(poly, x.getPtxtSpace(), plan).eval(ret, x);
+}
 
-  long t = IsZero(extra)? divc(n,2) : n;
-  DynamicCtxtPowers giantStep(x2k, t);
 
-  if (!IsOne(top)) {
-    poly *= topInv; // Multiply by topInv to make into a monic polynomial
-    for (long i=0; i<=n*k; i++) rem(poly[i], poly[i], p);
-    poly.normalize();
-  }
-  recursivePolyEval(ret, poly, k, babyStep, giantStep);
+/**********************************************************************/
+/*   The decomposition of the polynomial, computed once per plan      */
+/**********************************************************************/
 
-  if (!IsOne(top)) {
-    ret.multByConstant(top);
-  }
+// One step of the recursion, with its polynomials already split and reduced
+struct PolyEvalPrecomp::Node {
+  enum Kind { SIMPLE, PATERSON_STOCKMEYER, DEG_POWER_OF_TWO, RECURSIVE };
+
+  Kind kind;
+  vector<ZZ> coeffs; // SIMPLE: f_0,...,f_d in [-p/2,p/2], empty for zero
+  long t;            // PATERSON_STOCKMEYER: the giant step X^{kt}
+                     // DEG_POWER_OF_TWO: n=2^e, X^{k(n-1)} is a product
+                     // RECURSIVE: X^u = giantStep[t] * babyStep[delta]
+  long delta;
+  shared_ptr<Node> child[3];
+    // PATERSON_STOCKMEYER: poly = (c + X^{kt})*q + s: child = {q, c, s}
+    // DEG_POWER_OF_TWO:    poly = r + q*X^{k(n-1)}:    child = {r, q}
+    // RECURSIVE:           poly = q*X^u + r:           child = {q, r}
+
+  explicit Node(Kind _kind): kind(_kind), t(0), delta(0) {}
+};
+typedef shared_ptr<PolyEvalPrecomp::Node> PolyEvalNodePtr;
+typedef PolyEvalPrecomp::Node PolyEvalNode;
 
-  if (!IsZero(extra)) { // if we added a term, now is the time to subtract back
-    Ctxt topTerm = giantStep.getPower(n);
-    topTerm.multByConstant(extra);
-    ret -= topTerm;
-  }
+// The parameters that polyEval used to reject with an assertion
+static void checkPlan(bool b)
+{
+  if (!b) throw std::invalid_argument("polyEval: bad baby-step parameters");
 }
 
-
-// Simple evaluation sum f_i * X^i, assuming that babyStep has enough powers
-static void 
-simplePolyEval(Ctxt& ret, const ZZX& poly, DynamicCtxtPowers& babyStep)
+static PolyEvalNodePtr
+buildSimple(const ZZX& poly, long babySize, const ZZ& p)
 {
-  ret.clear();
-  if (deg(poly)<0) return;       // the zero polynomial always returns zero
-
-  assert (deg(poly)<=babyStep.size()); // ensure that we have enough powers
-
-  ZZ coef;
-  ZZ p = to_ZZ(babyStep[0].getPtxtSpace());
-  for (long i=1; i<=deg(poly); i++) {
-    rem(coef, coeff(poly,i),p);
+  PolyEvalNodePtr node(new PolyEvalNode(PolyEvalNode::SIMPLE));
+  if (deg(poly)<0) return node;   // the zero polynomial always returns zero
+
+  checkPlan(deg(poly)<=babySize); // ensure that we have enough powers
+  node->coeffs.resize(deg(poly)+1);
+  for (long i=0; i<=deg(poly); i++) {
+    ZZ& coef = node->coeffs[i];
+    rem(coef, coeff(poly,i), p);
     if (coef > p/2) coef -= p;
-
-    Ctxt tmp = babyStep.getPower(i); // X^i
-    tmp.multByConstant(coef);        // f_i X^i
-    ret += tmp;
   }
-  // Add the free term
-  rem(coef, ConstTerm(poly), p);
-  if (coef > p/2) coef -= p;
-  ret.addConstant(coef);
-  //  if (verbose) checkPolyEval(ret, babyStep[0], poly);
+  return node;
 }
 
-
 // The recursive procedure in the Paterson-Stockmeyer
 // polynomial-evaluation algorithm from SIAM J. on Computing, 1973.
 // This procedure assumes that poly is monic, deg(poly)=k*(2t-1)+delta
 // with t=2^e, and that babyStep contains >= k+delta powers
-static void
-PatersonStockmeyer(Ctxt& ret, const ZZX& poly, long k, long t, long delta,
-		   DynamicCtxtPowers& babyStep, DynamicCtxtPowers& giantStep)
+static PolyEvalNodePtr
+buildPatersonStockmeyer(const ZZX& poly, long k, long t, long delta,
+                        long babySize, const ZZ& p)
 {
-  if (deg(poly)<=babyStep.size()) { // Edge condition, use simple eval
-    simplePolyEval(ret, poly, babyStep);
-    return;
-  }
+  if (deg(poly)<=babySize) // Edge condition, use simple eval
+    return buildSimple(poly, babySize, p);
+
   ZZX r = trunc(poly, k*t);      // degree <= k*2^e-1
   ZZX q = RightShift(poly, k*t); // degree == k(2^e-1) +delta
+  checkPlan(t>0 && deg(q)>=0 && IsOne(LeadCoeff(q)));
 
-  const ZZ p = to_ZZ(babyStep[0].getPtxtSpace());
   const ZZ& coef = coeff(r,deg(q));
   SetCoeff(r, deg(q), coef-1);  // r' = r - X^{deg(q)}
 
@@ -237,8 +247,8 @@ PatersonStockmeyer(Ctxt& ret, const ZZX& poly, long k, long t, long delta,
   DivRem(c,s,r,q); // r' = c*q + s
   // deg(s)<deg(q), and if c!= 0 then deg(c)<k-delta
 
-  assert(deg(s)<deg(q));
-  assert(IsZero(c) || deg(c)<k-delta);
+  checkPlan(deg(s)<deg(q));
+  checkPlan(IsZero(c) || deg(c)<k-delta);
   SetCoeff(s,deg(q)); // s' = s + X^{deg(q)}, deg(s)==deg(q)
 
   // reduce the coefficients modulo p
@@ -247,28 +257,23 @@ PatersonStockmeyer(Ctxt& ret, const ZZX& poly, long k, long t, long delta,
   for (long i=0; i<=deg(s); i++) rem(s[i],s[i], p);
   s.normalize();
 
-  // Evaluate recursively poly = (c+X^{kt})*q + s'
-  PatersonStockmeyer(ret, q, k, t/2, delta, babyStep, giantStep);
-
-  Ctxt tmp(ret.getPubKey(), ret.getPtxtSpace());
-  simplePolyEval(tmp, c, babyStep);
-  tmp += giantStep.getPower(t);
-  ret.multiplyBy(tmp);
-
-  PatersonStockmeyer(tmp, s, k, t/2, delta, babyStep, giantStep);
-  ret += tmp;
+  // poly = (c+X^{kt})*q + s'
+  PolyEvalNodePtr node(new PolyEvalNode(PolyEvalNode::PATERSON_STOCKMEYER));
+  node->t = t;
+  node->child[0] = buildPatersonStockmeyer(q, k, t/2, delta, babySize, p);
+  node->child[1] = buildSimple(c, babySize, p);
+  node->child[2] = buildPatersonStockmeyer(s, k, t/2, delta, babySize, p);
+  return node;
 }
 
 // This procedure assumes that k*(2^e +1) > deg(poly) > k*(2^e -1),
 // and that babyStep contains >= k + (deg(poly) mod k) powers
-static void
-degPowerOfTwo(Ctxt& ret, const ZZX& poly, long k,
-	      DynamicCtxtPowers& babyStep, DynamicCtxtPowers& giantStep)
+static PolyEvalNodePtr
+buildDegPowerOfTwo(const ZZX& poly, long k, long babySize, const ZZ& p)
 {
-  if (deg(poly)<=babyStep.size()) { // Edge condition, use simple eval
-    simplePolyEval(ret, poly, babyStep);
-    return;
-  }
+  if (deg(poly)<=babySize) // Edge condition, use simple eval
+    return buildSimple(poly, babySize, p);
+
   long n = deg(poly)/k;        // We assume n=2^e or n=2^e -1
   n = 1L << NextPowerOfTwo(n); // round up to n=2^e
   ZZX r = trunc(poly, (n-1)*k);      // degree <= k(2^e-1)-1
@@ -276,42 +281,31 @@ degPowerOfTwo(Ctxt& ret, const ZZX& poly, long k,
   SetCoeff(r, (n-1)*k);              // monic, degree == k(2^e-1)
   q -= 1;
 
-  PatersonStockmeyer(ret, r, k, n/2, 0,	babyStep, giantStep);
-
-  Ctxt tmp(ret.getPubKey(), ret.getPtxtSpace());
-  simplePolyEval(tmp, q, babyStep); // evaluate q
-
-  // multiply by X^{k(n-1)} with minimum depth
-  for (long i=1; i<n; i*=2) {  
-    tmp.multiplyBy(giantStep.getPower(i));
-  }
-  ret += tmp;
+  // poly = r + q*X^{k(n-1)}
+  PolyEvalNodePtr node(new PolyEvalNode(PolyEvalNode::DEG_POWER_OF_TWO));
+  node->t = n;
+  node->child[0] = buildPatersonStockmeyer(r, k, n/2, 0, babySize, p);
+  node->child[1] = buildSimple(q, babySize, p);
+  return node;
 }
 
-static void 
-recursivePolyEval(Ctxt& ret, const ZZX& poly, long k,
-		  DynamicCtxtPowers& babyStep, DynamicCtxtPowers& giantStep)
+static PolyEvalNodePtr
+buildRecursive(const ZZX& poly, long k, long babySize, const ZZ& p)
 {
-  if (deg(poly)<=babyStep.size()) { // Edge condition, use simple eval
-    simplePolyEval(ret, poly, babyStep);
-    return;
-  }
+  if (deg(poly)<=babySize) // Edge condition, use simple eval
+    return buildSimple(poly, babySize, p);
 
   long delta = deg(poly) % k; // deg(poly) mod k
   long n = divc(deg(poly),k); // ceil( deg(poly)/k )
   long t = 1L<<(NextPowerOfTwo(n)); // t >= n, so t*k >= deg(poly)
 
   // Special case for deg(poly) = k * 2^e +delta
-  if (n==t) {
-    degPowerOfTwo(ret, poly, k, babyStep, giantStep);
-    return;
-  }
+  if (n==t)
+    return buildDegPowerOfTwo(poly, k, babySize, p);
 
   // When deg(poly) = k*(2^e -1) we use the Paterson-Stockmeyer recursion
-  if (n == t-1 && delta==0) {
-    PatersonStockmeyer(ret, poly, k, t/2, delta, babyStep, giantStep);
-    return;
-  }
+  if (n == t-1 && delta==0)
+    return buildPatersonStockmeyer(poly, k, t/2, delta, babySize, p);
 
   t = t/2;
 
@@ -325,18 +319,402 @@ recursivePolyEval(Ctxt& ret, const ZZX& poly, long k,
   q -= 1;
   SetCoeff(r, u);              // degree == u
 
-  PatersonStockmeyer(ret, q, k, t/2, 0, babyStep, giantStep);
+  PolyEvalNodePtr node(new PolyEvalNode(PolyEvalNode::RECURSIVE));
+  node->t = u/k;
+  node->delta = delta;
+  node->child[0] = buildPatersonStockmeyer(q, k, t/2, 0, babySize, p);
+  node->child[1] = buildRecursive(r, k, babySize, p);
+  return node;
+}
 
-  Ctxt tmp = giantStep.getPower(u/k);
-  if (delta!=0) { // if u is not divisible by k then compute it
-    tmp.multiplyBy(babyStep.getPower(delta));
+PolyEvalPrecomp::PolyEvalPrecomp(const ZZX& poly, long _ptxtSpace,
+                                 const PolyEvalPlan& _plan)
+  : ptxtSpace(_ptxtSpace), plan(_plan), k(0), nGiant(0), nPrime(0),
+    top(1), extra(0)
+{
+  FHE_TIMER_START;
+  const ZZ p = to_ZZ(ptxtSpace);
+  ZZX f = poly;
+
+  if (deg(f)<=2) {  // nothing to optimize here
+    plan.k = plan.nPrime = 0;
+    root = buildSimple(f, max(deg(f),0L), p);
+    computeCost();
+    return;
+  }
+
+  k = (plan.k>0)? plan.k : defaultBabySteps(deg(f));
+  long n = divc(deg(f),k);      // n = ceil(deg(p)/k), deg(p) >= k*n
+
+  // Special case when deg(p)>k*(2^e -1)
+  if (plan.nPrime<=n && n==(1L << NextPowerOfTwo(n))) { // n is a power of 2
+    nGiant = n/2;
+    root = buildDegPowerOfTwo(f, k, k, p);
+  }
+  else {
+    // If n is not a power of two, ensure that poly is monic and that
+    // its degree is divisible by k, then call the recursive procedure
+
+    ZZ topInv; // the inverse mod p of the top coefficient of poly (if any)
+    top = LeadCoeff(f);
+    bool divisible = (n*k == deg(f)); // is the degree divisible by k?
+    long nonInvertibe = InvModStatus(topInv, top, p);
+         // 0 if invertible, 1 if not
+
+    // Instead of adding a term X^{n*k} we can add X^{n'*k} for some n'>n:
+    // giantStep[n'] may be easier to compute than giantStep[n] when n' has
+    // fewer 1's than n in its binary expansion (see optimizePolyEval)
+    nPrime = max(plan.nPrime, n);
+
+    // extra!=0 denotes an added term extra*X^{n'*k}
+    if (nPrime>n || !divisible || nonInvertibe) {  // need to add a term
+      top = to_ZZ(1);  // new top coefficient is one
+      topInv = top;    // also the new inverse is one
+      // set extra = 1 - current-coeff-of-X^{n'*k}
+      extra = SubMod(top, coeff(f,nPrime*k), p);
+      SetCoeff(f, nPrime*k); // set the top coefficient of X^{n'*k} to one
+    }
+    nGiant = IsZero(extra)? divc(n,2) : nPrime;
+
+    if (!IsOne(top)) {
+      f *= topInv; // Multiply by topInv to make into a monic polynomial
+      for (long i=0; i<=n*k; i++) rem(f[i], f[i], p);
+      f.normalize();
+    }
+    root = buildRecursive(f, k, k, p);
+  }
+  plan.k = k;
+  plan.nPrime = (nPrime>n)? nPrime : 0;
+  computeCost();
+}
+
+
+/**********************************************************************/
+/*               The evaluation on an encrypted input                 */
+/**********************************************************************/
+
+// Simple evaluation sum f_i * X^i, assuming that babyStep has enough powers
+static void 
+simplePolyEval(Ctxt& ret, const PolyEvalNode& node,
+               DynamicCtxtPowers& babyStep)
+{
+  ret.clear();
+  const vector<ZZ>& coeffs = node.coeffs;
+  if (coeffs.empty()) return;   // the zero polynomial always returns zero
+
+  for (long i=1; i<(long)coeffs.size(); i++) {
+    const ZZ& coef = coeffs[i];
+    if (IsZero(coef)) continue;      // sparse polynomials: nothing to add
+    Ctxt tmp = babyStep.getPower(i); // X^i
+    tmp.multByConstant(coef);        // f_i X^i
+    ret += tmp;
   }
-  ret.multiplyBy(tmp);
+  ret.addConstant(coeffs[0]);        // Add the free term
+}
 
-  recursivePolyEval(tmp, r, k, babyStep, giantStep);
+// The two terms of each step are independent, they are evaluated with
+// parallelInvoke
+static void
+evalNode(Ctxt& ret, const PolyEvalNode& node,
+         DynamicCtxtPowers& babyStep, DynamicCtxtPowers& giantStep)
+{
+  if (node.kind == PolyEvalNode::SIMPLE) {
+    simplePolyEval(ret, node, babyStep);
+    return;
+  }
+
+  Ctxt tmp(ret.getPubKey(), ret.getPtxtSpace());
+  switch (node.kind) {
+  case PolyEvalNode::PATERSON_STOCKMEYER: // (c + X^{kt})*q + s
+    parallelInvoke(babyStep[0], [&]() {
+        evalNode(ret, *node.child[0], babyStep, giantStep);
+
+        Ctxt cx(ret.getPubKey(), ret.getPtxtSpace());
+        evalNode(cx, *node.child[1], babyStep, giantStep);
+        cx += giantStep.getPower(node.t);
+        ret.multiplyBy(cx);
+      }, [&]() {
+        evalNode(tmp, *node.child[2], babyStep, giantStep);
+      });
+    break;
+
+  case PolyEvalNode::DEG_POWER_OF_TWO:    // r + q*X^{k(n-1)}
+    parallelInvoke(babyStep[0], [&]() {
+        evalNode(ret, *node.child[0], babyStep, giantStep);
+      }, [&]() {
+        evalNode(tmp, *node.child[1], babyStep, giantStep);
+
+        // multiply by X^{k(n-1)} with minimum depth
+        for (long i=1; i<node.t; i*=2) {
+          tmp.multiplyBy(giantStep.getPower(i));
+        }
+      });
+    break;
+
+  default:                                // q*X^u + r
+    parallelInvoke(babyStep[0], [&]() {
+        evalNode(ret, *node.child[0], babyStep, giantStep);
+
+        Ctxt xu = giantStep.getPower(node.t);
+        if (node.delta!=0) { // if u is not divisible by k then compute it
+          xu.multiplyBy(babyStep.getPower(node.delta));
+        }
+        ret.multiplyBy(xu);
+      }, [&]() {
+        evalNode(tmp, *node.child[1], babyStep, giantStep);
+      });
+  }
   ret += tmp;
 }
 
+void PolyEvalPrecomp::eval(Ctxt& ret, const Ctxt& x) const
+{
+  FHE_TIMER_START;
+  assert(ptxtSpace % x.getPtxtSpace() == 0);
+
+  if (k==0) {
+    long d = root->coeffs.size()-1;
+    if (d<1) {  // A constant
+      ret.clear();
+      ret.addConstant(d<0? ZZ::zero() : root->coeffs[0]);
+    } else {    // A linear or quadratic polynomial
+      DynamicCtxtPowers babyStep(x, d);
+      simplePolyEval(ret, *root, babyStep);
+    }
+    return;
+  }
+#ifdef DEBUG_PRINTOUT
+  cerr << "  k="<<k;
+#endif
+
+  DynamicCtxtPowers babyStep(x, k);
+  babyStep.computeAll();           // all of them are used below
+  DynamicCtxtPowers giantStep(babyStep.getPower(k), nGiant);
+
+  evalNode(ret, *root, babyStep, giantStep);
+
+  if (!IsOne(top)) {
+    ret.multByConstant(top);
+  }
+
+  if (!IsZero(extra)) { // if we added a term, now is the time to subtract back
+    Ctxt topTerm = giantStep.getPower(nPrime);
+    topTerm.multByConstant(extra);
+    ret -= topTerm;
+  }
+}
+
+
+/**********************************************************************/
+/*  The cost model: the same evaluation, on the depths of the powers  */
+/**********************************************************************/
+
+// What the cost model knows of a ciphertext: its kind and its depth
+struct SymCtxt {
+  long kind;  // 0: empty, 1: only a constant part, 2: a real ciphertext
+  long depth; // multiplicative depth
+  SymCtxt(long _kind=0, long _depth=0): kind(_kind), depth(_depth) {}
+};
+
+struct SymCost {
+  long nMults, nConstMults;
+  SymCost(): nMults(0), nConstMults(0) {}
+};
+
+// Same as Ctxt::multiplyBy: a key-switching iff both are real ciphertexts
+static void symMultiplyBy(SymCtxt& a, const SymCtxt& b, SymCost& cost)
+{
+  if (a.kind==0) return;
+  if (a.kind==2 && b.kind==2) {
+    a.depth = max(a.depth, b.depth)+1;
+    cost.nMults++;
+    return;
+  }
+  if (b.kind==0) { a = SymCtxt(); return; }
+  a.kind = max(a.kind, b.kind);
+  a.depth = max(a.depth, b.depth);
+}
+
+static void symAdd(SymCtxt& a, const SymCtxt& b)
+{
+  if (b.kind==0) return;
+  if (a.kind==0) { a = b; return; }
+  a.kind = max(a.kind, b.kind);
+  a.depth = max(a.depth, b.depth);
+}
+
+// Same as DynamicCtxtPowers, keeping only the depth of each power
+class SymPowers {
+  vector<long> dpth; // -1 for a power not computed yet
+  SymCost& cost;
+public:
+  SymPowers(long baseDepth, long nPowers, SymCost& _cost): cost(_cost)
+  {
+    checkPlan(nPowers>0);
+    dpth.resize(nPowers, -1);
+    dpth[0] = baseDepth;
+  }
+  long size() const { return dpth.size(); }
+  SymCtxt getPower(long e)
+  {
+    checkPlan(e>=1 && e<=size());
+    if (dpth[e-1]<0) {
+      long k = 1L<<(NextPowerOfTwo(e)-1);
+      long d = max(getPower(e-k).depth, getPower(k).depth);
+      dpth[e-1] = d+1;
+      cost.nMults++;
+    }
+    return SymCtxt(2, dpth[e-1]);
+  }
+  void computeAll() { for (long e=1; e<=size(); e++) getPower(e); }
+};
+
+static SymCtxt
+symSimplePolyEval(const PolyEvalNode& node, SymPowers& babyStep,
+                  SymCost& cost)
+{
+  SymCtxt ret;
+  const vector<ZZ>& coeffs = node.coeffs;
+  if (coeffs.empty()) return ret;
+
+  for (long i=1; i<(long)coeffs.size(); i++) {
+    if (IsZero(coeffs[i])) continue;
+    cost.nConstMults++;
+    symAdd(ret, babyStep.getPower(i));
+  }
+  symAdd(ret, SymCtxt(1, 0));  // the free term
+  return ret;
+}
+
+static SymCtxt
+symEvalNode(const PolyEvalNode& node, SymPowers& babyStep,
+            SymPowers& giantStep, SymCost& cost)
+{
+  if (node.kind == PolyEvalNode::SIMPLE)
+    return symSimplePolyEval(node, babyStep, cost);
+
+  SymCtxt ret = symEvalNode(*node.child[0], babyStep, giantStep, cost);
+  switch (node.kind) {
+  case PolyEvalNode::PATERSON_STOCKMEYER: {
+    SymCtxt cx = symEvalNode(*node.child[1], babyStep, giantStep, cost);
+    symAdd(cx, giantStep.getPower(node.t));
+    symMultiplyBy(ret, cx, cost);
+    symAdd(ret, symEvalNode(*node.child[2], babyStep, giantStep, cost));
+    break;
+  }
+  case PolyEvalNode::DEG_POWER_OF_TWO: {
+    SymCtxt tmp = symEvalNode(*node.child[1], babyStep, giantStep, cost);
+    for (long i=1; i<node.t; i*=2)
+      symMultiplyBy(tmp, giantStep.getPower(i), cost);
+    symAdd(ret, tmp);
+    break;
+  }
+  default: {
+    SymCtxt xu = giantStep.getPower(node.t);
+    if (node.delta!=0)
+      symMultiplyBy(xu, babyStep.getPower(node.delta), cost);
+    symMultiplyBy(ret, xu, cost);
+    symAdd(ret, symEvalNode(*node.child[1], babyStep, giantStep, cost));
+  }
+  }
+  return ret;
+}
+
+// Follows eval step by step, throws where it would
+void PolyEvalPrecomp::computeCost()
+{
+  SymCost cost;
+  SymCtxt ret;
+
+  if (k==0) {
+    long d = root->coeffs.size()-1;
+    if (d>=1) {
+      SymPowers babyStep(0, d, cost);
+      ret = symSimplePolyEval(*root, babyStep, cost);
+    }
+  }
+  else {
+    SymPowers babyStep(0, k, cost);
+    babyStep.computeAll();
+    SymPowers giantStep(babyStep.getPower(k).depth, nGiant, cost);
+
+    ret = symEvalNode(*root, babyStep, giantStep, cost);
+    if (!IsOne(top)) cost.nConstMults++;
+    if (!IsZero(extra)) {
+      symAdd(ret, giantStep.getPower(nPrime));
+      cost.nConstMults++;
+    }
+  }
+  plan.depth = ret.depth;
+  plan.nMults = cost.nMults;
+  plan.nConstMults = cost.nConstMults;
+}
+
+bool polyEvalCost(PolyEvalPlan& plan, const ZZX& poly, long ptxtSpace)
+{
+  try {
+    plan = PolyEvalPrecomp(poly, ptxtSpace, plan).getPlan();
+  }
+  catch (std::invalid_argument&) {
+    return false;
+  }
+  return true;
+}
+
+// Is plan a strictly cheaper than plan b: minimum depth first, then the
+// key-switchings, then the constant multiplications
+static bool cheaperPlan(const PolyEvalPlan& a, const PolyEvalPlan& b)
+{
+  if (a.depth != b.depth) return a.depth < b.depth;
+  if (a.nMults != b.nMults) return a.nMults < b.nMults;
+  return a.nConstMults < b.nConstMults;
+}
+
+static FHE_MUTEX_TYPE planCacheMx;
+static map<string, PolyEvalPlan> planCache;
+
+// Try k between half and twice the default, and n' from n up to the next
+// power of two (at most 8 more); ties keep the default parameters
+PolyEvalPlan optimizePolyEval(const ZZX& poly, long ptxtSpace)
+{
+  ostringstream key;
+  key << ptxtSpace << ':' << poly;
+  {
+    FHE_MUTEX_GUARD(planCacheMx);
+    map<string, PolyEvalPlan>::const_iterator it = planCache.find(key.str());
+    if (it != planCache.end()) return it->second;
+  }
+  FHE_TIMER_START;
+
+  PolyEvalPlan best;
+  polyEvalCost(best, poly, ptxtSpace); // the default, always valid
+  long d = deg(poly);
+  if (d>2) {
+    long kDefault = best.k;
+    for (long k = max(2L, kDefault/2); k <= min(d-1, 2*kDefault); k++) {
+      long n = divc(d,k);
+      long nMax = min(1L << NextPowerOfTwo(n), n+8);
+      for (long nPrime = n; nPrime <= nMax; nPrime++) {
+        PolyEvalPlan plan;
+        plan.k = k;
+        plan.nPrime = (nPrime==n)? 0 : nPrime;
+        if (polyEvalCost(plan, poly, ptxtSpace) && cheaperPlan(plan, best))
+          best = plan;
+      }
+    }
+  }
+
+  FHE_MUTEX_GUARD(planCacheMx);
+  planCache[key.str()] = best;
+  return best;
+}
+
+ostream& operator<<(ostream& s, const PolyEvalPlan& plan)
+{
+  return s << "[k=" << plan.k << " n'=" << plan.nPrime
+           << " depth=" << plan.depth << " mults=" << plan.nMults
+           << " constMults=" << plan.nConstMults << "]";
+}
 
 
 // raise ciphertext to some power
@@ -15,16 +15,90 @@
  */
 
 
+#include <memory>
 #include "Ctxt.h"
+#include "multicore.h"
 
 //! @brief Evaluate a cleartext polynomial on an encrypted input
 //! @param[out] res  to hold the return value
 //! @param[in]  poly the degree-d polynomial to evaluate
 //! @param[in]  x    the point on which to evaluate
 //! @param[in]  k    optional optimization parameter, defaults to sqrt(d/2) rounded up or down to a power of two
+//!
+//! When the NTL thread pool has threads that the DoubleCRT loops of a single
+//! multiplication cannot use, the baby-step powers of each level are computed
+//! concurrently, and so are the two halves of the top recursive split.
 void polyEval(Ctxt& ret, ZZX poly, const Ctxt& x, long k=0);
      // Note: poly is passed by value, so caller keeps the original
 
+//! @brief The choice of the baby-step parameter k and of the added top term
+//! X^{nPrime*k} for the evaluation of a polynomial, and its cost
+class PolyEvalPlan {
+public:
+  long k;           //!< number of baby steps (k<=0: the default heuristic)
+  long nPrime;      //!< the polynomial is made monic of degree nPrime*k
+                    //!< (0 for the default n=ceil(d/k))
+  long depth;       //!< multiplicative depth of the evaluation
+  long nMults;      //!< ciphertext-ciphertext multiplications (key-switchings)
+  long nConstMults; //!< multiplications by plaintext constants
+
+  PolyEvalPlan(): k(0), nPrime(0), depth(0), nMults(0), nConstMults(0) {}
+};
+ostream& operator<<(ostream& s, const PolyEvalPlan& plan);
+
+//! @brief Compute the cost of evaluating poly mod ptxtSpace with the
+//! parameters plan.k and plan.nPrime, without any ciphertext: the recursion
+//! of polyEval is followed on the polynomials and the powers it uses.
+//! Returns false if polyEval cannot use these parameters
+bool polyEvalCost(PolyEvalPlan& plan, const ZZX& poly, long ptxtSpace);
+
+//! @brief Choose the parameters (k, nPrime) for the evaluation of poly mod
+//! ptxtSpace: among the ones with the smallest depth, the plan with the
+//! fewest ciphertext multiplications, then the fewest constant
+//! multiplications (zero coefficients cost nothing). The plans are cached
+//! per polynomial, and the cache can be used from concurrent threads.
+PolyEvalPlan optimizePolyEval(const ZZX& poly, long ptxtSpace);
+
+//! @brief Evaluate a cleartext polynomial on an encrypted input, with the
+//! parameters of a plan returned by optimizePolyEval
+void polyEval(Ctxt& ret, ZZX poly, const Ctxt& x, const PolyEvalPlan& plan);
+
+//! @brief A cleartext polynomial prepared for polyEval.
+//! Everything that does not depend on the input is done once by the
+//! constructor: the monic transformation, the whole Paterson-Stockmeyer
+//! decomposition of the polynomial and the reduction of its coefficients
+//! mod ptxtSpace. eval can then be called on many ciphertexts, also from
+//! concurrent threads.
+class PolyEvalPrecomp {
+public:
+  struct Node; // one step of the recursion, defined in polyEval.cpp
+
+private:
+  long ptxtSpace;
+  PolyEvalPlan plan;  // with its cost
+  long k;             // baby steps, 0 for a polynomial of degree <= 2
+  long nGiant;        // giant steps X^{k}, ..., X^{k*nGiant}
+  long nPrime;        // index of the giant step of the added term
+  ZZ top;             // the result is multiplied by top
+  ZZ extra;           // then extra*X^{nPrime*k} is subtracted
+  shared_ptr<Node> root;
+
+  void computeCost();
+
+public:
+  //! Throws std::invalid_argument if polyEval cannot use the parameters of
+  //! plan (k<=0: the default k=sqrt(d/2) rounded to a power of two)
+  PolyEvalPrecomp(const ZZX& poly, long ptxtSpace,
+                  const PolyEvalPlan& plan = PolyEvalPlan());
+
+  //! The parameters and the cost of the evaluation
+  const PolyEvalPlan& getPlan() const { return plan; }
+  long getPtxtSpace() const { return ptxtSpace; }
+
+  //! ret = poly(x), x must have a plaintext space dividing ptxtSpace
+  void eval(Ctxt& ret, const Ctxt& x) const;
+};
+
 //! @brief Evaluate an encrypted polynomial on an encrypted input
 //! @param[out] res  to hold the return value
 //! @param[in]  poly the degree-d polynomial to evaluate
@@ -41,6 +115,12 @@ void polyEval(Ctxt& ret, const Vec<Ctxt>& poly, const Ctxt& x);
 class DynamicCtxtPowers {
 private:
   vector<Ctxt> v;   // A vector storing the powers themselves
+  FHE_MUTEX_TYPE mtx; // getPower can be called from concurrent threads
+
+  Ctxt& computePower(long e); // same as getPower, caller holds mtx
+
+  DynamicCtxtPowers(const DynamicCtxtPowers&); // not copyable
+  DynamicCtxtPowers& operator=(const DynamicCtxtPowers&);
 
 public:
   DynamicCtxtPowers(const Ctxt& c, long nPowers)
@@ -55,6 +135,11 @@ public:
   //! @brief Returns the e'th power, computing it as needed
   Ctxt& getPower(long e); // must use e >= 1, else throws an exception
 
+  //! @brief Compute all the powers up to e (default: all of them) level by
+  //! level, the powers in the same level being computed concurrently if
+  //! that uses more threads than a single multiplication would
+  void computeAll(long e=0);
+
   //! dp.at(i) and dp[i] both return the i+1st power
   Ctxt& at(long i) { return getPower(i+1); }
   Ctxt& operator[](long i) { return getPower(i+1); }
@@ -14,6 +14,7 @@
  */
 
 #include "powerful.h"
+#include "binio.h"
 
 // powVec[d] = p_d^{e_d}, m = \prod_d p_d^{e_d}
 // computes divVec[d] = m/p_d^{e_d}
@@ -237,8 +238,60 @@ long PowerfulConversion::powerfulToPoly(zz_pX& poly,
   return zz_p::modulus();
 }
 
+// Read the tables written by PowerfulTranslationIndexes::write. Only the
+// cube signatures are recomputed, from mvec and phivec.
+PowerfulTranslationIndexes::PowerfulTranslationIndexes(istream& str)
+{
+  m = read_raw_long(str);
+  phim = read_raw_long(str);
+  read_raw_vec_long(str, mvec);
+  read_raw_vec_long(str, phivec);
+  read_raw_vec_long(str, divvec);
+  read_raw_vec_long(str, invvec);
+  read_raw_vec_long(str, polyToCubeMap);
+  read_raw_vec_long(str, cubeToPolyMap);
+  read_raw_vec_long(str, shortToLongMap);
+
+  longSig.initSignature(mvec);
+  shortSig.initSignature(phivec);
+
+  long nfactors = read_raw_long(str);
+  cycVec.SetLength(nfactors);
+  for (long d = 0; d < nfactors; d++) read_raw_ZZX(str, cycVec[d]);
+  read_raw_ZZX(str, phimX);
+}
+
+void PowerfulTranslationIndexes::write(ostream& str) const
+{
+  write_raw_long(str, m);
+  write_raw_long(str, phim);
+  write_raw_vec_long(str, mvec);
+  write_raw_vec_long(str, phivec);
+  write_raw_vec_long(str, divvec);
+  write_raw_vec_long(str, invvec);
+  write_raw_vec_long(str, polyToCubeMap);
+  write_raw_vec_long(str, cubeToPolyMap);
+  write_raw_vec_long(str, shortToLongMap);
+
+  write_raw_long(str, cycVec.length());
+  for (long d = 0; d < cycVec.length(); d++) write_raw_ZZX(str, cycVec[d]);
+  write_raw_ZZX(str, phimX);
+}
+
+
 PowerfulDCRT::PowerfulDCRT(const FHEcontext& _context, const Vec<long>& mvec):
   context(_context), indexes(mvec)
+{
+  initPConvVec();
+}
+
+PowerfulDCRT::PowerfulDCRT(const FHEcontext& _context, istream& str):
+  context(_context), indexes(str)
+{
+  initPConvVec();
+}
+
+void PowerfulDCRT::initPConvVec()
 {
   zz_pBak bak; bak.save(); // backup NTL's current modulus
 
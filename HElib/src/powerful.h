@@ -43,6 +43,10 @@ class PowerfulTranslationIndexes {
   ZZX phimX;
 
   PowerfulTranslationIndexes(const Vec<long>& mv);
+
+  //! Read the tables written by write (binary, see binio.h)
+  explicit PowerfulTranslationIndexes(istream& str);
+  void write(ostream& str) const;
 };
 
 /**
@@ -124,9 +128,15 @@ class PowerfulDCRT {
   // a vector of PowerfulConversion tables, one for each modulus in the chain
   Vec<PowerfulConversion> pConvVec;
 
+  void initPConvVec(); // the tables for all the moduli in the chain
+
 public:
   PowerfulDCRT(const FHEcontext& _context, const Vec<long>& mvec);
 
+  //! Read the index tables written by write instead of computing them
+  PowerfulDCRT(const FHEcontext& _context, istream& str);
+  void write(ostream& str) const { indexes.write(str); }
+
   const PowerfulTranslationIndexes& getIndexTranslation() const
   { return indexes; }
   const PowerfulConversion& getPConv(long i) const
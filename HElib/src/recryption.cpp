@@ -14,6 +14,7 @@
 #include "EncryptedArray.h"
 #include "EvalMap.h"
 #include "powerful.h"
+#include "binio.h"
 
 #include <NTL/BasicThreadPool.h>
 
@@ -186,6 +187,72 @@ void RecryptData::init(const FHEcontext& context, const Vec<long>& mvec_,
   }
 }
 
+void RecryptData::write(ostream& str, const FHEcontext& context) const
+{
+  assert(alMod != NULL); // nothing to write before init
+  write_raw_long(str, (long) contextFingerprint(context));
+
+  write_raw_vec_long(str, mvec);
+  write_raw_long(str, hwt);
+  write_raw_long(str, conservative);
+  write_raw_long(str, cacheType);
+  write_raw_long(str, e);
+  write_raw_long(str, ePrime);
+  write_raw_long(str, skHwt);
+  write_raw_double(str, alpha);
+
+  firstMap->writeCache(str);
+  secondMap->writeCache(str);
+  p2dConv->write(str);
+  write_raw_vec_ZZX(str, unpackSlotEncoding);
+}
+
+// The matrices of the linear maps are rebuilt (which is fast), their
+// caches, the powerful-basis tables and the unpacking constants are read.
+bool RecryptData::read(istream& str, const FHEcontext& context)
+{
+  if (alMod != NULL) { // already initialized
+    cerr << "@Warning: RecryptData::read on initialized data\n";
+    return false;
+  }
+  try {
+    if ((unsigned long) read_raw_long(str) != contextFingerprint(context))
+      return false;
+
+    read_raw_vec_long(str, mvec);
+    hwt = read_raw_long(str);
+    conservative = read_raw_long(str);
+    cacheType = read_raw_long(str);
+    e = read_raw_long(str);
+    ePrime = read_raw_long(str);
+    skHwt = read_raw_long(str);
+    alpha = read_raw_double(str);
+
+    long r = context.alMod.getR();
+    alMod = new PAlgebraMod(context.zMStar, e-ePrime+r);
+    ea = new EncryptedArray(context, *alMod);
+
+    firstMap  = new EvalMap(*ea, mvec, true);
+    secondMap = new EvalMap(*context.ea, mvec, false);
+    firstMap->readCache(str);
+    secondMap->readCache(str);
+
+    p2dConv = new PowerfulDCRT(context, str);
+    read_raw_vec_ZZX(str, unpackSlotEncoding);
+  }
+  catch (runtime_error& err) { // truncated stream: back to uninitialized
+    cerr << "@Warning: RecryptData::read: " << err.what() << endl;
+    delete alMod;     alMod = NULL;
+    delete ea;        ea = NULL;
+    delete firstMap;  firstMap = NULL;
+    delete secondMap; secondMap = NULL;
+    delete p2dConv;   p2dConv = NULL;
+    unpackSlotEncoding.clear();
+    return false;
+  }
+  return true;
+}
+
 /********************************************************************/
 /********************************************************************/
 
@@ -463,22 +530,24 @@ void extractDigitsPacked(Ctxt& ctxt, long botHigh, long r, long ePrime,
 
   FHE_NTIMER_START(extractDigits);
 
+  // extract digits topHigh...0 of all the unpacked[i] at once
+  vector< vector<Ctxt> > allScratch;
+  if (topHigh<=0) { // extracting LSB = no-op
+    allScratch.resize(d);
+    for (long i = 0; i < d; i++) allScratch[i].assign(1,unpacked[i]);
+  } else {
+    extractDigits(allScratch, unpacked, topHigh+1);
+  }
+  if (topHigh >= (long)allScratch[0].size()) {
+    topHigh = allScratch[0].size() -1;
+    cerr << " @ suspect: not enough digits in extractDigitsPacked\n";
+  }
+
   NTL_EXEC_RANGE(d, first, last)
       for (long i = first; i < last; i++) {
-        vector<Ctxt> scratch;
-    
-        if (topHigh<=0) { // extracting LSB = no-op
-          scratch.assign(1,unpacked[i]);
-        } else {          // extract digits topHigh...0, store them in scratch
-          extractDigits(scratch, unpacked[i], topHigh+1);
-        }
+        vector<Ctxt>& scratch = allScratch[i];
 
         // set upacked[i] = -\sum_{j=botHigh}^{topHigh} scratch[j] * p^{j-botHigh}
-        if (topHigh >= (long)scratch.size()) {
-          topHigh = scratch.size() -1;
-          cerr << " @ suspect: not enough digits in extractDigitsPacked\n";
-        }
-    
         unpacked[i] = scratch[topHigh];
         for (long j=topHigh-1; j>=botHigh; --j) {
           unpacked[i].multByP();
@@ -71,6 +71,15 @@ public:
             long t=0/*min Hwt for sk*/, bool consFlag=false,
             int cacheType=0/*0: no cache, 1:zzX, 2:DCRT*/);
 
+  //! Write all the recryption data, including the caches of the linear
+  //! maps, in binary (see binio.h) with the fingerprint of the context
+  void write(ostream& str, const FHEcontext& context) const;
+
+  //! Initialize the recryption data from what write wrote, instead of
+  //! init. Returns false, leaving the data uninitialized, if the data was
+  //! written for another context or the stream is truncated
+  bool read(istream& str, const FHEcontext& context);
+
   bool operator==(const RecryptData& other) const;
   bool operator!=(const RecryptData& other) const {
     return !(operator==(other));
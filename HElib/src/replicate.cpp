@@ -10,9 +10,11 @@
  * limitations under the License. See accompanying LICENSE file.
  */
 
+#include <NTL/BasicThreadPool.h>
 #include "replicate.h"
 #include "timing.h"
 #include "cloned_ptr.h"
+#include "matmul.h" // concurrentSteps
 
 
 
@@ -350,7 +352,7 @@ void recursiveReplicateDim(const EncryptedArray& ea, const Ctxt& ctxt,
                            RepAuxDim& repAux,
                            ReplicateHandler *handler)
 {
-  if (pos >= limit) return;
+  if (pos >= limit || handler->isDone()) return;
 
   if (replicateVerboseFlag) { // DEBUG code
     cerr << "check: " << k; CheckCtxt(ctxt, "");
@@ -423,7 +425,7 @@ void recursiveReplicateDim(const EncryptedArray& ea, const Ctxt& ctxt,
   }
 
   pos += (1L << k);
-  if (pos >= limit)
+  if (pos >= limit || handler->isDone())
     return;
 
   Ctxt ctxt_right = ctxt;
@@ -443,6 +445,8 @@ void replicateAllNextDim(const EncryptedArray& ea, const Ctxt& ctxt,
 {
   assert(d >= 0);
 
+  if (handler->isDone()) return; // the remaining outputs are not needed
+
   // If already fully replicated (or we need to stop early), call the handler
   if (d >= ea.dimension() || handler->earlyStop(d,/*k=*/-1,dimProd)) {
     handler->handle(ctxt);
@@ -528,7 +532,7 @@ void replicateAllNextDim(const EncryptedArray& ea, const Ctxt& ctxt,
                           dimProd, recBound, repAux, handler);
   }
   else { // replicate the slots in each block separately
-    for (long pos = 0; pos < numBlocks; pos++) {
+    for (long pos = 0; pos < numBlocks && !handler->isDone(); pos++) {
       Ctxt ctxt2 = ctxt1;
       // zero-out all the slots outside the current block
       SelectRangeDim(ea, ctxt2, pos*blockSize, (pos+1)*blockSize, d);
@@ -545,7 +549,7 @@ void replicateAllNextDim(const EncryptedArray& ea, const Ctxt& ctxt,
 
   // If dSize is not an integral number of blocks, then we still need
   // to deal with the leftover slots.
-  if (extent < dSize) {
+  if (extent < dSize && !handler->isDone()) {
     // zero-out the slots from before, leaving only the leftover slots
     ctxt1 = ctxt;
     if (repAux.tab1(d, 1).null()) { // generate mask if not already there
@@ -583,6 +587,64 @@ replicateAll(const EncryptedArray& ea, const Ctxt& ctxt,
 }
 
 
+// Hands the outputs of a replication that starts at slot #pos to a
+// concurrent handler, with their slot numbers
+class OffsetReplicator : public ReplicateHandler {
+  ConcurrentReplicateHandler *handler;
+  long pos;
+public:
+  OffsetReplicator(ConcurrentReplicateHandler *_handler, long _pos)
+    : handler(_handler), pos(_pos) {}
+  virtual void handle(const Ctxt& ctxt) { handler->handle(ctxt, pos++); }
+};
+
+void
+replicateAllConcurrent(const EncryptedArray& ea, const Ctxt& ctxt,
+                       ConcurrentReplicateHandler *handler, long recBound,
+                       const RepAuxDim* repAuxPtr)
+{
+  FHE_TIMER_START;
+  long nSlots = ea.size();
+  long avail = concurrentSteps(ctxt, nSlots);
+
+  // The slots i with the same i/rest have the same coordinates along the
+  // dimensions 0..split-1, a few parts per thread for the load balance
+  long split = 0, parts = 1;
+  while (avail > 1 && split < ea.dimension() && parts < 4*avail)
+    parts *= ea.sizeOfDimension(split++);
+  long rest = nSlots/parts;
+
+  PartitionInfo pinfo(parts, (parts < avail)? parts : avail);
+  NTL_EXEC_INDEX(pinfo.NumIntervals(), index)
+    long first, last;
+    pinfo.interval(first, last, index);
+
+    RepAuxDim repAux; // the tables are filled lazily, one per thread
+    if (repAuxPtr != NULL) repAux = *repAuxPtr;
+
+    for (long part = first; part < last; part++) {
+      Ctxt ctxt1 = ctxt;
+      if (split > 0) {
+        // zero-out the other parts, then replicate along dimensions
+        // 0..split-1 with a simple shift-and-add procedure
+        vector<long> maskArray(nSlots, 0);
+        for (long i = part*rest; i < (part+1)*rest; i++) maskArray[i] = 1;
+        ZZX mask;
+        ea.encode(mask, maskArray);
+        ctxt1.multByConstant(mask);
+
+        for (long d = 0; d < split; d++)
+          replicateOneBlock(ea, ctxt1, ea.coordinate(d, part*rest), 1, d);
+      }
+
+      OffsetReplicator offsetHandler(handler, part*rest);
+      replicateAllNextDim(ea, ctxt1, split, parts, recBound, repAux,
+                          &offsetHandler);
+    }
+  NTL_EXEC_INDEX_END
+}
+
+
 // An implementation that explicitly returns all the replicated
 // cipehrtexts in one big vector. This is useful mostly for debugging
 // purposes, for real parameters it would take a lot of memory.
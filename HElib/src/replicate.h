@@ -59,6 +59,11 @@ public:
   // The earlyStop call can be used to quit the replication mid-way, leaving
   // a ciphertext with (e.g.) two different entries, each replicated n/2 times
   virtual bool earlyStop(long d, long k, long prodDim) { return false; }
+
+  // The isDone call can be used to skip the remaining outputs of
+  // replicateAll: once it returns true, the ciphertexts not yet handed
+  // to the handler are not computed at all
+  virtual bool isDone() const { return false; }
 };
 // Applications will derive from this class a handler that actually
 // does something with the replicated cipehrtexts. But it can be used
@@ -85,6 +90,34 @@ void replicateAll(const EncryptedArray& ea, const Ctxt& ctxt,
 		  ReplicateHandler *handler, long recBound = 64,
 		  RepAuxDim* repAuxPtr=NULL);
 
+//! A handler for replicateAllConcurrent. handle(ctxt, pos) receives the
+//! replication of slot #pos. It is called from several threads at once
+//! and in no particular order, so it must be thread-safe.
+class ConcurrentReplicateHandler {
+public:
+  virtual void handle(const Ctxt& ctxt, long pos) = 0;
+  virtual ~ConcurrentReplicateHandler() {}
+};
+
+/**
+ * replicateAllConcurrent computes the same n vectors as replicateAll,
+ * spread over the NTL thread pool. The slots are split by their
+ * coordinates along the first dimensions of the hypercube, into enough
+ * independent parts to keep the threads busy: each part is selected by a
+ * mask and replicated along these dimensions, then the recursion of
+ * replicateAll runs on the other dimensions, one part after the other on
+ * each thread. The results are handed to the handler as they come, so
+ * only O(log n) ciphertexts per thread are in memory at any time.
+ *
+ * Splitting costs one more multiplication by a constant, and O(log n)
+ * more 1D rotations per part. The table repAuxPtr (if any) is only read,
+ * each thread works on its own copy. There is no early stop.
+ **/
+void replicateAllConcurrent(const EncryptedArray& ea, const Ctxt& ctxt,
+                            ConcurrentReplicateHandler *handler,
+                            long recBound = 64,
+                            const RepAuxDim* repAuxPtr=NULL);
+
 //! return the result as a vector of ciphertexts, mostly useful for
 //! debugging purposes (for real parameters would take a lot of memory)
 void replicateAll(std::vector<Ctxt>& v, const EncryptedArray& ea,
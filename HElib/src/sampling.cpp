@@ -0,0 +1,206 @@
+/* Copyright (C) 2012-2017 IBM Corp.
+ * This program is Licensed under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. See accompanying LICENSE file.
+ */
+/* sampling.cpp - per-thread samplers for small/HWt/Gaussian polynomials
+ */
+#include <algorithm>
+#include <memory>
+#include <cstring>
+
+#include "sampling.h"
+#include "multicore.h"
+#include "timing.h"
+
+
+/********************************************************************/
+/****************           The PRG streams          ****************/
+
+SamplerPRG::SamplerPRG(const unsigned char *key) : stream(key), pos(WORDS) {}
+
+void SamplerPRG::refill()
+{
+  unsigned char bytes[WORDS*sizeof(unsigned long)];
+  stream.get(bytes, sizeof(bytes));
+  memcpy(buf, bytes, sizeof(bytes));
+  pos = 0;
+}
+
+unsigned long SamplerPRG::getBounded(unsigned long n)
+{
+  if (n <= 1) return 0;
+
+  long k = NumBits(long(n-1));
+  unsigned long mask = (k >= NTL_BITS_PER_LONG)? ~0UL : (1UL << k) - 1UL;
+  for (;;) { // rejection sampling, succeeds with probability > 1/2
+    unsigned long u = getWord() & mask;
+    if (u < n) return u;
+  }
+}
+
+// The streams are re-keyed whenever samplerEpoch changes. While a seed is
+// set, the i'th thread to re-key uses a key derived from (seed, i).
+static FHE_MUTEX_TYPE samplerMutex;
+static FHE_atomic_long samplerEpoch(0);
+static bool samplerSeeded = false;
+static ZZ samplerSeed;
+static long samplerNextIndex = 0;
+
+SamplerPRG& getSamplerPRG()
+{
+  static thread_local unique_ptr<SamplerPRG> tls_prg;
+  static thread_local long tls_epoch = -1;
+
+  if (tls_prg && tls_epoch == samplerEpoch) return *tls_prg;
+
+  unsigned char key[NTL_PRG_KEYLEN];
+  long epoch;
+  {
+    FHE_MUTEX_GUARD(samplerMutex);
+    epoch = samplerEpoch;
+    if (samplerSeeded) {
+      long nb = NumBytes(samplerSeed);
+      Vec<unsigned char> data;
+      data.SetLength(nb+8);
+      BytesFromZZ(data.elts(), samplerSeed, nb);
+      unsigned long idx = samplerNextIndex++;
+      for (long i = 0; i < 8; i++) data[nb+i] = (idx >> (8*i)) & 0xff;
+      DeriveKey(key, NTL_PRG_KEYLEN, data.elts(), data.length());
+    }
+    else
+      GetCurrentRandomStream().get(key, NTL_PRG_KEYLEN);
+  }
+  tls_prg.reset(new SamplerPRG(key));
+  tls_epoch = epoch;
+  return *tls_prg;
+}
+
+void setSamplerSeed(const ZZ& seed)
+{
+  FHE_MUTEX_GUARD(samplerMutex);
+  samplerSeed = seed;
+  samplerSeeded = true;
+  samplerNextIndex = 0;
+  samplerEpoch++;
+}
+
+void resetSamplerSeed()
+{
+  FHE_MUTEX_GUARD(samplerMutex);
+  samplerSeeded = false;
+  samplerEpoch++;
+}
+
+
+/********************************************************************/
+/****************      The CDT Gaussian sampler      ****************/
+
+CDTGaussian::CDTGaussian(double _stdev) : stdev(_stdev)
+{
+  assert(stdev > 0);
+
+  // Pr[|x| > 10*stdev] is below 2^{-70}, so everything past the table
+  // would round to zero anyway
+  long t = (long) ceil(10*stdev) + 1;
+  long double s2 = 2.0L*stdev*stdev;
+
+  vector<long double> weight(t+1);
+  long double total = 0.0L;
+  for (long i = 0; i <= t; i++) {
+    weight[i] = expl(-((long double) i)*i/s2);
+    if (i > 0) weight[i] *= 2; // for both +i and -i
+    total += weight[i];
+  }
+
+  long double scale = ldexpl(1.0L, NTL_BITS_PER_LONG);
+  long double cum = 0.0L;
+  table.resize(t+1);
+  for (long i = 0; i <= t; i++) {
+    cum += weight[i]/total;
+    long double v = floorl(cum*scale);
+    table[i] = (v >= scale)? ~0UL : (unsigned long) v;
+  }
+  table[t] = ~0UL;
+}
+
+long CDTGaussian::sampleMagnitude(SamplerPRG& prg) const
+{
+  unsigned long u = prg.getWord();
+  long i = upper_bound(table.begin(), table.end(), u) - table.begin();
+  return min(i, tail());
+}
+
+
+/********************************************************************/
+/****************          The zzX samplers          ****************/
+
+void sampleSmall(zzX &poly, long n)
+{
+  FHE_TIMER_START;
+  if (n<=0) n=poly.length(); if (n<=0) return;
+  poly.SetLength(n);
+
+  SamplerPRG& prg = getSamplerPRG();
+  const long perWord = NTL_BITS_PER_LONG/2;
+  for (long i = 0; i < n; i += perWord) {
+    unsigned long w = prg.getWord();
+    long top = min(n, i+perWord);
+    // two bits per coefficient: bit 0 says nonzero, bit 1 is the sign
+    for (long j = i; j < top; j++, w >>= 2)
+      poly[j] = (w & 1)? long(w & 2) - 1 : 0;
+  }
+}
+
+void sampleHWt(zzX &poly, long Hwt, long n)
+{
+  FHE_TIMER_START;
+  if (n<=0) n=poly.length(); if (n<=0) return;
+  poly.SetLength(n);
+  for (long j = 0; j < n; j++) poly[j] = 0;
+  if (Hwt>n) Hwt=n;
+
+  SamplerPRG& prg = getSamplerPRG();
+  unsigned long signs = 0;
+  long nSigns = 0;
+  long i = 0;
+  while (i<Hwt) {  // continue until exactly Hwt nonzero coefficients
+    long u = prg.getBounded(n);
+    if (poly[u] != 0) continue; // we already chose it
+
+    if (nSigns == 0) { signs = prg.getWord(); nSigns = NTL_BITS_PER_LONG; }
+    poly[u] = long((signs & 1) << 1) - 1; // random in {-1,1}
+    signs >>= 1; nSigns--;
+    i++;
+  }
+}
+
+void sampleGaussian(zzX &poly, long n, double stdev)
+{
+  FHE_TIMER_START;
+  if (n<=0) n=poly.length(); if (n<=0) return;
+  poly.SetLength(n);
+
+  // Keep the last table used by this thread, in practice it is always
+  // the one for context.stdev
+  static thread_local unique_ptr<CDTGaussian> tls_cdt;
+  if (!tls_cdt || tls_cdt->getStdev() != stdev)
+    tls_cdt.reset(new CDTGaussian(stdev));
+  const CDTGaussian& cdt = *tls_cdt;
+
+  SamplerPRG& prg = getSamplerPRG();
+  unsigned long signs = 0;
+  long nSigns = 0;
+  for (long j = 0; j < n; j++) {
+    if (nSigns == 0) { signs = prg.getWord(); nSigns = NTL_BITS_PER_LONG; }
+    long x = cdt.sampleMagnitude(prg);
+    poly[j] = (signs & 1)? -x : x;
+    signs >>= 1; nSigns--;
+  }
+}
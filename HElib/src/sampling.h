@@ -0,0 +1,108 @@
+/* Copyright (C) 2012-2017 IBM Corp.
+ * This program is Licensed under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance
+ * with the License. You may obtain a copy of the License at
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License. See accompanying LICENSE file.
+ */
+#ifndef FHE_SAMPLING_H
+#define FHE_SAMPLING_H
+/**
+ * @file sampling.h
+ * @brief Per-thread noise samplers that write directly into a zzX
+ *
+ * The ZZX samplers in NumbTh draw one coefficient at a time from a global
+ * generator. The routines here take their randomness from a per-thread
+ * counter-mode stream (NTL's ChaCha-based RandomStream), consume it one
+ * 64-bit word at a time, and write small signed coefficients directly into
+ * a zzX that can be passed to DoubleCRT::FFT. Gaussians are drawn from a
+ * cumulative distribution table (CDT) instead of using Box-Muller.
+ *
+ * Each thread keys its stream from NTL's PRG the first time it samples.
+ * For testing, setSamplerSeed(seed) makes the streams deterministic: the
+ * i'th thread to sample after the call gets a key derived from (seed,i).
+ **/
+#include "NumbTh.h"
+
+/**
+ * @class SamplerPRG
+ * @brief A pseudorandom stream that hands out 64-bit words
+ **/
+class SamplerPRG {
+  static const long WORDS = 64; // words per refill of the buffer
+
+  RandomStream stream;
+  unsigned long buf[WORDS];
+  long pos;
+
+  void refill();
+
+public:
+  //! key must point to NTL_PRG_KEYLEN bytes
+  explicit SamplerPRG(const unsigned char *key);
+
+  //! A uniform word
+  unsigned long getWord() {
+    if (pos >= WORDS) refill();
+    return buf[pos++];
+  }
+
+  //! A uniform integer in [0,n)
+  unsigned long getBounded(unsigned long n);
+
+private:
+  SamplerPRG(const SamplerPRG&); // disable copy constructor
+  SamplerPRG& operator=(const SamplerPRG&); // disable assignment
+};
+
+//! @brief The sampler stream of the calling thread
+SamplerPRG& getSamplerPRG();
+
+//! @brief Derive all sampler streams from seed (for testing)
+void setSamplerSeed(const ZZ& seed);
+
+//! @brief Key the sampler streams from NTL's PRG again
+void resetSamplerSeed();
+
+/**
+ * @class CDTGaussian
+ * @brief Table-based sampler for the discrete Gaussian over Z
+ *
+ * table[i] holds Pr[|x|<=i] scaled to the full range of a word, so a
+ * magnitude is one word and a binary search. The table is cut off at
+ * 10 standard deviations.
+ **/
+class CDTGaussian {
+  double stdev;
+  vector<unsigned long> table;
+
+public:
+  explicit CDTGaussian(double _stdev);
+
+  double getStdev() const { return stdev; }
+  long tail() const { return table.size()-1; }
+
+  //! Draw |x|, the caller chooses the sign
+  long sampleMagnitude(SamplerPRG& prg) const;
+};
+
+///@{
+//! @name zzX samplers
+//! These mirror the ZZX versions in NumbTh.h. If n<=0 then
+//! n=poly.length() is used.
+
+//! @brief Entries in {-1,0,1}, Prob[0]=1/2
+void sampleSmall(zzX &poly, long n);
+
+//! @brief Entries in {-1,0,1} with exactly min(Hwt,n) nonzeros
+void sampleHWt(zzX &poly, long Hwt, long n);
+
+//! @brief Entries from the discrete Gaussian with parameter stdev
+void sampleGaussian(zzX &poly, long n, double stdev);
+///@}
+
+#endif // FHE_SAMPLING_H
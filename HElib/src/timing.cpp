@@ -54,6 +54,9 @@ bool timer_compare(const FHEtimer *a, const FHEtimer *b)
 
 
 
+// Timers register themselves the first time their function runs, which
+// may happen on any thread, so every access to timerMap takes the lock.
+// The counters themselves are atomic (see timing.h)
 static vector<FHEtimer *> timerMap;
 static FHE_MUTEX_TYPE timerMapMx;
 
@@ -86,6 +89,7 @@ long FHEtimer::getNumCalls() const
 
 void resetAllTimers()
 {
+  FHE_MUTEX_GUARD(timerMapMx);
   for (long i = 0; i < long(timerMap.size()); i++) 
     timerMap[i]->reset();
 }
@@ -93,7 +97,7 @@ void resetAllTimers()
 // Print the value of all timers to stream
 void printAllTimers(ostream& str)
 {
-
+  FHE_MUTEX_GUARD(timerMapMx);
   sort(timerMap.begin(), timerMap.end(), timer_compare);
 
   for (long i = 0; i < long(timerMap.size()); i++) {
@@ -115,6 +119,7 @@ void printAllTimers(ostream& str)
 
 const FHEtimer *getTimerByName(const char *name)
 {
+  FHE_MUTEX_GUARD(timerMapMx);
   for (long i = 0; i < long(timerMap.size()); i++) {
     if (strcmp(name, timerMap[i]->name) == 0)
       return timerMap[i];
@@ -125,6 +130,7 @@ const FHEtimer *getTimerByName(const char *name)
 
 bool printNamedTimer(ostream& str, const char* name)
 {
+  FHE_MUTEX_GUARD(timerMapMx);
   for (long i = 0; i < long(timerMap.size()); i++) {
     if (strcmp(name, timerMap[i]->name) == 0) {
       
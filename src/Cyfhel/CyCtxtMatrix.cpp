@@ -0,0 +1,171 @@
+/*
+ * CyCtxtMatrix
+ * --------------------------------------------------------------------
+ *  Encrypted matrix tiled across several CyCtxt, column by column, for
+ *  the encrypted matrix products of Cyfhel.
+ *  --------------------------------------------------------------------
+ *  Author: Remy AUDA & Alexandre AUDA
+ *  Date: 19/10/2026
+ *  --------------------------------------------------------------------
+ *  License: GNU GPL v3
+ *
+ *  Cyfhel is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Cyfhel is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  --------------------------------------------------------------------
+ */
+
+#include <cassert>
+
+#include "CyCtxtMatrix.h"
+
+using namespace std;
+
+
+/******CONSTRUCTOR WITH PARAMETERS******/
+/*
+	@name: CyCtxtMatrix
+	@description: Create an encrypted matrix without any column: the columns are then set with setColumn
+	              (see Cyfhel::encryptMatrix).
+
+	@param: The constructor takes three mandatory parameters: a long, a long and a long.
+	-param1: the number of rows.
+	-param2: the number of columns.
+	-param3: the number of rows in each CyCtxt, i.e. the number of slots of the scheme.
+*/
+CyCtxtMatrix::CyCtxtMatrix(long rows, long cols, long tileRows):m_rows(rows), m_cols(cols), m_tileRows(tileRows), m_columns(cols) {
+	assert(m_rows > 0 && m_cols > 0 && m_tileRows > 0);
+}
+
+
+/******IMPLEMENTATION OF GETTERS******/
+/*
+	@name: getm_rows
+	@description: Getter of attribute m_rows. It corresponds to the number of rows of the matrix.
+
+	@param: null.
+*/
+long CyCtxtMatrix::getm_rows() const {
+	return m_rows;
+}
+
+/*
+	@name: getm_cols
+	@description: Getter of attribute m_cols. It corresponds to the number of columns of the matrix.
+
+	@param: null.
+*/
+long CyCtxtMatrix::getm_cols() const {
+	return m_cols;
+}
+
+/*
+	@name: getm_tileRows
+	@description: Getter of attribute m_tileRows. It corresponds to the number of rows encrypted in each CyCtxt.
+
+	@param: null.
+*/
+long CyCtxtMatrix::getm_tileRows() const {
+	return m_tileRows;
+}
+
+
+/******IMPLEMENTATION OF PUBLIC METHODS******/
+/*
+	@name: rowTiles
+	@description: Number of CyCtxt of each column: ceil(rows/tileRows).
+
+	@param: null.
+*/
+long CyCtxtMatrix::rowTiles() const {
+	return (m_rows + m_tileRows - 1)/m_tileRows;
+}
+
+/*
+	@name: tileSize
+	@description: Number of rows of the tile t, tileRows except for the last tile.
+
+	@param: The method tileSize takes one mandatory parameter: a long.
+	-param1: the index of the tile.
+*/
+long CyCtxtMatrix::tileSize(long t) const {
+	return min(m_tileRows, m_rows - t*m_tileRows);
+}
+
+/*
+	@name: setColumn
+	@description: Set the tiles of the column j.
+
+	@param: The method setColumn takes two mandatory parameters: a long and a vector of CyCtxt.
+	-param1: the index of the column.
+	-param2: the rowTiles() tiles of the column, the first one holding the first rows.
+*/
+void CyCtxtMatrix::setColumn(long j, vector<CyCtxt> const& tiles){
+	assert(j >= 0 && j < m_cols && (long) tiles.size() == rowTiles());
+	m_columns[j] = tiles;
+}
+
+/*
+	@name: isComplete
+	@description: Tell if all the columns are set.
+
+	@param: null.
+*/
+bool CyCtxtMatrix::isComplete() const {
+	for(long j=0; j<m_cols; j++)
+	{
+		if((long) m_columns[j].size() != rowTiles())
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+	@name: column
+	@description: The tiles of the column j.
+
+	@param: The method column takes one mandatory parameter: a long.
+	-param1: the index of the column.
+*/
+vector<CyCtxt>& CyCtxtMatrix::column(long j){
+	return m_columns[j];
+}
+
+vector<CyCtxt> const& CyCtxtMatrix::column(long j) const {
+	return m_columns[j];
+}
+
+/*
+	@name: tile
+	@description: The CyCtxt holding the rows t*tileRows, ..., of the column j.
+
+	@param: The method tile takes two mandatory parameters: a long and a long.
+	-param1: the index of the column.
+	-param2: the index of the tile.
+*/
+CyCtxt& CyCtxtMatrix::tile(long j, long t){
+	return m_columns[j][t];
+}
+
+CyCtxt const& CyCtxtMatrix::tile(long j, long t) const {
+	return m_columns[j][t];
+}
+
+
+/******STREAM OPERATORS OVERLOAD******/
+std::ostream& operator<<(std::ostream& flux, CyCtxtMatrix const& matrix){
+	flux << matrix.getm_rows() << "x" << matrix.getm_cols() << " encrypted matrix, " << matrix.rowTiles()*matrix.getm_cols()
+	     << " CyCtxt of " << matrix.getm_tileRows() << " slots";
+	return flux;
+}
@@ -0,0 +1,56 @@
+#ifndef DEF_CYCTXTMATRIX
+#define DEF_CYCTXTMATRIX
+
+#include <vector>
+#include <iostream>
+
+#include "CyCtxt.h"
+
+//The CyCtxtMatrix Class: an encrypted matrix of rows x cols values, tiled across several CyCtxt. Each column is
+//encrypted in ceil(rows/tileRows) CyCtxt: the tile t of the column j holds the rows t*tileRows, ..., (t+1)*tileRows-1
+//in its first slots. tileRows is the number of slots of the scheme.
+//The products (see Cyfhel::matMul) work column by column: a column of the result is a sum of columns of the left
+//matrix multiplied by the entries of a column of the right one, so the output columns are computed concurrently.
+class CyCtxtMatrix {
+
+ private:
+
+	/******ATTRIBUTES******/
+	long m_rows, m_cols;// Size of the matrix
+	long m_tileRows;// Nº of rows in each CyCtxt
+	std::vector< std::vector<CyCtxt> > m_columns;// m_columns[j][t]: tile t of the column j
+
+
+ public:
+
+	/******CONSTRUCTOR WITH PARAMETERS******/
+	CyCtxtMatrix(long rows, long cols, long tileRows);
+
+	/******GETTERS******/
+	long getm_rows() const;//Getter of attribute m_rows
+
+	long getm_cols() const;//Getter of attribute m_cols
+
+	long getm_tileRows() const;//Getter of attribute m_tileRows
+
+	/******PROTOTYPES OF PUBLIC METHODS******/
+	long rowTiles() const;// Nº of CyCtxt per column
+
+	long tileSize(long t) const;// Nº of rows of the tile t
+
+	void setColumn(long j, std::vector<CyCtxt> const& tiles);// Set the tiles of the column j
+
+	bool isComplete() const;// True once all the columns are set
+
+	std::vector<CyCtxt>& column(long j);// The tiles of the column j
+
+	std::vector<CyCtxt> const& column(long j) const;// The tiles of the column j
+
+	CyCtxt& tile(long j, long t);// The tile t of the column j
+
+	CyCtxt const& tile(long j, long t) const;// The tile t of the column j
+};
+
+std::ostream& operator<<(std::ostream& flux, CyCtxtMatrix const& matrix);
+
+#endif
@@ -0,0 +1,287 @@
+/*
+ * CyExecutionPolicy
+ * --------------------------------------------------------------------
+ *  Split of the threads between the ciphertext level (operations run
+ *  concurrently) and the prime level (NTL thread pool used by HElib
+ *  inside each operation), set globally or per Cyfhel object.
+ *  --------------------------------------------------------------------
+ *  Author: Remy AUDA & Alexandre AUDA
+ *  Date: 19/10/2026
+ *  --------------------------------------------------------------------
+ *  License: GNU GPL v3
+ *
+ *  Cyfhel is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Cyfhel is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  --------------------------------------------------------------------
+ */
+
+#include <mutex>
+#include <thread>
+#include <algorithm>
+
+#include "CyExecutionPolicy.h"
+
+using namespace std;
+
+// The global policy. Until setGlobal is called, getGlobal returns one operation at a time with all the cores inside it,
+// but Cyfhel does not apply it.
+static mutex globalPolicyMutex;
+static bool globalPolicyIsSet = false;
+static CyExecutionPolicy& globalPolicy(){
+	static CyExecutionPolicy policy(1, 0);
+	return policy;
+}
+
+// True for the threads of a pool, which keep the split of their pool.
+static thread_local bool tls_isPinned = false;
+
+
+/******CONSTRUCTOR WITH PARAMETERS******/
+/*
+	@name: CyExecutionPolicy
+	@description: Create a policy.
+
+	@param: The constructor takes three optional parameters: a long, a long and a long.
+	-param1 (optional)(Default: 1): the number of ciphertext operations run concurrently. If 0, use all the hardware threads.
+	-param2 (optional)(Default: 0): the number of NTL threads inside each operation. If 0, the hardware threads are
+	        divided by the number of outer threads (at least 1).
+	-param3 (optional)(Default: FHE_MIN_PARALLEL_WORK): the minimal work per inner thread, in coefficients.
+*/
+CyExecutionPolicy::CyExecutionPolicy(long outerThreads, long innerThreads, long minParallelWork):m_outerThreads(outerThreads), m_innerThreads(innerThreads), m_minParallelWork(minParallelWork) {
+	if(m_outerThreads <= 0)
+	{
+		m_outerThreads = hardwareThreads();
+	}
+	if(m_innerThreads <= 0)
+	{
+		m_innerThreads = max(1L, hardwareThreads()/m_outerThreads);
+	}
+	if(m_minParallelWork <= 0)
+	{
+		m_minParallelWork = 1;
+	}
+}
+
+
+/******IMPLEMENTATION OF GETTERS******/
+/*
+	@name: getm_outerThreads
+	@description: Getter of attribute m_outerThreads. It corresponds to the number of ciphertext operations run concurrently.
+
+	@param: null.
+*/
+long CyExecutionPolicy::getm_outerThreads() const {
+	return m_outerThreads;
+}
+
+/*
+	@name: getm_innerThreads
+	@description: Getter of attribute m_innerThreads. It corresponds to the number of NTL threads used inside each operation.
+
+	@param: null.
+*/
+long CyExecutionPolicy::getm_innerThreads() const {
+	return m_innerThreads;
+}
+
+/*
+	@name: getm_minParallelWork
+	@description: Getter of attribute m_minParallelWork. It corresponds to the minimal work (in coefficients) per inner thread.
+
+	@param: null.
+*/
+long CyExecutionPolicy::getm_minParallelWork() const {
+	return m_minParallelWork;
+}
+
+
+/******IMPLEMENTATION OF SETTERS******/
+/*
+	@name: setm_minParallelWork
+	@description: Setter of attribute m_minParallelWork.
+
+	@param: The method setm_minParallelWork takes one mandatory parameter: a long.
+	-param1: the minimal work per inner thread (at least 1).
+*/
+void CyExecutionPolicy::setm_minParallelWork(long minParallelWork){
+	m_minParallelWork = max(1L, minParallelWork);
+}
+
+
+/******IMPLEMENTATION OF PUBLIC METHODS******/
+/*
+	@name: applyToCurrentThread
+	@description: Give to the calling thread an NTL thread pool of m_innerThreads threads and set its HElib
+	              threshold to m_minParallelWork. The NTL pool is only rebuilt if its size changes.
+	              A thread pinned by a pool keeps its split: the call does nothing, unless pin is true.
+
+	@param: The method applyToCurrentThread takes one optional parameter: a bool.
+	-param1 (optional)(Default: false): pin the calling thread to this policy.
+*/
+void CyExecutionPolicy::applyToCurrentThread(bool pin) const {
+	if(tls_isPinned && !pin)
+	{
+		return;
+	}
+	NTL::BasicThreadPool *pool = NTL::GetThreadPool();
+	long current = pool ? pool->NumThreads() : 1;
+	if(current != m_innerThreads && !(pool && pool->active()))
+	{
+		if(m_innerThreads > 1)
+		{
+			NTL::SetNumThreads(m_innerThreads);
+		}
+		else
+		{
+			NTL::ResetThreadPool();
+		}
+	}
+	setMinParallelWork(m_minParallelWork);
+	if(pin)
+	{
+		tls_isPinned = true;
+	}
+}
+
+/*
+	@name: sequential
+	@description: Policy using a single thread.
+
+	@param: null.
+*/
+CyExecutionPolicy CyExecutionPolicy::sequential(){
+	return CyExecutionPolicy(1, 1);
+}
+
+/*
+	@name: innerOnly
+	@description: Policy running one operation at a time with all the threads inside it.
+	              It is the best choice for a single large computation.
+
+	@param: The method innerOnly takes one optional parameter: a long.
+	-param1 (optional)(Default: 0): the number of threads. If 0, use all the hardware threads.
+*/
+CyExecutionPolicy CyExecutionPolicy::innerOnly(long threads){
+	return CyExecutionPolicy(1, threads <= 0 ? hardwareThreads() : threads);
+}
+
+/*
+	@name: outerOnly
+	@description: Policy running many operations concurrently with a single thread each.
+	              It is the best choice for many small independent operations (e.g. one per request).
+
+	@param: The method outerOnly takes one optional parameter: a long.
+	-param1 (optional)(Default: 0): the number of threads. If 0, use all the hardware threads.
+*/
+CyExecutionPolicy CyExecutionPolicy::outerOnly(long threads){
+	return CyExecutionPolicy(threads <= 0 ? hardwareThreads() : threads, 1);
+}
+
+/*
+	@name: split
+	@description: Policy running outerThreads operations concurrently, each with totalThreads/outerThreads NTL threads.
+
+	@param: The method split takes one mandatory parameter and one optional parameter: a long and a long.
+	-param1: the number of operations run concurrently.
+	-param2 (optional)(Default: 0): the total number of threads. If 0, use all the hardware threads.
+*/
+CyExecutionPolicy CyExecutionPolicy::split(long outerThreads, long totalThreads){
+	if(totalThreads <= 0)
+	{
+		totalThreads = hardwareThreads();
+	}
+	outerThreads = max(1L, min(outerThreads, totalThreads));
+	return CyExecutionPolicy(outerThreads, max(1L, totalThreads/outerThreads));
+}
+
+/*
+	@name: getGlobal
+	@description: Get the global policy, used by the Cyfhel objects which do not have their own.
+
+	@param: null.
+*/
+CyExecutionPolicy CyExecutionPolicy::getGlobal(){
+	lock_guard<mutex> lock(globalPolicyMutex);
+	return globalPolicy();
+}
+
+/*
+	@name: setGlobal
+	@description: Change the global policy. The calling thread applies it immediately, the other threads
+	              apply it at their next Cyfhel operation.
+
+	@param: The method setGlobal takes one mandatory parameter: a CyExecutionPolicy.
+	-param1: the new global policy.
+*/
+void CyExecutionPolicy::setGlobal(CyExecutionPolicy const& policy){
+	{
+		lock_guard<mutex> lock(globalPolicyMutex);
+		globalPolicy() = policy;
+		globalPolicyIsSet = true;
+	}
+	policy.applyToCurrentThread();
+}
+
+/*
+	@name: resetGlobal
+	@description: Remove the global policy: the Cyfhel objects without their own policy stop changing the NTL thread pools.
+
+	@param: null.
+*/
+void CyExecutionPolicy::resetGlobal(){
+	lock_guard<mutex> lock(globalPolicyMutex);
+	globalPolicy() = CyExecutionPolicy(1, 0);
+	globalPolicyIsSet = false;
+}
+
+/*
+	@name: hasGlobal
+	@description: Tell if a global policy was set with setGlobal.
+
+	@param: null.
+*/
+bool CyExecutionPolicy::hasGlobal(){
+	lock_guard<mutex> lock(globalPolicyMutex);
+	return globalPolicyIsSet;
+}
+
+/*
+	@name: hardwareThreads
+	@description: Number of hardware threads of the machine.
+
+	@param: null.
+
+	@return: Return a long, at least 1.
+*/
+long CyExecutionPolicy::hardwareThreads(){
+	long n = thread::hardware_concurrency();
+	return (n > 0) ? n : 1;
+}
+
+/*
+	@name: isCurrentThreadPinned
+	@description: Tell if the calling thread was pinned to a policy by applyToCurrentThread(true).
+
+	@param: null.
+*/
+bool CyExecutionPolicy::isCurrentThreadPinned(){
+	return tls_isPinned;
+}
+
+
+/******STREAM OPERATORS OVERLOAD******/
+std::ostream& operator<<(std::ostream& flux, CyExecutionPolicy const& policy){
+	flux << "outer=" << policy.getm_outerThreads() << ", inner=" << policy.getm_innerThreads()
+	     << ", minParallelWork=" << policy.getm_minParallelWork();
+	return flux;
+}
@@ -0,0 +1,68 @@
+#ifndef DEF_CYEXECUTIONPOLICY
+#define DEF_CYEXECUTIONPOLICY
+
+#include <iostream>
+
+#include <NTL/BasicThreadPool.h>
+
+#include "multicore.h"
+
+//The CyExecutionPolicy Class: how the threads of the machine are split between the outer level (ciphertext operations
+//or requests run concurrently, e.g. by a CyWorkStealingPool) and the inner level (the NTL thread pool used by HElib
+//inside one operation for the primes of a DoubleCRT, the rows of a matmul...). outerThreads * innerThreads should not
+//exceed the number of cores. minParallelWork is the smallest amount of work (in coefficients) for which a DoubleCRT
+//loop uses one more inner thread, so tiny IndexSets are not dispatched to the NTL pool.
+//There is one global policy, and each Cyfhel object can override it with its own. As long as neither is set, Cyfhel
+//leaves the NTL thread pool of the calling thread as it is (e.g. as set by NTL::SetNumThreads).
+class CyExecutionPolicy {
+
+ private:
+
+	/******ATTRIBUTES******/
+	long m_outerThreads;// Nº of ciphertext operations run concurrently
+	long m_innerThreads;// Nº of NTL threads used inside each operation
+	long m_minParallelWork;// Minimal work per inner thread
+
+
+ public:
+
+	/******CONSTRUCTOR WITH PARAMETERS******/
+	explicit CyExecutionPolicy(long outerThreads = 1, long innerThreads = 0, long minParallelWork = FHE_MIN_PARALLEL_WORK);
+
+	/******GETTERS******/
+	long getm_outerThreads() const;//Getter of attribute m_outerThreads
+
+	long getm_innerThreads() const;//Getter of attribute m_innerThreads
+
+	long getm_minParallelWork() const;//Getter of attribute m_minParallelWork
+
+	/******SETTERS******/
+	void setm_minParallelWork(long minParallelWork);//Setter of attribute m_minParallelWork
+
+	/******PROTOTYPES OF PUBLIC METHODS******/
+	void applyToCurrentThread(bool pin = false) const;// Set the NTL pool and the HElib threshold of the calling thread
+
+	static CyExecutionPolicy sequential();// 1 outer thread, 1 inner thread
+
+	static CyExecutionPolicy innerOnly(long threads = 0);// All the threads inside each operation (HElib default)
+
+	static CyExecutionPolicy outerOnly(long threads = 0);// All the threads on concurrent operations, none inside
+
+	static CyExecutionPolicy split(long outerThreads, long totalThreads = 0);// Split totalThreads between both levels
+
+	static CyExecutionPolicy getGlobal();// The global policy
+
+	static void setGlobal(CyExecutionPolicy const& policy);// Change the global policy
+
+	static void resetGlobal();// Back to no global policy
+
+	static bool hasGlobal();// True if a global policy was set
+
+	static long hardwareThreads();// Nº of hardware threads (at least 1)
+
+	static bool isCurrentThreadPinned();// True if the calling thread was pinned to a policy (threads of a pool)
+};
+
+std::ostream& operator<<(std::ostream& flux, CyExecutionPolicy const& policy);
+
+#endif
@@ -0,0 +1,472 @@
+/*
+ * CyMatrix
+ * --------------------------------------------------------------------
+ *  Plaintext matrix multiplied by encrypted vectors, with the constants
+ *  of its diagonals computed once (and optionally kept in a file mapped
+ *  in memory) for all the products.
+ *  --------------------------------------------------------------------
+ *  Author: Remy AUDA & Alexandre AUDA
+ *  Date: 19/10/2026
+ *  --------------------------------------------------------------------
+ *  License: GNU GPL v3
+ *
+ *  Cyfhel is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Cyfhel is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  --------------------------------------------------------------------
+ */
+
+#include <cmath>
+#include <cassert>
+#include <fstream>
+#include <sstream>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "binio.h"
+#include "CyMatrix.h"
+
+using namespace std;
+
+// First long of the cache files.
+static const long cacheFileMagic = 0x4379436163686532L;
+
+// The HElib view of a CyMatrix. HElib multiplies row vectors (v * A), so A[i][j] = M[j][i].
+template<class type> class CyMatMul : public MatMul<type> {
+ public:
+	PA_INJECT(type)
+
+	CyMatMul(EncryptedArray const& ea, CyMatrix const& matrix): MatMul<type>(ea), m_matrix(matrix) {}
+
+	virtual bool get(RX& out, long i, long j) const {
+		long value = m_matrix.entry(j, i);
+		if(value == 0)
+		{
+			return true;
+		}
+		conv(out, value);
+		return false;
+	}
+
+ private:
+	CyMatrix const& m_matrix;
+};
+
+
+/******CONSTRUCTOR WITH PARAMETERS******/
+/*
+	@name: CyMatrix
+	@description: Create a matrix for the CyCtxt of encryptedArray. The entries are reduced mod p^r. Nothing is
+	              precomputed before the first product.
+
+	@param: The constructor takes two mandatory parameters and three optional parameters: an EncryptedArray, a vector<vector<long>>,
+	        a Variant, a string and a MatMulCostModel.
+	-param1: the EncryptedArray of the CyCtxt (see Cyfhel::getm_encryptedArray).
+	-param2: the entries of M, row by row. M has at most nslots rows and columns, the missing entries are 0.
+	-param3 (optional)(Default: automatic): dense, sparse, or automatic to choose with the cost model of planMatMul.
+	-param4 (optional)(Default: ""): the cache file of the constants, "" for none.
+	-param5 (optional)(Default: MatMulCostModel()): the costs used by planMatMul, see Cyfhel::getm_matMulCostModel.
+*/
+CyMatrix::CyMatrix(EncryptedArray const& encryptedArray, vector< vector<long> > const& data, Variant variant, string const& cacheFile,
+                   MatMulCostModel const& model):
+	m_data(data), m_rows(data.size()), m_cols(0), m_encryptedArray(encryptedArray), m_variant(variant), m_nonZeroDiagonals(0),
+	m_cacheFile(cacheFile), m_isCacheLoaded(false) {
+	long nslots = m_encryptedArray.size();
+	long p2r = m_encryptedArray.getAlMod().getPPowR();
+	for(long i=0; i<m_rows; i++)
+	{
+		m_cols = max(m_cols, (long) m_data[i].size());
+		for(unsigned long j=0; j<m_data[i].size(); j++)
+		{
+			m_data[i][j] = mcMod(m_data[i][j], p2r);
+		}
+	}
+	assert(m_rows <= nslots && m_cols <= nslots);
+
+	switch(m_encryptedArray.getTag())
+	{
+		case PA_GF2_tag:
+			m_matMul.reset(new CyMatMul<PA_GF2>(m_encryptedArray, *this));
+			break;
+		case PA_zz_p_tag:
+			m_matMul.reset(new CyMatMul<PA_zz_p>(m_encryptedArray, *this));
+			break;
+		default:
+			throw std::logic_error("CyMatrix: neither PA_GF2 nor PA_zz_p");
+	}
+
+	// The scan of the planner counts the non-zero diagonals (the diagonal d holds the entries M[i][k] with i-k = d mod nslots).
+	MatMulPlan const& plan = planMatMul(*m_matMul, model);
+	m_nonZeroDiagonals = plan.nonZeroDiags;
+	if(m_variant == automatic)
+	{
+		// The cheapest of the sparse and the baby-step/giant-step products for the rotations of this hypercube.
+		m_variant = (plan.cost[matMulSparse] <= plan.cost[matMulBSGS]) ? sparse : dense;
+	}
+}
+
+
+/******DESTRUCTOR******/
+CyMatrix::~CyMatrix(){
+
+}
+
+
+/******IMPLEMENTATION OF GETTERS******/
+/*
+	@name: getm_rows
+	@description: Getter of attribute m_rows. It corresponds to the number of rows of M.
+
+	@param: null.
+*/
+long CyMatrix::getm_rows() const {
+	return m_rows;
+}
+
+/*
+	@name: getm_cols
+	@description: Getter of attribute m_cols. It corresponds to the number of columns of M.
+
+	@param: null.
+*/
+long CyMatrix::getm_cols() const {
+	return m_cols;
+}
+
+/*
+	@name: getm_variant
+	@description: Getter of attribute m_variant. It corresponds to the product used: dense or sparse.
+
+	@param: null.
+*/
+CyMatrix::Variant CyMatrix::getm_variant() const {
+	return m_variant;
+}
+
+/*
+	@name: getm_nonZeroDiagonals
+	@description: Getter of attribute m_nonZeroDiagonals. It corresponds to the number of diagonals of M (wrapped
+	              around the nslots slots) with a non-zero entry.
+
+	@param: null.
+*/
+long CyMatrix::getm_nonZeroDiagonals() const {
+	return m_nonZeroDiagonals;
+}
+
+/*
+	@name: getm_cacheFile
+	@description: Getter of attribute m_cacheFile.
+
+	@param: null.
+*/
+string CyMatrix::getm_cacheFile() const {
+	return m_cacheFile;
+}
+
+
+/******IMPLEMENTATION OF PRIVATE METHODS******/
+/*
+	@name: fingerprint
+	@description: Private method which hashes the context, the polynome G of the slots, the variant and the entries of M.
+	              A cache file is only used for the same fingerprint.
+
+	@param: null.
+*/
+unsigned long CyMatrix::fingerprint() const {
+	unsigned long hash = contextFingerprint(m_encryptedArray.getContext());
+
+	ostringstream G;
+	if(m_encryptedArray.getTag() == PA_GF2_tag)
+	{
+		G << m_encryptedArray.getDerived(PA_GF2()).getG();
+	}
+	else
+	{
+		G << m_encryptedArray.getDerived(PA_zz_p()).getG();
+	}
+	string g = G.str();
+	hash = fnv1a(g.data(), g.size(), hash);
+
+	long header[3] = { (long) m_variant, m_rows, m_cols };
+	hash = fnv1a(header, sizeof(header), hash);
+	for(long i=0; i<m_rows; i++)
+	{
+		long size = m_data[i].size();
+		hash = fnv1a(&size, sizeof(size), hash);
+		if(size > 0)
+		{
+			hash = fnv1a(m_data[i].data(), size*sizeof(long), hash);
+		}
+	}
+	return hash;
+}
+
+/*
+	@name: buildCache
+	@description: Private method which builds the constants of the diagonals, run once before the first product.
+	              With a cache file, the constants are read from it, or computed (as zzX) and written to it.
+	              They are then converted to DoubleCRT, the form used by the products.
+
+	@param: null.
+*/
+void CyMatrix::buildCache(){
+	if(!m_cacheFile.empty())
+	{
+		m_isCacheLoaded = loadCache(m_cacheFile);
+		if(!m_isCacheLoaded)
+		{
+			if(m_variant == sparse)
+			{
+				buildCache4MatMul_sparse(*m_matMul, cachezzX);
+			}
+			else
+			{
+				buildCache4MatMul_bsgs(*m_matMul, cachezzX);
+			}
+			saveCache(m_cacheFile);
+		}
+	}
+	// Build the DoubleCRT cache, or upgrade the zzX one.
+	if(m_variant == sparse)
+	{
+		buildCache4MatMul_sparse(*m_matMul, cacheDCRT);
+	}
+	else
+	{
+		buildCache4MatMul_bsgs(*m_matMul, cacheDCRT);
+	}
+}
+
+
+/******IMPLEMENTATION OF PUBLIC METHODS******/
+/*
+	@name: multiply
+	@description: Replace cyctxt, an encryption of the vector x, by an encryption of M*x. The first call builds the
+	              constants of the diagonals; the next ones, possibly from several threads, only read them.
+	              The product uses one level (multiplication by constants).
+
+	@param: The method multiply takes one mandatory parameter: a CyCtxt.
+	-param1: the CyCtxt to multiply, encrypted with the EncryptedArray of the matrix.
+*/
+void CyMatrix::multiply(CyCtxt& cyctxt){
+	call_once(m_cacheFlag, &CyMatrix::buildCache, this);
+	cyctxt.recryptIfNeeded();
+	if(m_variant == sparse)
+	{
+		matMul_sparse(cyctxt, *m_matMul);
+	}
+	else
+	{
+		matMul_bsgs(cyctxt, *m_matMul);
+	}
+}
+
+/*
+	@name: entry
+	@description: Entry of M, reduced mod p^r.
+
+	@param: The method entry takes two mandatory parameters: a long and a long.
+	-param1: the row.
+	-param2: the column.
+
+	@return: Return M[i][j], or 0 if (i, j) is outside of the entries given to the constructor.
+*/
+long CyMatrix::entry(long i, long j) const {
+	if(i < 0 || i >= m_rows || j < 0 || j >= (long) m_data[i].size())
+	{
+		return 0;
+	}
+	return m_data[i][j];
+}
+
+/*
+	@name: hasEntries
+	@description: Tell if data are the entries of M, as given to the constructor (compared mod p^r).
+
+	@param: The method hasEntries takes one mandatory parameter: a vector<vector<long>>.
+	-param1: the entries to compare, row by row.
+
+	@return: Return true if data has the rows of M, of the same sizes and with the same entries mod p^r.
+*/
+bool CyMatrix::hasEntries(vector< vector<long> > const& data) const {
+	if((long) data.size() != m_rows)
+	{
+		return false;
+	}
+	long p2r = m_encryptedArray.getAlMod().getPPowR();
+	for(long i=0; i<m_rows; i++)
+	{
+		if(data[i].size() != m_data[i].size())
+		{
+			return false;
+		}
+		for(unsigned long j=0; j<data[i].size(); j++)
+		{
+			if(mcMod(data[i][j], p2r) != m_data[i][j])
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/*
+	@name: hasCache
+	@description: Tell if the constants of the diagonals are built (as DoubleCRT).
+
+	@param: null.
+*/
+bool CyMatrix::hasCache() const {
+	return m_matMul->hasDCRTcache();
+}
+
+/*
+	@name: isCacheLoaded
+	@description: Tell if the constants were read from the cache file rather than computed.
+
+	@param: null.
+*/
+bool CyMatrix::isCacheLoaded() const {
+	return m_isCacheLoaded;
+}
+
+/*
+	@name: saveCache
+	@description: Write the constants of the diagonals (as zzX) in a binary file, with the fingerprint of the matrix.
+	              The zzX constants are only kept for a matrix with a cache file (see buildCache): a matrix without cache
+	              file only keeps the DoubleCRT ones, which are not written.
+
+	@param: The method saveCache takes one mandatory parameter: a string.
+	-param1: the name of the file.
+
+	@return: Return a bool which is equal to 1 if all ok and 0 otherwise.
+*/
+bool CyMatrix::saveCache(string const& fileName){
+	CachedzzxMatrix* zcp;
+	CachedDCRTMatrix* dcp;
+	m_matMul->getCache(&zcp, &dcp);
+	if(zcp == nullptr)
+	{
+		std::cerr << "CyMatrix::saveCache: no zzX constants to save." << endl;
+		return 0;
+	}
+
+	// Write in a temporary file, renamed at the end, so that a reader never maps a partial file.
+	string tmpName = fileName + ".tmp";
+	ofstream file(tmpName.c_str(), ofstream::out|ofstream::trunc|ofstream::binary);
+	if(!file.is_open())
+	{
+		std::cerr << "CyMatrix::saveCache: cannot open " << tmpName << "." << endl;
+		return 0;
+	}
+	write_raw_long(file, cacheFileMagic);
+	write_raw_long(file, (long) fingerprint());
+	write_raw_long(file, zcp->length());
+	for(long i=0; i<zcp->length(); i++)
+	{
+		if((*zcp)[i] == nullptr)
+		{
+			write_raw_long(file, -1);// Zero diagonal
+		}
+		else
+		{
+			write_raw_vec_long(file, *(*zcp)[i]);
+		}
+	}
+	file.close();
+	if(!file || rename(tmpName.c_str(), fileName.c_str()) != 0)
+	{
+		std::cerr << "CyMatrix::saveCache: cannot write " << fileName << "." << endl;
+		remove(tmpName.c_str());
+		return 0;
+	}
+	return 1;
+}
+
+/*
+	@name: loadCache
+	@description: Read the constants of the diagonals from a file written by saveCache. The file is mapped in memory and the
+	              constants are copied from it. Nothing is changed if the file is missing, truncated, or was written for
+	              another matrix or another context. Must not run at the same time as a product.
+
+	@param: The method loadCache takes one mandatory parameter: a string.
+	-param1: the name of the file.
+
+	@return: Return a bool which is equal to 1 if the constants were read and 0 otherwise.
+*/
+bool CyMatrix::loadCache(string const& fileName){
+	int fd = open(fileName.c_str(), O_RDONLY);
+	if(fd < 0)
+	{
+		return 0;
+	}
+	struct stat st;
+	if(fstat(fd, &st) != 0 || st.st_size < (off_t) (3*sizeof(long)))
+	{
+		close(fd);
+		return 0;
+	}
+	void* addr = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(addr == MAP_FAILED)
+	{
+		return 0;
+	}
+
+	long const* data = static_cast<long const*>(addr);
+	long size = st.st_size/sizeof(long);
+	long pos = 0;
+	bool isValid = (data[pos++] == cacheFileMagic) && ((unsigned long) data[pos++] == fingerprint());
+	long n = isValid ? data[pos++] : 0;
+	isValid = isValid && (n == m_encryptedArray.size());
+
+	unique_ptr<CachedzzxMatrix> cache(new CachedzzxMatrix(NTL::INIT_SIZE, n));
+	for(long i=0; isValid && i<n; i++)
+	{
+		long length = (pos < size) ? data[pos++] : -2;
+		if(length == -1)// Zero diagonal
+		{
+			continue;
+		}
+		if(length < 0 || length > size-pos)
+		{
+			isValid = false;
+			break;
+		}
+		zzX* poly = new zzX(NTL::INIT_SIZE, length);
+		copy(data+pos, data+pos+length, poly->elts());
+		(*cache)[i].reset(poly);
+		pos += length;
+	}
+	munmap(addr, st.st_size);
+
+	if(!isValid)
+	{
+		std::cerr << "CyMatrix::loadCache: " << fileName << " is not a valid cache for this matrix." << endl;
+		return 0;
+	}
+	m_matMul->installzzxcache(cache);
+	return 1;
+}
+
+
+/******STREAM OPERATORS OVERLOAD******/
+std::ostream& operator<<(std::ostream& flux, CyMatrix const& matrix){
+	flux << matrix.getm_rows() << "x" << matrix.getm_cols() << " matrix, " << matrix.getm_nonZeroDiagonals()
+	     << " non-zero diagonals, " << (matrix.getm_variant() == CyMatrix::sparse ? "sparse" : "dense") << " product";
+	return flux;
+}
@@ -0,0 +1,90 @@
+#ifndef DEF_CYMATRIX
+#define DEF_CYMATRIX
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <iostream>
+
+#include "FHE.h"
+#include "EncryptedArray.h"
+#include "matmul.h"
+
+#include "CyCtxt.h"
+
+//The CyMatrix Class: a plaintext matrix M multiplied by encrypted vectors (y = M*x, the vector x in the first slots of a
+//CyCtxt). The constants of the diagonals of M are computed once, at the first product, and kept as DoubleCRT for all
+//the next products, which only read them: a CyMatrix can be used by several threads at the same time.
+//The product is dense (baby-step/giant-step, about 2*sqrt(nslots) rotations, the giant steps run in parallel) or sparse
+//(one rotation per non-zero diagonal). With automatic, the variant is the cheapest one for the cost model of planMatMul.
+//If a cache file is given, the constants are read from it (mapped in memory) when it was written for the same context
+//and the same matrix, and written to it after the first product otherwise.
+class CyMatrix {
+
+ public:
+
+	enum Variant { automatic = 0, dense = 1, sparse = 2 };
+
+ private:
+
+	/******ATTRIBUTES******/
+	std::vector< std::vector<long> > m_data;// Entries of M, row by row
+	long m_rows, m_cols;// Size of M
+	EncryptedArray const& m_encryptedArray;// Array of the slots of the CyCtxt
+	std::unique_ptr<MatMulBase> m_matMul;// HElib view of M (transposed: HElib multiplies row vectors)
+	Variant m_variant;// Dense or sparse, never automatic
+	long m_nonZeroDiagonals;// Nº of non-zero diagonals of M, as seen by the sparse product
+	std::string m_cacheFile;// Cache file of the constants ("" for none)
+	std::once_flag m_cacheFlag;// Build (and save) the constants once
+	bool m_isCacheLoaded;// True if the constants were read from m_cacheFile
+
+	/******PROTOTYPES OF PRIVATE METHODS******/
+	unsigned long fingerprint() const;// Hash of the context, the variant and the entries of M
+
+	void buildCache();// Build the constants, from m_cacheFile if possible
+
+	/******DISABLE COPY******/
+	CyMatrix(CyMatrix const&);
+	CyMatrix& operator=(CyMatrix const&);
+
+
+ public:
+
+	/******CONSTRUCTOR WITH PARAMETERS******/
+	CyMatrix(EncryptedArray const& encryptedArray, std::vector< std::vector<long> > const& data, Variant variant = automatic,
+	         std::string const& cacheFile = "", MatMulCostModel const& model = MatMulCostModel());
+
+	/******DESTRUCTOR******/
+	virtual ~CyMatrix();
+
+	/******GETTERS******/
+	long getm_rows() const;//Getter of attribute m_rows
+
+	long getm_cols() const;//Getter of attribute m_cols
+
+	Variant getm_variant() const;//Getter of attribute m_variant
+
+	long getm_nonZeroDiagonals() const;//Getter of attribute m_nonZeroDiagonals
+
+	std::string getm_cacheFile() const;//Getter of attribute m_cacheFile
+
+	/******PROTOTYPES OF PUBLIC METHODS******/
+	void multiply(CyCtxt& cyctxt);// cyctxt = M * cyctxt
+
+	long entry(long i, long j) const;// M[i][j], 0 outside of M
+
+	bool hasEntries(std::vector< std::vector<long> > const& data) const;// True if data are the entries of M (mod p^r)
+
+	bool hasCache() const;// True once the constants are built
+
+	bool isCacheLoaded() const;// True if the constants were read from the cache file
+
+	bool saveCache(std::string const& fileName);// Write the constants in fileName
+
+	bool loadCache(std::string const& fileName);// Read the constants from fileName, false if it is not valid for M
+};
+
+std::ostream& operator<<(std::ostream& flux, CyMatrix const& matrix);
+
+#endif
@@ -0,0 +1,766 @@
+/*
+ * CyScheduler
+ * --------------------------------------------------------------------
+ *  Work-stealing thread pool and task graph (circuit) of CyCtxt
+ *  operations. Independent nodes of a circuit are evaluated concurrently
+ *  on the threads of the pool, and each thread keeps a small NTL thread
+ *  pool so that the prime-level parallelism of HElib is still used
+ *  inside each node.
+ *  --------------------------------------------------------------------
+ *  Author: Remy AUDA & Alexandre AUDA
+ *  Date: 19/10/2026
+ *  --------------------------------------------------------------------
+ *  License: GNU GPL v3
+ *
+ *  Cyfhel is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Cyfhel is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  --------------------------------------------------------------------
+ */
+
+#include <chrono>
+
+#include "CyScheduler.h"
+
+using namespace std;
+
+// Pool and index of the pool thread running the current code (0 and -1 outside of any pool).
+static thread_local CyWorkStealingPool* tls_currentPool = 0;
+static thread_local long tls_workerIndex = -1;
+
+
+/******CONSTRUCTOR WITH PARAMETERS******/
+/*
+	@name: CyWorkStealingPool
+	@description: Start the threads of the pool.
+
+	@param: The constructor takes two optional parameters: a long and a long.
+	-param1 (optional)(Default: 0): the number of threads of the pool. If 0, use the number of hardware threads.
+	-param2 (optional)(Default: 0): the number of NTL threads used inside each task. If 0, the hardware threads are
+	        split evenly between the threads of the pool (at least 1 each).
+*/
+CyWorkStealingPool::CyWorkStealingPool(long numberOfThreads, long innerThreads):m_policy(numberOfThreads, innerThreads, CyExecutionPolicy::getGlobal().getm_minParallelWork()), m_queuedTasks(0), m_pendingTasks(0), m_nextWorker(0), m_isStopping(false) {
+	startThreads();
+}
+
+/*
+	@name: CyWorkStealingPool
+	@description: Start policy.getm_outerThreads() threads, each using policy.getm_innerThreads() NTL threads.
+
+	@param: The constructor takes one mandatory parameter: a CyExecutionPolicy.
+	-param1: the policy of the pool.
+*/
+CyWorkStealingPool::CyWorkStealingPool(CyExecutionPolicy const& policy):m_policy(policy), m_queuedTasks(0), m_pendingTasks(0), m_nextWorker(0), m_isStopping(false) {
+	startThreads();
+}
+
+
+/******DESTRUCTOR******/
+CyWorkStealingPool::~CyWorkStealingPool(){
+	{
+		lock_guard<mutex> lock(m_idleMutex);
+		m_isStopping = true;
+	}
+	m_idleCond.notify_all();
+	for(unsigned long i=0; i<m_threads.size(); i++)
+	{
+		m_threads[i].join();
+	}
+}
+
+
+/******IMPLEMENTATION OF GETTERS******/
+/*
+	@name: getm_numberOfThreads
+	@description: Getter of the number of threads of the pool.
+
+	@param: null.
+*/
+long CyWorkStealingPool::getm_numberOfThreads() const {
+	return m_threads.size();
+}
+
+/*
+	@name: getm_innerThreads
+	@description: Getter of the number of NTL threads used inside each task.
+
+	@param: null.
+*/
+long CyWorkStealingPool::getm_innerThreads() const {
+	return m_policy.getm_innerThreads();
+}
+
+/*
+	@name: getm_policy
+	@description: Getter of attribute m_policy.
+
+	@param: null.
+*/
+CyExecutionPolicy CyWorkStealingPool::getm_policy() const {
+	return m_policy;
+}
+
+/*
+	@name: isIdle
+	@description: Tell if all the tasks submitted to the pool are finished.
+
+	@param: null.
+*/
+bool CyWorkStealingPool::isIdle() const {
+	return m_pendingTasks == 0;
+}
+
+
+/******IMPLEMENTATION OF PRIVATE METHODS******/
+/*
+	@name: startThreads
+	@description: Create the deques and start the threads of the pool.
+
+	@param: null.
+*/
+void CyWorkStealingPool::startThreads(){
+	long numberOfThreads = m_policy.getm_outerThreads();
+	for(long i=0; i<numberOfThreads; i++)
+	{
+		m_workers.push_back(unique_ptr<Worker>(new Worker()));
+	}
+	for(long i=0; i<numberOfThreads; i++)
+	{
+		m_threads.push_back(thread(&CyWorkStealingPool::workerLoop, this, i));
+	}
+}
+
+/*
+	@name: workerLoop
+	@description: Main loop of a thread of the pool: run its own tasks, steal tasks from the others, sleep when there is nothing to do.
+
+	@param: The method workerLoop takes one mandatory parameter: a long.
+	-param1: the index of the thread in the pool.
+*/
+void CyWorkStealingPool::workerLoop(long index){
+	tls_currentPool = this;
+	tls_workerIndex = index;
+	// The NTL thread pool is thread local: this one is used by the NTL_EXEC_RANGE loops of the tasks run by this thread.
+	// The thread is pinned, so the Cyfhel objects used in the tasks do not change its split.
+	m_policy.applyToCurrentThread(true);
+
+	function<void()> task;
+	for(;;)
+	{
+		if(popTask(index, task))
+		{
+			runTask(task);
+			continue;
+		}
+		unique_lock<mutex> lock(m_idleMutex);
+		m_idleCond.wait(lock, [this]{ return m_isStopping || m_queuedTasks > 0; });
+		if(m_isStopping && m_queuedTasks == 0)
+		{
+			return;
+		}
+	}
+}
+
+/*
+	@name: popTask
+	@description: Take the last task of the deque of thread index or, if it is empty, steal the first task of another deque.
+
+	@param: The method popTask takes two mandatory parameters: a long and a function.
+	-param1: the index of the thread.
+	-param2: the task found, if any.
+
+	@return: Return true if a task was found, false otherwise.
+*/
+bool CyWorkStealingPool::popTask(long index, function<void()>& task){
+	long n = m_workers.size();
+	{
+		Worker& own = *m_workers[index];
+		lock_guard<mutex> lock(own.m_mutex);
+		if(!own.m_tasks.empty())
+		{
+			task = std::move(own.m_tasks.back());
+			own.m_tasks.pop_back();
+			m_queuedTasks--;
+			return true;
+		}
+	}
+	for(long k=1; k<n; k++)
+	{
+		Worker& victim = *m_workers[(index+k) % n];
+		lock_guard<mutex> lock(victim.m_mutex);
+		if(!victim.m_tasks.empty())
+		{
+			task = std::move(victim.m_tasks.front());
+			victim.m_tasks.pop_front();
+			m_queuedTasks--;
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+	@name: runTask
+	@description: Run a task, keep the first exception and wake up waitAll when the last pending task is done.
+
+	@param: The method runTask takes one mandatory parameter: a function.
+	-param1: the task to run.
+*/
+void CyWorkStealingPool::runTask(function<void()>& task){
+	try
+	{
+		task();
+	}
+	catch(...)
+	{
+		lock_guard<mutex> lock(m_doneMutex);
+		if(!m_firstException)
+		{
+			m_firstException = current_exception();
+		}
+	}
+	task = function<void()>();// Release what the task captured
+	if(--m_pendingTasks == 0)
+	{
+		lock_guard<mutex> lock(m_doneMutex);
+		m_doneCond.notify_all();
+	}
+}
+
+/*
+	@name: runPendingTask
+	@description: Run one queued task (of the own deque of the calling thread, or stolen) on the calling thread.
+	              Used by CyTaskGroup::wait, so that a task waiting for a group keeps its thread busy.
+
+	@param: null.
+
+	@return: Return true if a task was run, false if the calling thread is not a thread of the pool or nothing is queued.
+*/
+bool CyWorkStealingPool::runPendingTask(){
+	function<void()> task;
+	if(tls_currentPool != this || !popTask(tls_workerIndex, task))
+	{
+		return false;
+	}
+	runTask(task);
+	return true;
+}
+
+
+/******IMPLEMENTATION OF PUBLIC METHODS******/
+/*
+	@name: submit
+	@description: Add a task to the pool. A task submitted by a thread of the pool goes in the deque of this thread
+	              (it is likely to use data which is hot in its cache), other tasks are distributed round robin.
+
+	@param: The method submit takes one mandatory parameter: a function.
+	-param1: the task.
+*/
+void CyWorkStealingPool::submit(function<void()> const& task){
+	long index;
+	if(tls_currentPool == this)
+	{
+		index = tls_workerIndex;
+	}
+	else
+	{
+		index = m_nextWorker++ % m_workers.size();
+	}
+	m_pendingTasks++;
+	{
+		Worker& worker = *m_workers[index];
+		lock_guard<mutex> lock(worker.m_mutex);
+		worker.m_tasks.push_back(task);
+		m_queuedTasks++;
+	}
+	// Take the lock so that a thread checking m_queuedTasks before sleeping cannot miss this notification.
+	{
+		lock_guard<mutex> lock(m_idleMutex);
+	}
+	m_idleCond.notify_one();
+}
+
+/*
+	@name: waitAll
+	@description: Block until all submitted tasks are finished (including the tasks they submitted).
+	              If a task threw an exception, the first one is rethrown here.
+
+	@param: null.
+*/
+void CyWorkStealingPool::waitAll(){
+	if(tls_currentPool == this)
+	{
+		cerr<<"Error: CyWorkStealingPool::waitAll cannot be called from a task of the same pool."<<endl;
+		return;
+	}
+	unique_lock<mutex> lock(m_doneMutex);
+	m_doneCond.wait(lock, [this]{ return m_pendingTasks == 0; });
+	if(m_firstException)
+	{
+		exception_ptr e = m_firstException;
+		m_firstException = exception_ptr();
+		rethrow_exception(e);
+	}
+}
+
+/*
+	@name: getDefault
+	@description: The pool used by the asynchronous operations of Cyfhel and CyAsync. It follows the global CyExecutionPolicy,
+	              or runs one task per hardware thread (CyExecutionPolicy::outerOnly) when no global policy is set.
+	              When the policy changed since the last call (CyExecutionPolicy::setGlobal or resetGlobal), a new pool is
+	              started. The previous one is retired: it is destroyed (its threads joined) by a later call once its
+	              tasks are done and nobody else holds it, so keep the returned pointer only as long as it is used.
+
+	@param: null.
+
+	@return: Return a shared_ptr to the default pool.
+*/
+shared_ptr<CyWorkStealingPool> CyWorkStealingPool::getDefault(){
+	static mutex defaultPoolMutex;
+	static shared_ptr<CyWorkStealingPool> defaultPool;
+	static vector< shared_ptr<CyWorkStealingPool> > retiredPools;
+	CyExecutionPolicy policy = CyExecutionPolicy::hasGlobal() ? CyExecutionPolicy::getGlobal() : CyExecutionPolicy::outerOnly();
+	lock_guard<mutex> lock(defaultPoolMutex);
+	// Join the retired pools which are idle and only held here (not by the calling thread, which may be one of theirs).
+	for(unsigned long i=0; i<retiredPools.size(); )
+	{
+		if(retiredPools[i].use_count() == 1 && retiredPools[i]->isIdle() && tls_currentPool != retiredPools[i].get())
+		{
+			retiredPools.erase(retiredPools.begin() + i);
+		}
+		else
+		{
+			i++;
+		}
+	}
+	if(defaultPool)
+	{
+		CyExecutionPolicy current = defaultPool->getm_policy();
+		if(current.getm_outerThreads() == policy.getm_outerThreads() &&
+		   current.getm_innerThreads() == policy.getm_innerThreads() &&
+		   current.getm_minParallelWork() == policy.getm_minParallelWork())
+		{
+			return defaultPool;
+		}
+		retiredPools.push_back(defaultPool);
+	}
+	defaultPool.reset(new CyWorkStealingPool(policy));
+	return defaultPool;
+}
+
+
+
+/******CONSTRUCTOR WITH PARAMETERS******/
+CyTaskGroup::CyTaskGroup(CyWorkStealingPool& pool):m_pool(pool), m_pendingTasks(0) {}
+
+
+/******DESTRUCTOR******/
+CyTaskGroup::~CyTaskGroup(){
+	// The tasks refer to this group: it must outlive them, even if wait was not called.
+	waitTasks();
+}
+
+
+/******IMPLEMENTATION OF PRIVATE METHODS******/
+/*
+	@name: taskDone
+	@description: Count a finished task of the group, keep its exception if it is the first one and wake up wait
+	              when it is the last pending task.
+
+	@param: The method taskDone takes one mandatory parameter: an exception_ptr.
+	-param1: the exception thrown by the task, null if it succeeded.
+*/
+void CyTaskGroup::taskDone(exception_ptr const& e){
+	lock_guard<mutex> lock(m_mutex);
+	if(e && !m_firstException)
+	{
+		m_firstException = e;
+	}
+	if(--m_pendingTasks == 0)
+	{
+		// Notify under the lock: once it is released, the waiting thread may destroy the group.
+		m_doneCond.notify_all();
+	}
+}
+
+/*
+	@name: waitTasks
+	@description: Block until all the tasks of the group are finished (including the tasks they submitted to the group).
+	              From a thread of the pool, run the queued tasks of the pool meanwhile: if every thread of the pool
+	              slept in wait, nobody would run the tasks of the group.
+
+	@param: null.
+*/
+void CyTaskGroup::waitTasks(){
+	if(tls_currentPool == &m_pool)
+	{
+		for(;;)
+		{
+			{
+				lock_guard<mutex> lock(m_mutex);
+				if(m_pendingTasks == 0)
+				{
+					return;
+				}
+			}
+			if(!m_pool.runPendingTask())
+			{
+				// The last tasks of the group run on other threads, they may still submit some.
+				unique_lock<mutex> lock(m_mutex);
+				m_doneCond.wait_for(lock, chrono::milliseconds(1), [this]{ return m_pendingTasks == 0; });
+			}
+		}
+	}
+	unique_lock<mutex> lock(m_mutex);
+	m_doneCond.wait(lock, [this]{ return m_pendingTasks == 0; });
+}
+
+
+/******IMPLEMENTATION OF PUBLIC METHODS******/
+/*
+	@name: submit
+	@description: Submit a task of the group to the pool. Its exception, if any, is kept by the group instead of the pool.
+
+	@param: The method submit takes one mandatory parameter: a function.
+	-param1: the task.
+*/
+void CyTaskGroup::submit(function<void()> const& task){
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_pendingTasks++;
+	}
+	m_pool.submit([this, task]{
+		exception_ptr e;
+		try
+		{
+			task();
+		}
+		catch(...)
+		{
+			e = current_exception();
+		}
+		taskDone(e);
+	});
+}
+
+/*
+	@name: wait
+	@description: Block until all the tasks of the group are finished, without waiting for the other tasks of the pool.
+	              If a task of the group threw an exception, the first one is rethrown here. Unlike
+	              CyWorkStealingPool::waitAll, it can be called from a task of the same pool.
+
+	@param: null.
+*/
+void CyTaskGroup::wait(){
+	waitTasks();
+	exception_ptr e;
+	{
+		lock_guard<mutex> lock(m_mutex);
+		e = m_firstException;
+		m_firstException = exception_ptr();
+	}
+	if(e)
+	{
+		rethrow_exception(e);
+	}
+}
+
+
+
+/******CONSTRUCTOR WITH PARAMETERS******/
+CyCircuit::CyCircuit(bool isVerbose):m_isVerbose(isVerbose) {}
+
+
+/******DESTRUCTOR******/
+CyCircuit::~CyCircuit(){}
+
+
+/******IMPLEMENTATION OF GETTERS******/
+/*
+	@name: size
+	@description: Number of nodes in the circuit.
+
+	@param: null.
+*/
+long CyCircuit::size() const {
+	return m_nodes.size();
+}
+
+
+/******IMPLEMENTATION OF PRIVATE METHODS******/
+/*
+	@name: checkNode
+	@description: Check that node is the index of an existing node.
+
+	@param: The method checkNode takes one mandatory parameter: a long.
+	-param1: the index of the node.
+*/
+void CyCircuit::checkNode(long node) const {
+	if(node < 0 || node >= size())
+	{
+		cerr<<"Error: the node "<<node<<" does not exist in the circuit of size "<<size()<<"."<<endl;
+	}
+	assert(node >= 0 && node < size());
+}
+
+/*
+	@name: evaluateNode
+	@description: Evaluate a node whose inputs are all evaluated, then submit its successors which become ready.
+
+	@param: The method evaluateNode takes two mandatory parameters: a CyTaskGroup and a long.
+	-param1: the task group of the run.
+	-param2: the index of the node.
+*/
+void CyCircuit::evaluateNode(CyTaskGroup& group, long node){
+	Node& n = *m_nodes[node];
+	vector<CyCtxt const*> inputs;
+	for(unsigned long i=0; i<n.m_inputs.size(); i++)
+	{
+		inputs.push_back(m_nodes[n.m_inputs[i]]->m_result.get());
+	}
+	n.m_result.reset(new CyCtxt(n.m_operation(inputs)));
+	if(m_isVerbose)
+	{
+		std::cout << "  CyCircuit: node " << node << " evaluated" << endl;
+	}
+
+	for(unsigned long i=0; i<n.m_successors.size(); i++)
+	{
+		long succ = n.m_successors[i];
+		if(--m_nodes[succ]->m_pendingInputs == 0)
+		{
+			group.submit([this, &group, succ]{ evaluateNode(group, succ); });
+		}
+	}
+}
+
+
+/******IMPLEMENTATION OF PUBLIC METHODS******/
+/*
+	@name: input
+	@description: Add an input node to the circuit. The CyCtxt is copied.
+
+	@param: The method input takes one mandatory parameter: a CyCtxt.
+	-param1: the value of the node.
+
+	@return: Return the index of the node.
+*/
+long CyCircuit::input(CyCtxt const& cy){
+	unique_ptr<Node> n(new Node());
+	n->m_result.reset(new CyCtxt(cy));
+	n->m_pendingInputs = 0;
+	m_nodes.push_back(std::move(n));
+	return size()-1;
+}
+
+/*
+	@name: operation
+	@description: Add a node which computes op on the results of the nodes inputs.
+	              op is called on a thread of the pool and must not modify anything shared with other nodes.
+
+	@param: The method operation takes two mandatory parameters: a vector of long and an Operation.
+	-param1: the indexes of the input nodes (they must already exist, so the circuit has no cycle).
+	-param2: the operation. It gets the results of the input nodes, in the same order.
+
+	@return: Return the index of the node.
+*/
+long CyCircuit::operation(vector<long> const& inputs, Operation const& op){
+	long node = size();
+	for(unsigned long i=0; i<inputs.size(); i++)
+	{
+		checkNode(inputs[i]);
+	}
+	unique_ptr<Node> n(new Node());
+	n->m_inputs = inputs;
+	n->m_operation = op;
+	n->m_pendingInputs = 0;
+	m_nodes.push_back(std::move(n));
+	for(unsigned long i=0; i<inputs.size(); i++)
+	{
+		m_nodes[inputs[i]]->m_successors.push_back(node);
+	}
+	return node;
+}
+
+long CyCircuit::add(long a, long b){
+	return operation({a, b}, [](vector<CyCtxt const*> const& in){ return *in[0] + *in[1]; });
+}
+
+long CyCircuit::sub(long a, long b){
+	return operation({a, b}, [](vector<CyCtxt const*> const& in){ return *in[0] - *in[1]; });
+}
+
+long CyCircuit::multiply(long a, long b){
+	return operation({a, b}, [](vector<CyCtxt const*> const& in){ return *in[0] * *in[1]; });
+}
+
+long CyCircuit::scalarProd(long a, long b){
+	return operation({a, b}, [](vector<CyCtxt const*> const& in){ return in[0]->returnScalarProd(*in[1]); });
+}
+
+long CyCircuit::square(long a){
+	return operation({a}, [](vector<CyCtxt const*> const& in){ return in[0]->returnSquare(); });
+}
+
+long CyCircuit::cube(long a){
+	return operation({a}, [](vector<CyCtxt const*> const& in){ return in[0]->returnCube(); });
+}
+
+long CyCircuit::negate(long a){
+	return operation({a}, [](vector<CyCtxt const*> const& in){ return in[0]->returnNegate(); });
+}
+
+long CyCircuit::cumSum(long a){
+	return operation({a}, [](vector<CyCtxt const*> const& in){ return in[0]->returnCumSum(); });
+}
+
+/*
+	@name: run
+	@description: Evaluate all the nodes of the circuit on a new CyWorkStealingPool.
+
+	@param: The method run takes two optional parameters: a long and a long.
+	-param1 (optional)(Default: 0): the number of threads of the pool. If 0, use the number of hardware threads.
+	-param2 (optional)(Default: 0): the number of NTL threads used inside each node. If 0, split the hardware threads evenly.
+*/
+void CyCircuit::run(long numberOfThreads, long innerThreads){
+	CyWorkStealingPool pool(numberOfThreads, innerThreads);
+	run(pool);
+}
+
+/*
+	@name: run
+	@description: Evaluate all the nodes of the circuit on a new CyWorkStealingPool following policy.
+
+	@param: The method run takes one mandatory parameter: a CyExecutionPolicy.
+	-param1: the split between the threads evaluating nodes concurrently and the NTL threads inside each node.
+*/
+void CyCircuit::run(CyExecutionPolicy const& policy){
+	CyWorkStealingPool pool(policy);
+	run(pool);
+}
+
+/*
+	@name: run
+	@description: Evaluate all the nodes of the circuit on pool. The nodes which only depend on inputs are submitted
+	              first, every other node is submitted by the thread that evaluates its last missing input.
+	              The nodes are submitted through their own CyTaskGroup: only they are waited for, and only their
+	              exceptions are rethrown, so pool can be shared (for instance the default pool).
+
+	@param: The method run takes one mandatory parameter: a CyWorkStealingPool.
+	-param1: the pool.
+*/
+void CyCircuit::run(CyWorkStealingPool& pool){
+	CyTaskGroup group(pool);
+	// Count, for each operation node, the inputs which are operation nodes themselves (input nodes are already evaluated).
+	for(long i=0; i<size(); i++)
+	{
+		Node& n = *m_nodes[i];
+		long pending = 0;
+		for(unsigned long j=0; j<n.m_inputs.size(); j++)
+		{
+			if(m_nodes[n.m_inputs[j]]->m_operation)
+			{
+				pending++;
+			}
+		}
+		n.m_pendingInputs = pending;
+		if(n.m_operation)
+		{
+			n.m_result.reset();
+		}
+	}
+	for(long i=0; i<size(); i++)
+	{
+		if(m_nodes[i]->m_operation && m_nodes[i]->m_pendingInputs == 0)
+		{
+			group.submit([this, &group, i]{ evaluateNode(group, i); });
+		}
+	}
+	group.wait();
+}
+
+/*
+	@name: getResult
+	@description: Get the result of a node. The circuit must have been run.
+
+	@param: The method getResult takes one mandatory parameter: a long.
+	-param1: the index of the node.
+
+	@return: Return a reference to the CyCtxt computed for this node.
+*/
+CyCtxt const& CyCircuit::getResult(long node) const {
+	checkNode(node);
+	if(!m_nodes[node]->m_result)
+	{
+		cerr<<"Error: the node "<<node<<" has not been evaluated, call run() first."<<endl;
+	}
+	assert(m_nodes[node]->m_result);
+	return *m_nodes[node]->m_result;
+}
+
+/*
+	@name: clear
+	@description: Remove all the nodes of the circuit.
+
+	@param: null.
+*/
+void CyCircuit::clear(){
+	m_nodes.clear();
+}
+
+
+
+/******IMPLEMENTATION OF PUBLIC METHODS******/
+// The operands are captured by value, the lambdas own their copies until the task has run.
+future<CyCtxt> CyAsync::add(CyCtxt const& a, CyCtxt const& b){
+	return CyWorkStealingPool::getDefault()->async([a, b]{ return a + b; });
+}
+
+future<CyCtxt> CyAsync::add(CyCtxt const& a, long b){
+	return CyWorkStealingPool::getDefault()->async([a, b]{ return a + b; });
+}
+
+future<CyCtxt> CyAsync::sub(CyCtxt const& a, CyCtxt const& b){
+	return CyWorkStealingPool::getDefault()->async([a, b]{ return a - b; });
+}
+
+future<CyCtxt> CyAsync::sub(CyCtxt const& a, long b){
+	return CyWorkStealingPool::getDefault()->async([a, b]{ return a - b; });
+}
+
+future<CyCtxt> CyAsync::multiply(CyCtxt const& a, CyCtxt const& b){
+	return CyWorkStealingPool::getDefault()->async([a, b]{ return a * b; });
+}
+
+future<CyCtxt> CyAsync::multiply(CyCtxt const& a, long b){
+	return CyWorkStealingPool::getDefault()->async([a, b]{ return a * b; });
+}
+
+future<CyCtxt> CyAsync::scalarProd(CyCtxt const& a, CyCtxt const& b){
+	return CyWorkStealingPool::getDefault()->async([a, b]{ return a.returnScalarProd(b); });
+}
+
+future<CyCtxt> CyAsync::square(CyCtxt const& a){
+	return CyWorkStealingPool::getDefault()->async([a]{ return a.returnSquare(); });
+}
+
+future<CyCtxt> CyAsync::cube(CyCtxt const& a){
+	return CyWorkStealingPool::getDefault()->async([a]{ return a.returnCube(); });
+}
+
+future<CyCtxt> CyAsync::negate(CyCtxt const& a){
+	return CyWorkStealingPool::getDefault()->async([a]{ return a.returnNegate(); });
+}
+
+future<CyCtxt> CyAsync::cumSum(CyCtxt const& a){
+	return CyWorkStealingPool::getDefault()->async([a]{ return a.returnCumSum(); });
+}
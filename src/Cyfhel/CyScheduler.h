@@ -0,0 +1,262 @@
+#ifndef DEF_CYSCHEDULER
+#define DEF_CYSCHEDULER
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <future>
+#include <utility>
+
+#include "Cyfhel.h"
+#include "CyExecutionPolicy.h"
+
+//The CyWorkStealingPool Class: a pool of threads, each with its own deque of tasks. A thread pops tasks from the back of
+//its own deque and, when it is empty, steals from the front of the deques of the other threads.
+//Each thread of the pool applies the CyExecutionPolicy of the pool: it owns an NTL thread pool of innerThreads threads,
+//so the NTL_EXEC_RANGE loops of HElib (FFT over the primes, matmul...) still run in parallel inside a task without
+//oversubscribing the cores.
+class CyWorkStealingPool {
+
+ private:
+
+	/******ATTRIBUTES******/
+	struct Worker {
+		std::mutex m_mutex;// Protects m_tasks
+		std::deque< std::function<void()> > m_tasks;// Tasks of this thread
+	};
+
+	std::vector< std::unique_ptr<Worker> > m_workers;// One deque per thread
+	std::vector<std::thread> m_threads;// The threads of the pool
+	CyExecutionPolicy m_policy;// Split between the threads of the pool and the NTL threads inside each task
+
+	std::mutex m_idleMutex;// Used to put idle threads to sleep
+	std::condition_variable m_idleCond;
+	std::mutex m_doneMutex;// Used by waitAll
+	std::condition_variable m_doneCond;
+
+	std::atomic<long> m_queuedTasks;// Nº of tasks waiting in the deques
+	std::atomic<long> m_pendingTasks;// Nº of tasks submitted and not finished yet
+	std::atomic<unsigned long> m_nextWorker;// Round robin for tasks submitted from outside the pool
+	std::atomic<bool> m_isStopping;
+	std::exception_ptr m_firstException;// First exception thrown by a task, rethrown by waitAll
+
+	/******PROTOTYPES OF PRIVATE METHODS******/
+	void startThreads();// Start the m_policy.getm_outerThreads() threads
+
+	void workerLoop(long index);// Main loop of the thread index
+
+	bool popTask(long index, std::function<void()>& task);// Pop a task of the thread index or steal one
+
+	void runTask(std::function<void()>& task);// Run a task and update the counters
+
+	bool runPendingTask();// Run one queued task on the calling thread of the pool, false if there is none
+
+	friend class CyTaskGroup;
+
+	/******DISABLE COPY******/
+	CyWorkStealingPool(CyWorkStealingPool const&);
+	CyWorkStealingPool& operator=(CyWorkStealingPool const&);
+
+
+ public:
+
+	/******CONSTRUCTOR WITH PARAMETERS******/
+	CyWorkStealingPool(long numberOfThreads = 0, long innerThreads = 0);
+
+	CyWorkStealingPool(CyExecutionPolicy const& policy);
+
+	/******DESTRUCTOR******/
+	virtual ~CyWorkStealingPool();
+
+	/******GETTERS******/
+	long getm_numberOfThreads() const;//Nº of threads of the pool
+
+	long getm_innerThreads() const;//Nº of NTL threads used inside each task
+
+	CyExecutionPolicy getm_policy() const;//Getter of attribute m_policy
+
+	bool isIdle() const;//True if all the submitted tasks are finished
+
+	/******PROTOTYPES OF PUBLIC METHODS******/
+	void submit(std::function<void()> const& task);// Add a task. From a thread of the pool, the task goes in its own deque.
+
+	void waitAll();// Block until all submitted tasks are finished, whoever submitted them. Must not be called from a task.
+
+	template<class F> std::future<decltype(std::declval<F>()())> async(F f);// Run f on the pool, get its result (or exception) in a future
+
+	static std::shared_ptr<CyWorkStealingPool> getDefault();// The pool behind the asynchronous operations, following the global policy (one task per hardware thread if none)
+};
+
+
+/*
+	@name: async
+	@description: Submit f to the pool and return a future of its result. An exception thrown by f is stored in
+	              the future instead of being rethrown by waitAll. Do not wait for the future from a task of the same
+	              pool: if all the threads of the pool wait, nobody runs the task.
+
+	@param: The method async takes one mandatory parameter: a callable object without parameter.
+	-param1: the function to run.
+
+	@return: Return a std::future of the result of f.
+*/
+template<class F> std::future<decltype(std::declval<F>()())> CyWorkStealingPool::async(F f){
+	typedef decltype(std::declval<F>()()) Result;
+	std::shared_ptr< std::packaged_task<Result()> > task(new std::packaged_task<Result()>(f));
+	std::future<Result> result = task->get_future();
+	submit([task]{ (*task)(); });
+	return result;
+}
+
+
+//The CyTaskGroup Class: a batch of tasks submitted to a CyWorkStealingPool, with its own counter and exception slot.
+//wait() only waits for the tasks of the group, so several groups can share a pool (the default pool for instance)
+//without waiting for, or rethrowing the exceptions of, the tasks of the others.
+class CyTaskGroup {
+
+ private:
+
+	/******ATTRIBUTES******/
+	CyWorkStealingPool& m_pool;// Pool running the tasks
+	std::mutex m_mutex;// Protects m_pendingTasks and m_firstException
+	std::condition_variable m_doneCond;
+	long m_pendingTasks;// Nº of tasks of the group not finished yet
+	std::exception_ptr m_firstException;// First exception thrown by a task of the group, rethrown by wait
+
+	/******PROTOTYPES OF PRIVATE METHODS******/
+	void taskDone(std::exception_ptr const& e);// Keep the first exception and wake up wait after the last task
+
+	void waitTasks();// Block until the tasks of the group are finished
+
+	/******DISABLE COPY******/
+	CyTaskGroup(CyTaskGroup const&);
+	CyTaskGroup& operator=(CyTaskGroup const&);
+
+
+ public:
+
+	/******CONSTRUCTOR WITH PARAMETERS******/
+	CyTaskGroup(CyWorkStealingPool& pool);
+
+	/******DESTRUCTOR******/
+	virtual ~CyTaskGroup();// Wait for the tasks still running (their exceptions are dropped)
+
+	/******PROTOTYPES OF PUBLIC METHODS******/
+	void submit(std::function<void()> const& task);// Add a task of the group to the pool
+
+	void wait();// Block until the tasks of the group are finished, rethrow the first exception of the group
+};
+
+
+//The CyAsync Class: asynchronous versions of the CyCtxt operators, run on CyWorkStealingPool::getDefault().
+//The operands are copied, so they can be modified or destroyed before the result is ready.
+class CyAsync {
+
+ public:
+
+	/******PROTOTYPES OF PUBLIC METHODS******/
+	static std::future<CyCtxt> add(CyCtxt const& a, CyCtxt const& b);// a + b
+
+	static std::future<CyCtxt> add(CyCtxt const& a, long b);// a + b
+
+	static std::future<CyCtxt> sub(CyCtxt const& a, CyCtxt const& b);// a - b
+
+	static std::future<CyCtxt> sub(CyCtxt const& a, long b);// a - b
+
+	static std::future<CyCtxt> multiply(CyCtxt const& a, CyCtxt const& b);// a * b
+
+	static std::future<CyCtxt> multiply(CyCtxt const& a, long b);// a * b
+
+	static std::future<CyCtxt> scalarProd(CyCtxt const& a, CyCtxt const& b);// a % b
+
+	static std::future<CyCtxt> square(CyCtxt const& a);// a²
+
+	static std::future<CyCtxt> cube(CyCtxt const& a);// a³
+
+	static std::future<CyCtxt> negate(CyCtxt const& a);// -a
+
+	static std::future<CyCtxt> cumSum(CyCtxt const& a);// Sum of all slots of a
+};
+
+
+//The CyCircuit Class: a task graph of CyCtxt operations. Each node is an operation whose inputs are other nodes;
+//run() executes the graph on a CyWorkStealingPool, so that independent nodes are evaluated concurrently.
+class CyCircuit {
+
+ public:
+
+	typedef std::function<CyCtxt(std::vector<CyCtxt const*> const&)> Operation;// An operation gets the results of its inputs
+
+ private:
+
+	/******ATTRIBUTES******/
+	struct Node {
+		std::vector<long> m_inputs;// Nodes whose results this node needs
+		std::vector<long> m_successors;// Nodes which need the result of this node
+		Operation m_operation;// Empty for input nodes
+		std::unique_ptr<CyCtxt> m_result;// Set once the node is evaluated
+		std::atomic<long> m_pendingInputs;// Inputs not evaluated yet during run()
+	};
+
+	std::vector< std::unique_ptr<Node> > m_nodes;
+	bool m_isVerbose;// Flag to print messages on console
+
+	/******PROTOTYPES OF PRIVATE METHODS******/
+	void checkNode(long node) const;
+
+	void evaluateNode(CyTaskGroup& group, long node);// Evaluate a node and submit the successors that become ready
+
+	/******DISABLE COPY******/
+	CyCircuit(CyCircuit const&);
+	CyCircuit& operator=(CyCircuit const&);
+
+
+ public:
+
+	/******CONSTRUCTOR WITH PARAMETERS******/
+	CyCircuit(bool isVerbose = false);
+
+	/******DESTRUCTOR******/
+	virtual ~CyCircuit();
+
+	/******GETTERS******/
+	long size() const;// Nº of nodes in the circuit
+
+	/******PROTOTYPES OF PUBLIC METHODS******/
+	long input(CyCtxt const& cy);// Add an input node, return its index
+
+	long operation(std::vector<long> const& inputs, Operation const& op);// Add a node computing op on the results of inputs
+
+	long add(long a, long b);// a + b
+
+	long sub(long a, long b);// a - b
+
+	long multiply(long a, long b);// a * b
+
+	long scalarProd(long a, long b);// a % b
+
+	long square(long a);// a²
+
+	long cube(long a);// a³
+
+	long negate(long a);// -a
+
+	long cumSum(long a);// Sum of all slots of a
+
+	void run(long numberOfThreads = 0, long innerThreads = 0);// Evaluate all the nodes on a new pool
+
+	void run(CyExecutionPolicy const& policy);// Evaluate all the nodes on a new pool following policy
+
+	void run(CyWorkStealingPool& pool);// Evaluate all the nodes on pool (which may run other tasks meanwhile)
+
+	CyCtxt const& getResult(long node) const;// Result of a node, after run()
+
+	void clear();// Remove all the nodes
+};
+
+#endif
@@ -0,0 +1,466 @@
+/*
+ * CySlotLayout
+ * --------------------------------------------------------------------
+ *  Placement of the entries of a vector or a matrix in the slots, on
+ *  the dimensions of the hypercube where its rotations are cheapest.
+ *  --------------------------------------------------------------------
+ *  Author: Remy AUDA & Alexandre AUDA
+ *  Date: 19/10/2026
+ *  --------------------------------------------------------------------
+ *  License: GNU GPL v3
+ *
+ *  Cyfhel is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Cyfhel is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *  --------------------------------------------------------------------
+ */
+
+#include <cassert>
+
+#include "CySlotLayout.h"
+
+using namespace std;
+
+
+/******CONSTRUCTOR WITH PARAMETERS******/
+/*
+	@name: CySlotLayout
+	@description: Choose the layout of a rows x cols matrix for a workload: the row-major order in the linear slots,
+	              or each axis of size > 1 on its own dimension of the hypercube, at least as large as the axis.
+	              The layout with the lowest cost for the given numbers of rotations is kept (the linear one if they
+	              are all 0).
+
+	@param: The constructor takes two mandatory parameters and four optional parameters: an EncryptedArray, a long, a long,
+	        a long, a long and a MatMulCostModel.
+	-param1: the EncryptedArray of the CyCtxt (see Cyfhel::getm_encryptedArray).
+	-param2: the number of rows.
+	-param3 (optional)(Default: 1): the number of columns, 1 for a vector.
+	-param4 (optional)(Default: 0): the number of rotations along the rows (rotate or sum with rowAxis) of the workload.
+	-param5 (optional)(Default: 0): the number of rotations along the columns (rotate or sum with colAxis) of the workload.
+	-param6 (optional)(Default: MatMulCostModel()): the cost of the rotations, MatMulCostModel::calibrate to measure it.
+*/
+CySlotLayout::CySlotLayout(EncryptedArray const& encryptedArray, long rows, long cols, long rowAxisRotations, long colAxisRotations,
+                           MatMulCostModel const& model):m_encryptedArray(&encryptedArray), m_isLinear(true), m_cost(0), m_masks(new Masks) {
+	const long nslots = m_encryptedArray->size();
+	assert(rows > 0 && cols > 0 && rows*cols <= nslots);
+	m_size[rowAxis] = rows;
+	m_size[colAxis] = cols;
+	m_dim[rowAxis] = m_dim[colAxis] = -1;
+
+	const long rotations[2] = { rowAxisRotations, colAxisRotations };
+	for(long a=0; a<2; a++)
+	{
+		if(m_size[a] > 1)
+		{
+			m_cost += rotations[a]*rotationCost((Axis) a, -1, model);
+		}
+	}
+
+	// The dimensions which can hold each axis (-1 alone for an axis of size 1).
+	vector<long> candidates[2];
+	for(long a=0; a<2; a++)
+	{
+		if(m_size[a] == 1)
+		{
+			candidates[a].push_back(-1);
+			continue;
+		}
+		for(long d=0; d<m_encryptedArray->dimension(); d++)
+		{
+			if(m_encryptedArray->sizeOfDimension(d) >= m_size[a])
+			{
+				candidates[a].push_back(d);
+			}
+		}
+	}
+
+	// Keep the cheapest placement, then the one with the smallest dimensions (less padding).
+	long bestSpan = nslots + 1;
+	for(unsigned long r=0; r<candidates[rowAxis].size(); r++)
+	{
+		for(unsigned long c=0; c<candidates[colAxis].size(); c++)
+		{
+			const long dims[2] = { candidates[rowAxis][r], candidates[colAxis][c] };
+			if(dims[rowAxis] >= 0 && dims[rowAxis] == dims[colAxis])
+			{
+				continue;
+			}
+			double cost = 0;
+			long span = 1;
+			for(long a=0; a<2; a++)
+			{
+				if(dims[a] >= 0)
+				{
+					cost += rotations[a]*rotationCost((Axis) a, dims[a], model);
+					span *= m_encryptedArray->sizeOfDimension(dims[a]);
+				}
+			}
+			if(cost < m_cost || (!m_isLinear && cost == m_cost && span < bestSpan))
+			{
+				m_isLinear = false;
+				m_cost = cost;
+				bestSpan = span;
+				m_dim[rowAxis] = dims[rowAxis];
+				m_dim[colAxis] = dims[colAxis];
+			}
+		}
+	}
+
+	// Slot of each entry: the coordinates of the other dimensions are 0.
+	m_slots.assign(rows*cols, -1);
+	if(m_isLinear)
+	{
+		for(long e=0; e<rows*cols; e++)
+		{
+			m_slots[e] = e;
+		}
+		return;
+	}
+	for(long k=0; k<nslots; k++)
+	{
+		long coordinates[2] = { 0, 0 };
+		bool isData = true;
+		for(long d=0; d<m_encryptedArray->dimension() && isData; d++)
+		{
+			const long coordinate = m_encryptedArray->coordinate(d, k);
+			if(d == m_dim[rowAxis] || d == m_dim[colAxis])
+			{
+				coordinates[d == m_dim[rowAxis] ? rowAxis : colAxis] = coordinate;
+			}
+			else if(coordinate != 0)
+			{
+				isData = false;
+			}
+		}
+		if(isData && coordinates[rowAxis] < rows && coordinates[colAxis] < cols)
+		{
+			m_slots[coordinates[rowAxis]*cols + coordinates[colAxis]] = k;
+		}
+	}
+}
+
+
+/******IMPLEMENTATION OF GETTERS******/
+/*
+	@name: getm_rows
+	@description: Getter of the number of rows.
+
+	@param: null.
+*/
+long CySlotLayout::getm_rows() const {
+	return m_size[rowAxis];
+}
+
+/*
+	@name: getm_cols
+	@description: Getter of the number of columns.
+
+	@param: null.
+*/
+long CySlotLayout::getm_cols() const {
+	return m_size[colAxis];
+}
+
+/*
+	@name: getm_dim
+	@description: Getter of attribute m_dim. It corresponds to the dimension of the hypercube holding the axis, -1 for
+	              the linear layout or an axis of size 1.
+
+	@param: The method getm_dim takes one mandatory parameter: an Axis.
+	-param1: rowAxis or colAxis.
+*/
+long CySlotLayout::getm_dim(Axis axis) const {
+	return m_dim[axis];
+}
+
+/*
+	@name: getm_isLinear
+	@description: Getter of attribute m_isLinear. It is true for the row-major order in the linear slots.
+
+	@param: null.
+*/
+bool CySlotLayout::getm_isLinear() const {
+	return m_isLinear;
+}
+
+/*
+	@name: getm_cost
+	@description: Getter of attribute m_cost. It corresponds to the estimated cost of the rotations of the workload
+	              with this layout, in the unit of the cost model.
+
+	@param: null.
+*/
+double CySlotLayout::getm_cost() const {
+	return m_cost;
+}
+
+
+/******IMPLEMENTATION OF PRIVATE METHODS******/
+/*
+	@name: rotationCost
+	@description: Private method giving the cost of a rotation along the axis placed on the dimension dim (-1 for the
+	              linear layout): one rotation if it is cyclic over the axis, two rotations and two masks otherwise.
+
+	@param: The method rotationCost takes three mandatory parameters: an Axis, a long and a MatMulCostModel.
+*/
+double CySlotLayout::rotationCost(Axis axis, long dim, MatMulCostModel const& model) const {
+	const long n = m_size[axis];
+	double rotation;
+	bool cyclic;
+	if(dim < 0)
+	{
+		rotation = model.rotate(*m_encryptedArray);
+		cyclic = (axis == rowAxis ? n*m_size[colAxis] : n) == m_encryptedArray->size();
+	}
+	else
+	{
+		rotation = model.rotate1D(*m_encryptedArray, dim);
+		cyclic = (n == m_encryptedArray->sizeOfDimension(dim));
+	}
+	return cyclic ? rotation : 2*rotation + 2*model.multConst;
+}
+
+/*
+	@name: isCyclic
+	@description: Private method telling if a single rotation (rawRotate) is cyclic over the axis.
+
+	@param: The method isCyclic takes one mandatory parameter: an Axis.
+*/
+bool CySlotLayout::isCyclic(Axis axis) const {
+	const long n = m_size[axis];
+	if(m_dim[axis] >= 0)
+	{
+		return n == m_encryptedArray->sizeOfDimension(m_dim[axis]);
+	}
+	return (axis == rowAxis ? n*m_size[colAxis] : n) == m_encryptedArray->size();
+}
+
+/*
+	@name: masks
+	@description: Private method giving the encoded masks of a rotation by k along axis: the entries with a coordinate
+	              >= k along the axis, and the other entries. The masks are encoded once and shared by the copies.
+	              The first mask for k = 0 is the mask of all the entries.
+
+	@param: The method masks takes two mandatory parameters: an Axis and a long.
+*/
+pair<ZZX, ZZX> const& CySlotLayout::masks(Axis axis, long k) const {
+	lock_guard<mutex> lock(m_masks->lock);
+	map< pair<long, long>, pair<ZZX, ZZX> >::iterator it = m_masks->masks.find(make_pair((long) axis, k));
+	if(it == m_masks->masks.end())
+	{
+		const long cols = m_size[colAxis];
+		vector<long> high(m_encryptedArray->size(), 0), low(m_encryptedArray->size(), 0);
+		for(unsigned long e=0; e<m_slots.size(); e++)
+		{
+			const long coordinate = (axis == rowAxis) ? e/cols : e%cols;
+			(coordinate >= k ? high : low)[m_slots[e]] = 1;
+		}
+		it = m_masks->masks.insert(make_pair(make_pair((long) axis, k), pair<ZZX, ZZX>())).first;
+		m_encryptedArray->encode(it->second.first, high);
+		m_encryptedArray->encode(it->second.second, low);
+	}
+	return it->second;
+}
+
+/*
+	@name: rawRotate
+	@description: Private method rotating by k the dimension of the axis, or the linear slots by k rows or columns.
+
+	@param: The method rawRotate takes three mandatory parameters: a Ctxt, an Axis and a long.
+*/
+void CySlotLayout::rawRotate(Ctxt& ctxt, Axis axis, long k) const {
+	if(m_dim[axis] >= 0)
+	{
+		m_encryptedArray->rotate1D(ctxt, m_dim[axis], k);
+	}
+	else
+	{
+		m_encryptedArray->rotate(ctxt, axis == rowAxis ? k*m_size[colAxis] : k);
+	}
+}
+
+
+/******IMPLEMENTATION OF PUBLIC METHODS******/
+/*
+	@name: slot
+	@description: Slot of the entry (i, j).
+
+	@param: The method slot takes one mandatory parameter and one optional parameter: a long and a long.
+	-param1: the row.
+	-param2 (optional)(Default: 0): the column.
+*/
+long CySlotLayout::slot(long i, long j) const {
+	return m_slots[i*m_size[colAxis] + j];
+}
+
+/*
+	@name: encode
+	@description: Slot values of a matrix in this layout, to encrypt (see Cyfhel::encrypt). The padding slots are 0.
+
+	@param: The method encode takes one mandatory parameter: a vector<vector<long>>.
+	-param1: the entries of the matrix, row by row; the missing entries are 0.
+
+	@return: Return the nslots slot values.
+*/
+vector<long> CySlotLayout::encode(vector< vector<long> > const& data) const {
+	vector<long> slots(m_encryptedArray->size(), 0);
+	for(long i=0; i<m_size[rowAxis] && i<(long) data.size(); i++)
+	{
+		for(long j=0; j<m_size[colAxis] && j<(long) data[i].size(); j++)
+		{
+			slots[slot(i, j)] = data[i][j];
+		}
+	}
+	return slots;
+}
+
+/*
+	@name: encode
+	@description: Slot values of a vector in this layout (cols = 1).
+
+	@param: The method encode takes one mandatory parameter: a vector<long>.
+	-param1: the entries of the vector; the missing entries are 0.
+
+	@return: Return the nslots slot values.
+*/
+vector<long> CySlotLayout::encode(vector<long> const& data) const {
+	vector<long> slots(m_encryptedArray->size(), 0);
+	for(long i=0; i<m_size[rowAxis] && i<(long) data.size(); i++)
+	{
+		slots[slot(i)] = data[i];
+	}
+	return slots;
+}
+
+/*
+	@name: decode
+	@description: Matrix of the slot values in this layout (see Cyfhel::decrypt).
+
+	@param: The method decode takes one mandatory parameter: a vector<long>.
+	-param1: the nslots slot values.
+
+	@return: Return the entries of the matrix, row by row.
+*/
+vector< vector<long> > CySlotLayout::decode(vector<long> const& slots) const {
+	vector< vector<long> > data(m_size[rowAxis], vector<long>(m_size[colAxis], 0));
+	for(long i=0; i<m_size[rowAxis]; i++)
+	{
+		for(long j=0; j<m_size[colAxis]; j++)
+		{
+			if(slot(i, j) < (long) slots.size())
+			{
+				data[i][j] = slots[slot(i, j)];
+			}
+		}
+	}
+	return data;
+}
+
+/*
+	@name: rotate
+	@description: Move the entry (i, j) to (i+k, j) (rowAxis) or (i, j+k) (colAxis), cyclically over the axis. It is a
+	              single rotation when the axis fills its dimension (or the linear slots), otherwise the two rotations
+	              by k and k-n are merged with two masks, so that the padding slots stay 0.
+
+	@param: The method rotate takes three mandatory parameters: a Ctxt, an Axis and a long.
+	-param1: the ciphertext in this layout.
+	-param2: rowAxis or colAxis.
+	-param3: the number of steps, negative to move back.
+*/
+void CySlotLayout::rotate(Ctxt& ctxt, Axis axis, long k) const {
+	const long n = m_size[axis];
+	k = mcMod(k, n);
+	if(k == 0)
+	{
+		return;
+	}
+	if(isCyclic(axis))
+	{
+		rawRotate(ctxt, axis, k);
+		return;
+	}
+	pair<ZZX, ZZX> const& mask = masks(axis, k);
+	Ctxt wrapped(ctxt);
+	rawRotate(ctxt, axis, k);
+	rawRotate(wrapped, axis, k-n);
+	ctxt.multByConstant(mask.first);
+	wrapped.multByConstant(mask.second);
+	ctxt += wrapped;
+}
+
+/*
+	@name: sum
+	@description: Replace each entry by the sum of the entries of its column (rowAxis) or of its row (colAxis), in
+	              about 2*log2(n) rotations. On a dimension, the sum runs over the whole dimension (the padding slots
+	              are 0) with single rotations, then one mask clears the padding slots again.
+
+	@param: The method sum takes two mandatory parameters: a Ctxt and an Axis.
+	-param1: the ciphertext in this layout.
+	-param2: rowAxis or colAxis.
+*/
+void CySlotLayout::sum(Ctxt& ctxt, Axis axis) const {
+	const long dim = m_dim[axis];
+	const long n = (dim >= 0) ? m_encryptedArray->sizeOfDimension(dim) : m_size[axis];
+	if(m_size[axis] == 1)
+	{
+		return;
+	}
+
+	// Same steps as totalSums, along the axis.
+	auto step = [this, axis, dim](Ctxt& c, long amount) {
+		if(dim >= 0)
+		{
+			rawRotate(c, axis, amount);
+		}
+		else
+		{
+			rotate(c, axis, amount);
+		}
+	};
+	Ctxt orig = ctxt;
+	long e = 1;
+	for(long b=NumBits(n)-2; b>=0; b--)
+	{
+		Ctxt tmp1 = ctxt;
+		step(tmp1, e);
+		ctxt += tmp1;
+		e = 2*e;
+		if(bit(n, b))
+		{
+			Ctxt tmp2 = orig;
+			step(tmp2, e);
+			ctxt += tmp2;
+			e += 1;
+		}
+	}
+	if(dim >= 0 && !isCyclic(axis))
+	{
+		ctxt.multByConstant(masks(axis, 0).first);
+	}
+}
+
+
+/******STREAM OPERATORS OVERLOAD******/
+std::ostream& operator<<(std::ostream& flux, CySlotLayout const& layout){
+	flux << layout.getm_rows() << "x" << layout.getm_cols() << " layout: ";
+	if(layout.getm_isLinear())
+	{
+		flux << "linear";
+	}
+	else
+	{
+		flux << "rows on dimension " << layout.getm_dim(CySlotLayout::rowAxis)
+		     << ", columns on dimension " << layout.getm_dim(CySlotLayout::colAxis);
+	}
+	flux << ", cost " << layout.getm_cost();
+	return flux;
+}
@@ -0,0 +1,87 @@
+#ifndef DEF_CYSLOTLAYOUT
+#define DEF_CYSLOTLAYOUT
+
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <iostream>
+
+#include "FHE.h"
+#include "EncryptedArray.h"
+#include "matmul.h"
+
+//The CySlotLayout Class: where the entries of a rows x cols matrix (a vector if cols = 1) go in the slots.
+//The slots form a hypercube: a rotation along one of its dimensions (rotate1D) costs one key switch on a native
+//dimension and two plus a mask on a bad one, while a rotation of the whole slot vector (rotate) costs about two of
+//them per dimension. Given the number of rotations the workload runs along each axis of the matrix (a row sum
+//rotates along the columns, a column shift too, a column sum along the rows...), the layout puts each axis on its
+//own dimension when the cost model (see MatMulCostModel) says it is cheaper, and keeps the row-major order in the
+//linear slots otherwise. The padding slots are 0.
+//The rotations and sums along an axis are cyclic over the axis, whatever the layout.
+class CySlotLayout {
+
+ public:
+
+	enum Axis { rowAxis = 0, colAxis = 1 };// rowAxis: moves along the row index i, colAxis: along the column index j
+
+ private:
+
+	struct Masks {
+		std::mutex lock;
+		std::map< std::pair<long, long>, std::pair<ZZX, ZZX> > masks;// Per (axis, k): the targets of the two rotations
+	};
+
+	/******ATTRIBUTES******/
+	EncryptedArray const* m_encryptedArray;// Array of the slots of the CyCtxt
+	long m_size[2];// Nº of rows and columns
+	long m_dim[2];// Dimension of each axis, -1 for the linear layout or an axis of size 1
+	bool m_isLinear;// Row-major order in the linear slots
+	double m_cost;// Estimated cost of the rotations of the workload
+	std::vector<long> m_slots;// Slot of each entry, row by row
+	std::shared_ptr<Masks> m_masks;// Masks of the rotations which are not a single rotate1D, shared by the copies
+
+	/******PROTOTYPES OF PRIVATE METHODS******/
+	double rotationCost(Axis axis, long dim, MatMulCostModel const& model) const;// Cost of a rotation along axis on dim
+
+	bool isCyclic(Axis axis) const;// True if a single rotation of the dimension or of the slots is cyclic over the axis
+
+	std::pair<ZZX, ZZX> const& masks(Axis axis, long k) const;// Masks of a rotation by k along axis
+
+	void rawRotate(Ctxt& ctxt, Axis axis, long k) const;// Rotation of the hypercube dimension or of the linear slots
+
+
+ public:
+
+	/******CONSTRUCTOR WITH PARAMETERS******/
+	CySlotLayout(EncryptedArray const& encryptedArray, long rows, long cols = 1, long rowAxisRotations = 0,
+	             long colAxisRotations = 0, MatMulCostModel const& model = MatMulCostModel());
+
+	/******GETTERS******/
+	long getm_rows() const;//Getter of attribute m_size[rowAxis]
+
+	long getm_cols() const;//Getter of attribute m_size[colAxis]
+
+	long getm_dim(Axis axis) const;//Getter of attribute m_dim
+
+	bool getm_isLinear() const;//Getter of attribute m_isLinear
+
+	double getm_cost() const;//Getter of attribute m_cost
+
+	/******PROTOTYPES OF PUBLIC METHODS******/
+	long slot(long i, long j = 0) const;// Slot of the entry (i, j)
+
+	std::vector<long> encode(std::vector< std::vector<long> > const& data) const;// Slot values of the matrix
+
+	std::vector<long> encode(std::vector<long> const& data) const;// Slot values of the vector (cols = 1)
+
+	std::vector< std::vector<long> > decode(std::vector<long> const& slots) const;// Matrix of the slot values
+
+	void rotate(Ctxt& ctxt, Axis axis, long k) const;// Move the entry (i, j) k steps along axis, cyclically
+
+	void sum(Ctxt& ctxt, Axis axis) const;// Replace each entry by the sum of its row (colAxis) or column (rowAxis)
+};
+
+std::ostream& operator<<(std::ostream& flux, CySlotLayout const& layout);
+
+#endif
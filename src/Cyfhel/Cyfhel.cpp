@@ -33,26 +33,59 @@
  *  --------------------------------------------------------------------
  */
 
+#include <algorithm>
+#include <map>
+#include <mutex>
+
 #include "Cyfhel.h"
+#include "CyScheduler.h"
+#include "replicate.h"
 
 using namespace std;
 
+// The polynomes of the lookup tables, per plaintext space and table (see lookupTablePolynome).
+static mutex lookupTableCacheMutex;
+static map< pair< long, vector<long> >, ZZX > lookupTableCache;
+
+// Nº of matrices kept by a Cyfhel object, the least recently used one is dropped first (see matrix).
+static const unsigned long maxMatrices = 32;
+
+// Handler of replicateAll giving the replicated slots 0, 1, ... of a column to process, up to the used ones (see matMul).
+class ColumnReplicator : public ReplicateHandler {
+public:
+	ColumnReplicator(long used, std::function<void(long, Ctxt const&)> const& process):m_slot(0), m_used(used), m_process(process) {}
+
+	virtual void handle(Ctxt const& ctxt){
+		if(m_slot < m_used)
+		{
+			m_process(m_slot, ctxt);
+		}
+		m_slot++;
+	}
+
+	virtual bool isDone() const { return m_slot >= m_used; }// replicateAll does not compute the slots beyond m_used
+
+private:
+	long m_slot, m_used;
+	std::function<void(long, Ctxt const&)> m_process;
+};
+
 /******CONSTRUCTOR BY DEFAULT******/
 
 
 /******CONSTRUCTOR WITH PARAMETERS******/
-Cyfhel::Cyfhel(bool isVerbose, long p, long r, long c, long d, long sec, long w, long L, long m, long const& R, long const& s, vector<long> const& gens, vector<long> const& ords):m_context(0), m_secretKey(0), m_publicKey(0), m_encryptedArray(0) {
+Cyfhel::Cyfhel(bool isVerbose, long p, long r, long c, long d, long sec, long w, long L, long m, long const& R, long const& s, vector<long> const& gens, vector<long> const& ords):m_context(0), m_secretKey(0), m_publicKey(0), m_encryptedArray(0), m_hasExecutionPolicy(false), m_recryptedCtxts(0), m_recryptSeconds(0), m_matricesClock(0) {
 	m_isVerbose = isVerbose;
 	keyGen(p, r, c, d, sec, w, L, m, R, s, gens, ords);
 }
 
-Cyfhel::Cyfhel(long p, long r, long c, long d, long sec, long w, long L, long m, long const& R, long const& s, vector<long> const& gens, vector<long> const& ords, bool isVerbose):m_context(0), m_secretKey(0), m_publicKey(0), m_encryptedArray(0) {
+Cyfhel::Cyfhel(long p, long r, long c, long d, long sec, long w, long L, long m, long const& R, long const& s, vector<long> const& gens, vector<long> const& ords, bool isVerbose):m_context(0), m_secretKey(0), m_publicKey(0), m_encryptedArray(0), m_hasExecutionPolicy(false), m_recryptedCtxts(0), m_recryptSeconds(0), m_matricesClock(0) {
 	m_isVerbose = isVerbose;
 	keyGen(p, r, c, d, sec, w, L, m, R, s, gens, ords);
 }
 
 // TODO: MUST be tested.
-Cyfhel::Cyfhel(vector<long> cryptoParameters, bool isVerbose):m_context(0), m_secretKey(0), m_publicKey(0), m_encryptedArray(0) {
+Cyfhel::Cyfhel(vector<long> cryptoParameters, bool isVerbose):m_context(0), m_secretKey(0), m_publicKey(0), m_encryptedArray(0), m_hasExecutionPolicy(false), m_recryptedCtxts(0), m_recryptSeconds(0), m_matricesClock(0) {
 	// TODO: We should be able to provide just some parameters and the rest will be initialize by default.
 	if(cryptoParameters.size() < 7)
 	{
@@ -112,8 +145,37 @@ Cyfhel::Cyfhel(vector<long> cryptoParameters, bool isVerbose):m_context(0), m_se
     }
 }
 
+/*
+	@name: Cyfhel
+	@description: Create a bootstrappable scheme: the context gets the bootstrapping data (RecryptData) and the secret key
+	              the bootstrapping key, so that the ciphertexts can be recrypted and a small L is enough for deep circuits.
+
+	@param: The constructor takes four mandatory parameters and five optional parameters.
+	-param1: a vector of long which corresponds to the factorization of m used by the bootstrapping (ex: {11, 155}).
+	-param2: a long which corresponds to the plaintext base p.
+	-param3: a long which corresponds to the lifting r.
+	-param4: a long which corresponds to the number of levels L of the modulus chain.
+	-param5 (optional)(Default: 3): a long which corresponds to the number of columns in key switching matrix c.
+	-param6 (optional)(Default: -1): a long which corresponds to m. If -1, the product of mvec.
+	-param7 (optional)(Default: empty): the generators of (Z/mZ)^* / (p).
+	-param8 (optional)(Default: empty): the orders of the generators.
+	-param9 (optional)(Default: false): a bool which corresponds to the verbose flag.
+*/
+Cyfhel::Cyfhel(vector<long> const& mvec, long p, long r, long L, long c, long m, vector<long> const& gens, vector<long> const& ords, bool isVerbose):m_context(0), m_secretKey(0), m_publicKey(0), m_encryptedArray(0), m_hasExecutionPolicy(false), m_recryptedCtxts(0), m_recryptSeconds(0), m_matricesClock(0) {
+	m_isVerbose = isVerbose;
+	if(m == -1)
+	{
+		m = 1;
+		for(unsigned long i=0; i<mvec.size(); i++)
+		{
+			m *= mvec[i];
+		}
+	}
+	keyGen(p, r, c, 1, 80, 64, L, m, 3, 0, gens, ords, mvec);
+}
+
 /******COPY CONSTRUCTOR******/
-Cyfhel::Cyfhel(Cyfhel const& cyfhelToCopy):m_G(cyfhelToCopy.m_G), m_global_m(cyfhelToCopy.m_global_m), m_global_p(cyfhelToCopy.m_global_p), m_global_r(cyfhelToCopy.m_global_r), m_numberOfSlots(cyfhelToCopy.m_numberOfSlots), m_isVerbose(cyfhelToCopy.m_isVerbose) {
+Cyfhel::Cyfhel(Cyfhel const& cyfhelToCopy):m_G(cyfhelToCopy.m_G), m_global_m(cyfhelToCopy.m_global_m), m_global_p(cyfhelToCopy.m_global_p), m_global_r(cyfhelToCopy.m_global_r), m_numberOfSlots(cyfhelToCopy.m_numberOfSlots), m_isVerbose(cyfhelToCopy.m_isVerbose), m_executionPolicy(cyfhelToCopy.m_executionPolicy), m_hasExecutionPolicy(cyfhelToCopy.m_hasExecutionPolicy), m_recryptedCtxts(0), m_recryptSeconds(0), m_matricesClock(0), m_matMulCostModel(cyfhelToCopy.m_matMulCostModel) {
 	if(m_isVerbose){
 		std::cout << "Use the copy constructor. Begin the construction." << endl;
 	}
@@ -121,12 +183,64 @@ Cyfhel::Cyfhel(Cyfhel const& cyfhelToCopy):m_G(cyfhelToCopy.m_G), m_global_m(cyf
 	m_secretKey = new FHESecKey(*(cyfhelToCopy.m_secretKey));
 	m_publicKey = new FHEPubKey(*(cyfhelToCopy.m_publicKey));
 	m_encryptedArray = new EncryptedArray(*(cyfhelToCopy.m_encryptedArray));
+	{
+		lock_guard<mutex> lock(cyfhelToCopy.m_recryptBatchMutex);
+		m_packingMasks = cyfhelToCopy.m_packingMasks;
+	}
 	if(m_isVerbose){
 		std::cout << "End of the construction." << endl;
 	}
 }
 
 
+/******ASSIGNMENT OPERATOR******/
+/*
+	@name: operator=
+	@description: Copy the attributes of cyfhelToCopy (the context and the keys are shared, as before). The mutexes are
+	              not copied: each object keeps its own.
+
+	@param: The operator= takes one mandatory parameter: a Cyfhel.
+	-param1: the Cyfhel object to copy.
+
+	@return: Return a reference to this object.
+*/
+Cyfhel& Cyfhel::operator=(Cyfhel const& cyfhelToCopy){
+	if(this == &cyfhelToCopy)
+	{
+		return *this;
+	}
+	m_context = cyfhelToCopy.m_context;
+	m_secretKey = cyfhelToCopy.m_secretKey;
+	m_publicKey = cyfhelToCopy.m_publicKey;
+	m_G = cyfhelToCopy.m_G;
+	m_encryptedArray = cyfhelToCopy.m_encryptedArray;
+	m_global_m = cyfhelToCopy.m_global_m;
+	m_global_p = cyfhelToCopy.m_global_p;
+	m_global_r = cyfhelToCopy.m_global_r;
+	m_numberOfSlots = cyfhelToCopy.m_numberOfSlots;
+	m_isVerbose = cyfhelToCopy.m_isVerbose;
+	m_executionPolicy = cyfhelToCopy.m_executionPolicy;
+	m_hasExecutionPolicy = cyfhelToCopy.m_hasExecutionPolicy;
+	{
+		lock_guard<mutex> lock(m_poolMutex);
+		m_pool.reset();
+	}
+	m_matMulCostModel = cyfhelToCopy.m_matMulCostModel;
+	{
+		std::lock(m_recryptBatchMutex, cyfhelToCopy.m_recryptBatchMutex);
+		lock_guard<mutex> lock1(m_recryptBatchMutex, adopt_lock);
+		lock_guard<mutex> lock2(cyfhelToCopy.m_recryptBatchMutex, adopt_lock);
+		m_packingMasks = cyfhelToCopy.m_packingMasks;
+		m_recryptedCtxts = cyfhelToCopy.m_recryptedCtxts;
+		m_recryptSeconds = cyfhelToCopy.m_recryptSeconds;
+	}
+	lock_guard<mutex> lock(m_matricesMutex);
+	m_matrices.clear();// Built on the EncryptedArray of cyfhelToCopy, rebuilt at the first use
+	m_matricesClock = 0;
+	return *this;
+}
+
+
 /******DESTRUCTOR BY DEFAULT******/
 Cyfhel::~Cyfhel(){
 
@@ -183,6 +297,51 @@ bool Cyfhel::getm_isVerbose() const {
 	return m_isVerbose;
 }
 
+/*
+	@name: getm_executionPolicy
+	@description: Getter of the execution policy of this object: its own policy if it has one, the global policy otherwise.
+
+	@param: null.
+*/
+CyExecutionPolicy Cyfhel::getm_executionPolicy() const {
+	if(m_hasExecutionPolicy)
+	{
+		return m_executionPolicy;
+	}
+	return CyExecutionPolicy::getGlobal();
+}
+
+/*
+	@name: isBootstrappable
+	@description: Tell if the context has the bootstrapping data, i.e. if the ciphertexts can be recrypted (CyCtxt::recrypt).
+
+	@param: null.
+*/
+bool Cyfhel::isBootstrappable() const {
+	return m_context->isBootstrappable() && m_publicKey->isBootstrappable();
+}
+
+/*
+	@name: getm_encryptedArray
+	@description: Getter of attribute m_encryptedArray. It corresponds to the array of the slots of the CyCtxt (see CyMatrix).
+
+	@param: null.
+*/
+EncryptedArray const& Cyfhel::getm_encryptedArray() const {
+	return *m_encryptedArray;
+}
+
+/*
+	@name: getm_matMulCostModel
+	@description: Getter of attribute m_matMulCostModel. It corresponds to the costs of the rotations and of the products
+	              by a constant measured on the current context, used to plan the products by a matrix and the slot layouts.
+
+	@param: null.
+*/
+MatMulCostModel Cyfhel::getm_matMulCostModel() const {
+	return m_matMulCostModel;
+}
+
 /******IMPLEMENTATION OF SETTERS******/
 /*
 	@name: setm_numberOfSlots
@@ -239,8 +398,196 @@ void Cyfhel::setm_isVerbose(bool isVerbose) {
 	this->m_isVerbose = isVerbose;
 }
 
+/*
+	@name: setm_executionPolicy
+	@description: Setter of attribute m_executionPolicy. This object stops following the global execution policy.
+
+	@param: The method setm_executionPolicy takes one mandatory parameter: a CyExecutionPolicy.
+	-param1: the split between concurrent operations and NTL threads inside each operation for this object.
+*/
+void Cyfhel::setm_executionPolicy(CyExecutionPolicy const& executionPolicy) {
+	this->m_executionPolicy = executionPolicy;
+	this->m_hasExecutionPolicy = true;
+	lock_guard<mutex> lock(m_poolMutex);
+	m_pool.reset();// Started again with the new policy by the next batch
+}
+
+/*
+	@name: useGlobalExecutionPolicy
+	@description: This object follows the global execution policy again.
+
+	@param: null.
+*/
+void Cyfhel::useGlobalExecutionPolicy() {
+	this->m_hasExecutionPolicy = false;
+	lock_guard<mutex> lock(m_poolMutex);
+	m_pool.reset();
+}
+
 
 /******IMPLEMENTATION OF PRIVATE METHODS******/
+// EXECUTION POLICY
+/*
+	@name: applyExecutionPolicy
+	@description: Private method called at the beginning of the operations of Cyfhel: the calling thread gets the NTL
+	              thread pool and the HElib threshold of the execution policy of this object. The CyCtxt operations
+	              which follow on this thread use them too. Threads of a CyWorkStealingPool keep the policy of their pool.
+	              Without its own policy nor a global one, nothing is changed.
+
+	@param: null.
+*/
+void Cyfhel::applyExecutionPolicy() const {
+	if(m_hasExecutionPolicy)
+	{
+		m_executionPolicy.applyToCurrentThread();
+	}
+	else if(CyExecutionPolicy::hasGlobal())
+	{
+		CyExecutionPolicy::getGlobal().applyToCurrentThread();
+	}
+}
+
+/*
+	@name: batchExecutionPolicy
+	@description: Private method giving the policy of the batch methods (polynomialEvalBatch, recryptBatch): the policy of this
+	              object, else the global policy, else one CyCtxt per hardware thread.
+
+	@param: null.
+*/
+CyExecutionPolicy Cyfhel::batchExecutionPolicy() const {
+	if(m_hasExecutionPolicy)
+	{
+		return m_executionPolicy;
+	}
+	if(CyExecutionPolicy::hasGlobal())
+	{
+		return CyExecutionPolicy::getGlobal();
+	}
+	return CyExecutionPolicy::outerOnly();
+}
+
+// PACKING
+/*
+	@name: packingMask
+	@description: Private method giving the plaintext with 1 in the size first slots and 0 elsewhere, encoded once per size.
+
+	@param: The method packingMask takes one mandatory parameter: a long.
+	-param1: a long which corresponds to the number of slots to keep.
+
+	@return: Return a shared_ptr to the cached encoded mask.
+*/
+std::shared_ptr<ZZX const> Cyfhel::packingMask(long size){
+	lock_guard<mutex> lock(m_recryptBatchMutex);
+	std::shared_ptr<ZZX const>& mask = m_packingMasks[size];
+	if(!mask)
+	{
+		vector<long> slots(m_numberOfSlots, 0);
+		for(long i=0; i<size && i<m_numberOfSlots; i++)
+		{
+			slots[i] = 1;
+		}
+		std::shared_ptr<ZZX> encoded(new ZZX());
+		m_encryptedArray->encode(*encoded, slots);
+		mask = encoded;
+	}
+	// Shared, so that clearCaches can drop the mask while recryptBatch still uses it.
+	return mask;
+}
+
+/*
+	@name: batchPool
+	@description: Private method giving the pool of the batch methods: CyWorkStealingPool::getDefault if this object follows
+	              the global policy, else a pool following the own policy of this object, started at the first call and
+	              kept until the policy changes.
+
+	@param: null.
+
+	@return: Return a shared_ptr to the pool.
+*/
+std::shared_ptr<CyWorkStealingPool> Cyfhel::batchPool() const {
+	if(!m_hasExecutionPolicy)
+	{
+		return CyWorkStealingPool::getDefault();
+	}
+	lock_guard<mutex> lock(m_poolMutex);
+	if(!m_pool)
+	{
+		m_pool.reset(new CyWorkStealingPool(m_executionPolicy));
+	}
+	return m_pool;
+}
+
+/*
+	@name: forEachTask
+	@description: Private method running task(0), ..., task(nbTasks-1) concurrently on batchPool, in a CyTaskGroup of their
+	              own: other tasks of the pool are neither waited for nor rethrown. It runs them in order on the calling
+	              thread if there is only one task or batchExecutionPolicy has only one outer thread.
+
+	@param: The method forEachTask takes two mandatory parameters: a long and a function.
+	-param1: a long which corresponds to the number of tasks.
+	-param2: a function which corresponds to the task, called with its index.
+*/
+void Cyfhel::forEachTask(long nbTasks, std::function<void(long)> const& task) const {
+	if(nbTasks <= 1 || batchExecutionPolicy().getm_outerThreads() <= 1)
+	{
+		for(long l=0; l<nbTasks; l++)
+		{
+			task(l);
+		}
+		return;
+	}
+	std::shared_ptr<CyWorkStealingPool> pool = batchPool();
+	CyTaskGroup group(*pool);
+	for(long l=0; l<nbTasks; l++)
+	{
+		group.submit([&task, l]() {
+			task(l);
+		});
+	}
+	group.wait();
+}
+
+// CACHES
+/*
+	@name: clearCaches
+	@description: Private method forgetting the objects built on the current context and EncryptedArray, called when
+	              keyGen or restoreEnv are about to replace them: the matrices of matVecMul hold a reference to the
+	              EncryptedArray, the packing masks of recryptBatch are encoded with it, and CyCtxt keeps permutation
+	              networks and masks per context (the replaced context is not destroyed, so they would stay).
+
+	@param: null.
+*/
+void Cyfhel::clearCaches(){
+	if(m_context)
+	{
+		CyCtxt::clearContextCaches(*m_context);
+	}
+	{
+		lock_guard<mutex> lock(m_matricesMutex);
+		m_matrices.clear();
+	}
+	lock_guard<mutex> lock(m_recryptBatchMutex);
+	m_packingMasks.clear();
+}
+
+/*
+	@name: calibrateMatMul
+	@description: Private method measuring m_matMulCostModel on the current context, once per context (keyGen, restoreEnv):
+	              the matrices (see matrix) and the slot layouts (see slotLayout) are planned with the measured costs.
+
+	@param: null.
+*/
+void Cyfhel::calibrateMatMul(){
+	vector<long> zeros(m_numberOfSlots, 0);
+	CyCtxt sample = encrypt(zeros);
+	m_matMulCostModel = MatMulCostModel::calibrate(*m_encryptedArray, sample);
+	if(m_isVerbose)
+	{
+		std::cout << "  - Calibrated the cost model: rotateGood=" << m_matMulCostModel.rotateGood << ", rotateBad="
+		<< m_matMulCostModel.rotateBad << ", multConst=" << m_matMulCostModel.multConst << endl;
+	}
+}
+
 // KEY GENERATION
 /*
 	@name: keyGen
@@ -262,7 +609,8 @@ void Cyfhel::setm_isVerbose(bool isVerbose) {
 
 	@return: null.
 */
-void Cyfhel::keyGen(long const& p, long const& r, long const& c, long const& d, long const& sec, long const& w, long L, long m, long const& R, long const& s, const vector<long>& gens, const vector<long>& ords) {
+void Cyfhel::keyGen(long const& p, long const& r, long const& c, long const& d, long const& sec, long const& w, long L, long m, long const& R, long const& s, const vector<long>& gens, const vector<long>& ords, const vector<long>& mvec) {
+	applyExecutionPolicy();
 	if(m_isVerbose)
 	{
 		std::cout << "Cyfhel::keyGen START" << endl;
@@ -296,8 +644,27 @@ void Cyfhel::keyGen(long const& p, long const& r, long const& c, long const& d,
 	m_global_m = m;
 	m_global_p = p;
 	m_global_r = r;
+	clearCaches();// The cached objects were built on the previous context
 	m_context = new FHEcontext(m, p, r, gens, ords);  // Initialize context
-	buildModChain(*m_context, L, c);                  // Add primes to modulus chain
+	if(mvec.empty())
+	{
+		buildModChain(*m_context, L, c);              // Add primes to modulus chain
+	}
+	else
+	{
+		// The extra bits are needed when the context is made bootstrappable after buildModChain (see Test_bootstrapping).
+		buildModChain(*m_context, L, c, 7);
+		Vec<long> mvecNTL;
+		for(unsigned long i=0; i<mvec.size(); i++)
+		{
+			append(mvecNTL, mvec[i]);
+		}
+		m_context->makeBootstrappable(mvecNTL);
+		if(m_isVerbose)
+		{
+			std::cout << "  - Made the context bootstrappable: mvec=" << mvec << endl;
+		}
+	}
 	if(m_isVerbose)
 	{
 		std::cout << "  - Created Context: "
@@ -333,8 +700,18 @@ void Cyfhel::keyGen(long const& p, long const& r, long const& c, long const& d,
 
 	// Additional initializations
 	addSome1DMatrices(*m_secretKey);// Key-switch matrices for relin.
+	if(m_context->isBootstrappable())
+	{
+		addFrbMatrices(*m_secretKey);// Key-switch matrices for the Frobenius of the recryption
+		m_secretKey->genRecryptData();// Bootstrapping key
+		if(m_isVerbose)
+		{
+			std::cout << "  - Created the bootstrapping key" << endl;
+		}
+	}
 	m_encryptedArray = new EncryptedArray(*m_context, m_G);// Object for packing in subfields
 	m_numberOfSlots = m_encryptedArray->size();
+	calibrateMatMul();// Costs of the products by a matrix on this context
 
 	if(m_isVerbose)
 	{
@@ -434,6 +811,8 @@ return poly;
 */
 CyCtxt Cyfhel::polynomialEval(vector<long>& vectorPtsEval, vector<long> const& coeffPoly){
 
+   applyExecutionPolicy();
+
    if(m_isVerbose){
    // Cout the vector that contains the evaluation points.
    std::cout <<"vector X of fixed points -> "<< vectorPtsEval <<endl;
@@ -471,8 +850,8 @@ CyCtxt Cyfhel::polynomialEval(vector<long>& vectorPtsEval, vector<long> const& c
    // ***Evaluate the polynome by each cypher elements of the CyCtxt containing the cypher evaluation points.***
    // Creation of a CyCtxt to contain the result CyCtxt of the polynomial evaluation.
    CyCtxt cEvalPoly = cx; 
-   // Evaluate poly on the ciphertext.
-   polyEval(cEvalPoly, poly, cx, 0);
+   // Evaluate poly on the ciphertext, with the baby-step parameters chosen by the cost model (cached per polynomial).
+   polyEval(cEvalPoly, poly, cx, optimizePolyEval(poly, cx.getPtxtSpace()));
 
 return cEvalPoly;
  
@@ -495,6 +874,8 @@ return cEvalPoly;
 */
 CyCtxt Cyfhel::polynomialEval(vector<long>& vectorPtsEval, ZZX const& poly){
 
+   applyExecutionPolicy();
+
    const long d = deg(poly);
 
    if(m_isVerbose){
@@ -522,8 +903,8 @@ CyCtxt Cyfhel::polynomialEval(vector<long>& vectorPtsEval, ZZX const& poly){
    // ***Evaluate the polynome by each cypher elements of the CyCtxt containing the cypher evaluation points.***
    // Creation of a CyCtxt to contain the result CyCtxt of the polynomial evaluation.
    CyCtxt cEvalPoly = cx; 
-   // Evaluate poly on the ciphertext.
-   polyEval(cEvalPoly, poly, cx, 0);
+   // Evaluate poly on the ciphertext, with the baby-step parameters chosen by the cost model (cached per polynomial).
+   polyEval(cEvalPoly, poly, cx, optimizePolyEval(poly, cx.getPtxtSpace()));
 
 return cEvalPoly;
  
@@ -532,6 +913,835 @@ return cEvalPoly;
 
 
 
+/*
+	@name: polynomialEvalBatch
+	@description: Evaluate the same polynome on many CyCtxt already encrypted: vectorCtxt = [P(c1), P(c2), ..., P(cn)].
+                  The parameters of the evaluation (see optimizePolyEval), the monic transformation of the polynome, its
+                  decomposition and its reduced coefficients are computed once for all the CyCtxt (see PolyEvalPrecomp).
+                  Then the CyCtxt are evaluated in parallel (see forEachTask): on the default CyWorkStealingPool, or on
+                  a pool following the execution policy of this object if it has one.
+
+	@param: The method polynomialEvalBatch takes two mandatory parameters: a vector of CyCtxt and a ZZX.
+	-param1: a mandatory vector of CyCtxt which corresponds to the encrypted evaluation points, replaced by the results.
+    -param2: a mandatory ZZX which corresponds to the polynome.
+*/
+void Cyfhel::polynomialEvalBatch(vector<CyCtxt>& vectorCtxt, ZZX const& poly){
+
+   applyExecutionPolicy();
+
+   if(vectorCtxt.empty())
+   {
+      return;
+   }
+
+   const long ptxtSpace = vectorCtxt[0].getPtxtSpace();
+   const PolyEvalPrecomp precomp(poly, ptxtSpace, optimizePolyEval(poly, ptxtSpace));
+
+   if(m_isVerbose){
+   std::cout << "Evaluation of a polynome of degree " << deg(poly) << " on " << vectorCtxt.size() << " CyCtxt, plan " << precomp.getPlan() << endl;
+   }
+
+   forEachTask(vectorCtxt.size(), [&precomp, &vectorCtxt](long i) {
+      // Each task only writes its own CyCtxt.
+      vectorCtxt[i].recryptIfNeeded();
+      CyCtxt result = vectorCtxt[i];
+      precomp.eval(result, vectorCtxt[i]);
+      vectorCtxt[i] = result;
+   });
+}
+
+
+/*
+	@name: lookupTablePolynome
+	@description: Interpolate the lookup table into a polynome P of degree < table.size() such as P(x) = table[x] mod ptxtSpace
+                  for 0 <= x < table.size(). ptxtSpace = p^e is lifted from mod p as in extractDigits (see interpolateMod), so the
+                  points 0, ..., table.size()-1 must be distinct mod p: table.size() <= p. The polynomes are cached per table.
+
+	@param: The method lookupTablePolynome takes one mandatory parameter and one optional parameter: a vector of long and a long.
+	-param1: a mandatory vector of long which corresponds to the lookup table.
+    -param2 (optional)(Default: 0): a long which corresponds to the plaintext space, a power of p. If 0, p^r is used.
+
+    @return: Return a ZZX: the polynome P, or the zero polynome if the table is empty or too large.
+*/
+ZZX Cyfhel::lookupTablePolynome(vector<long> const& table, long ptxtSpace) const {
+	const long p = m_context->zMStar.getP();
+	if(ptxtSpace <= 0)
+	{
+		ptxtSpace = getp2r();
+	}
+	if(table.empty() || (long) table.size() > p)
+	{
+		cerr<<"Error: the size of the lookup table ("<<table.size()<<") must be between 1 and p = "<<p<<"."<<endl;
+		return ZZX();
+	}
+
+	pair< long, vector<long> > key(ptxtSpace, table);
+	{
+		lock_guard<mutex> lock(lookupTableCacheMutex);
+		map< pair< long, vector<long> >, ZZX >::const_iterator it = lookupTableCache.find(key);
+		if(it != lookupTableCache.end())
+		{
+			return it->second;
+		}
+	}
+
+	// ptxtSpace = p^e.
+	long e = 0;
+	for(long pe = 1; pe < ptxtSpace; pe *= p)
+	{
+		e++;
+	}
+
+	vec_long x(INIT_SIZE, table.size());
+	vec_long y(INIT_SIZE, table.size());
+	for(long i=0; i<(long) table.size(); i++)
+	{
+		x[i] = i;
+		y[i] = table[i] % ptxtSpace;
+		if(y[i] < 0)
+		{
+			y[i] += ptxtSpace;
+		}
+	}
+	ZZX poly;
+	interpolateMod(poly, x, y, p, e);
+
+	lock_guard<mutex> lock(lookupTableCacheMutex);
+	lookupTableCache[key] = poly;
+	return poly;
+}
+
+/*
+	@name: applyLookupTable
+	@description: Replace each slot value x of cyctxt by table[x]: the cached polynome of the table (see lookupTablePolynome)
+                  is evaluated with polyEval, with the parameters chosen by optimizePolyEval. The slot values must be in
+                  0, ..., table.size()-1, the other values give unspecified results. Useful for thresholds and buckets.
+
+	@param: The method applyLookupTable takes two mandatory parameters: a CyCtxt and a vector of long.
+	-param1: a mandatory CyCtxt which corresponds to the encrypted values, replaced by the encrypted table[x].
+    -param2: a mandatory vector of long which corresponds to the lookup table, of size at most p.
+*/
+void Cyfhel::applyLookupTable(CyCtxt& cyctxt, vector<long> const& table){
+
+   applyExecutionPolicy();
+
+   if(table.empty() || (long) table.size() > m_context->zMStar.getP())
+   {
+      cerr<<"Error: the size of the lookup table ("<<table.size()<<") must be between 1 and p = "<<m_context->zMStar.getP()<<"."<<endl;
+      return;
+   }
+
+   cyctxt.recryptIfNeeded();
+   const long ptxtSpace = cyctxt.getPtxtSpace();
+   ZZX poly = lookupTablePolynome(table, ptxtSpace);
+
+   if(m_isVerbose){
+   std::cout << "Lookup table of size " << table.size() << " -> polynome of degree " << deg(poly) << endl;
+   }
+
+   CyCtxt result = cyctxt;
+   polyEval(result, poly, cyctxt, optimizePolyEval(poly, ptxtSpace));
+   cyctxt = result;
+}
+
+
+/*
+	@name: maxOfVector
+	@description: Maximum of the values in the n first slots of cyctxt, by a tournament over rotations inside the ciphertext:
+                  at round k, the slot i keeps the maximum of itself and of the slot i+2^k, so after log(n) rounds the slot 0
+                  holds the maximum of the slots 0, ..., n-1. The bits of the values are extracted once for all the slots
+                  (extractDigits), then each round rotates the bits, compares them (CyCtxt::compareBits) and keeps the bits of
+                  the winner, and the bits of the maximum are recombined at the end. On ties the lowest index wins.
+                  The slot values must be integers of nbits bits (see CyCtxt::comparisonBits), the plaintext base p must be 2.
+
+	@param: The method maxOfVector takes one mandatory parameter and three optional parameters: a CyCtxt, a long, a long and a pointer to a CyCtxt.
+	-param1: a mandatory CyCtxt which corresponds to the encrypted vector.
+    -param2 (optional)(Default: 0): a long which corresponds to the number of values. If 0, all the slots.
+    -param3 (optional)(Default: 0): a long which corresponds to the number of bits of the values. If 0, the maximum for p^r.
+    -param4 (optional)(Default: 0): a pointer to a CyCtxt which gets the index of the maximum in its slot 0.
+
+    @return: Return a CyCtxt whose slot 0 is the maximum (the other slots hold partial maxima).
+*/
+CyCtxt Cyfhel::maxOfVector(CyCtxt const& cyctxt, long n, long nbits, CyCtxt *argmax){
+
+   applyExecutionPolicy();
+
+   CyCtxt result(cyctxt);
+   nbits = CyCtxt::comparisonBits(cyctxt, nbits);
+   if(nbits == 0)
+   {
+      return result;
+   }
+   if(n <= 0 || n > m_numberOfSlots)
+   {
+      n = m_numberOfSlots;
+   }
+
+   // The comparisons are computed mod 2^(r-nbits+1): the indexes must fit in it.
+   if(argmax && (n-1) >= (1L << (cyctxt.effectiveR()-nbits+1)))
+   {
+      cerr << "maxOfVector: the indexes do not fit in the plaintext space of the comparisons, argmax is not valid." << endl;
+   }
+
+   // The rounds also read the slots n, ..., 2^ceil(log(n))-1: they are set to 0, which never wins.
+   Ctxt input = cyctxt;
+   if(n < m_numberOfSlots)
+   {
+      vector<long> mask(m_numberOfSlots, 0);
+      for(long i=0; i<n; i++)
+      {
+         mask[i] = 1;
+      }
+      ZZX encodedMask;
+      m_encryptedArray->encode(encodedMask, mask);
+      input.multByConstant(encodedMask);
+   }
+
+   vector<Ctxt> bits;
+   extractDigits(bits, input, nbits);
+
+   // The index of the current winner of each slot, in plaintext until the first round.
+   vector<long> index(m_numberOfSlots);
+   for(long i=0; i<m_numberOfSlots; i++)
+   {
+      index[i] = i;
+   }
+   Ctxt cIndex(*m_publicKey, cyctxt.getPtxtSpace());
+
+   for(long shift=1; shift<n; shift*=2)
+   {
+      if(m_isVerbose){
+      std::cout << "maxOfVector: round with shift " << shift << endl;
+      }
+
+      // The bits of the slot i+shift, brought to the slot i.
+      vector<Ctxt> other = bits;
+      for(unsigned long j=0; j<other.size(); j++)
+      {
+         m_encryptedArray->rotate(other[j], -shift);
+      }
+      Ctxt greater = CyCtxt::compareBits(other, bits);
+
+      // bits += [other > bits] * (other - bits)
+      for(unsigned long j=0; j<bits.size(); j++)
+      {
+         Ctxt difference = other[j];
+         difference -= bits[j];
+         difference.multiplyBy(greater);
+         bits[j] += difference;
+      }
+
+      if(argmax)
+      {
+         if(shift == 1)
+         {
+            // The indexes are still known: index + greater * (rotated index - index).
+            vector<long> difference(m_numberOfSlots);
+            for(long i=0; i<m_numberOfSlots; i++)
+            {
+               difference[i] = index[(i+shift) % m_numberOfSlots] - index[i];
+            }
+            ZZX encodedDifference, encodedIndex;
+            m_encryptedArray->encode(encodedDifference, difference);
+            m_encryptedArray->encode(encodedIndex, index);
+            cIndex = greater;
+            cIndex.multByConstant(encodedDifference);
+            cIndex.addConstant(encodedIndex);
+         }
+         else
+         {
+            Ctxt difference = cIndex;
+            m_encryptedArray->rotate(difference, -shift);
+            difference -= cIndex;
+            difference.multiplyBy(greater);
+            cIndex += difference;
+         }
+      }
+   }
+
+   // result = sum of bits[j] * 2^j
+   Ctxt& resultCtxt = result;
+   resultCtxt = bits.back();
+   for(long j=bits.size()-2; j>=0; j--)
+   {
+      resultCtxt.multByConstant(to_ZZ(2));
+      resultCtxt += bits[j];
+   }
+
+   if(argmax)
+   {
+      *argmax = cyctxt;
+      Ctxt& argmaxCtxt = *argmax;
+      if(n > 1)
+      {
+         argmaxCtxt = cIndex;
+      }
+      else
+      {
+         m_publicKey->Encrypt(argmaxCtxt, ZZX(0), cyctxt.getPtxtSpace());
+      }
+   }
+   return result;
+}
+
+
+/*
+	@name: recryptBatch
+	@description: Recrypt all the CyCtxt of vectorCtxt. A CyCtxt only uses its m_sizeOfPlaintext first slots, so several CyCtxt
+                  are packed into one ciphertext (each one masked and rotated to its own slots), the packed ciphertext is
+                  recrypted once and the CyCtxt are unpacked (rotated back and masked). The masks are encoded once per size.
+                  Only the m_sizeOfPlaintext first slots of each CyCtxt are kept, the other slots are 0 after the recryption.
+                  The packed ciphertexts are recrypted in parallel following the execution policy.
+
+	@param: The method recryptBatch takes one mandatory parameter: a vector of CyCtxt.
+	-param1: a mandatory vector of CyCtxt which corresponds to the ciphertexts to recrypt, in place.
+*/
+void Cyfhel::recryptBatch(vector<CyCtxt>& vectorCtxt){
+
+   applyExecutionPolicy();
+
+   if(!isBootstrappable())
+   {
+      cerr<<"Error: cannot recrypt, the scheme is not bootstrappable (see the constructor with mvec)."<<endl;
+      return;
+   }
+   if(vectorCtxt.empty())
+   {
+      return;
+   }
+
+   const double start = GetTime();
+
+   // Number of slots of each CyCtxt.
+   vector<long> sizes(vectorCtxt.size());
+   for(unsigned long i=0; i<vectorCtxt.size(); i++)
+   {
+      if(&vectorCtxt[i].getPubKey() == m_publicKey)
+      {
+         vectorCtxt[i].setm_publicKey(m_publicKey);// Encrypted with the key of this object, e.g. built from the public key
+      }
+      sizes[i] = vectorCtxt[i].getm_sizeOfPlaintext();
+      if(sizes[i] <= 0 || sizes[i] > m_numberOfSlots)
+      {
+         sizes[i] = m_numberOfSlots;
+      }
+   }
+
+   // First fit of the CyCtxt in packs of m_numberOfSlots slots with the same plaintext space.
+   // packs[b] holds the pairs (index in vectorCtxt, first slot in the pack).
+   vector< vector< pair<long, long> > > packs;
+   vector<long> packsUsedSlots, packsPtxtSpace;
+   for(unsigned long i=0; i<vectorCtxt.size(); i++)
+   {
+      const long ptxtSpace = vectorCtxt[i].getPtxtSpace();
+      unsigned long b = 0;
+      while(b < packs.size() && (packsPtxtSpace[b] != ptxtSpace || packsUsedSlots[b] + sizes[i] > m_numberOfSlots))
+      {
+         b++;
+      }
+      if(b == packs.size())
+      {
+         packs.push_back(vector< pair<long, long> >());
+         packsUsedSlots.push_back(0);
+         packsPtxtSpace.push_back(ptxtSpace);
+      }
+      packs[b].push_back(make_pair((long) i, packsUsedSlots[b]));
+      packsUsedSlots[b] += sizes[i];
+   }
+
+   if(m_isVerbose){
+   std::cout << "recryptBatch: " << vectorCtxt.size() << " CyCtxt packed in " << packs.size() << " recryptions" << endl;
+   }
+
+   // Pack, recrypt once and unpack the CyCtxt of the pack b.
+   auto recryptPack = [this, &vectorCtxt, &packs, &sizes](long b) {
+      vector< pair<long, long> > const& pack = packs[b];
+      if(pack.size() == 1)
+      {
+         // Alone in its pack: only the unused slots are cleared, there is nothing to rotate.
+         CyCtxt& alone = vectorCtxt[pack[0].first];
+         if(sizes[pack[0].first] < m_numberOfSlots)
+         {
+            Ctxt& aloneCtxt = alone;
+            aloneCtxt.multByConstant(*packingMask(sizes[pack[0].first]));
+         }
+         alone.recrypt();
+         return;
+      }
+      CyCtxt packed(vectorCtxt[pack[0].first]);
+      Ctxt& packedCtxt = packed;
+      packedCtxt = Ctxt(ZeroCtxtLike, vectorCtxt[pack[0].first]);
+      for(unsigned long k=0; k<pack.size(); k++)
+      {
+         Ctxt part = vectorCtxt[pack[k].first];
+         part.multByConstant(*packingMask(sizes[pack[k].first]));
+         m_encryptedArray->rotate(part, pack[k].second);
+         packedCtxt += part;
+      }
+      packed.recrypt();
+      for(unsigned long k=0; k<pack.size(); k++)
+      {
+         Ctxt part = packedCtxt;
+         m_encryptedArray->rotate(part, -pack[k].second);
+         part.multByConstant(*packingMask(sizes[pack[k].first]));
+         Ctxt& target = vectorCtxt[pack[k].first];
+         target = part;
+      }
+   };
+
+   forEachTask(packs.size(), recryptPack);
+
+   lock_guard<mutex> lock(m_recryptBatchMutex);
+   m_recryptedCtxts += vectorCtxt.size();
+   m_recryptSeconds += GetTime() - start;
+}
+
+/*
+	@name: recryptionsPerSecond
+	@description: Throughput of recryptBatch so far: the number of CyCtxt recrypted divided by the time spent in recryptBatch.
+
+	@param: null.
+
+    @return: Return a double, 0 if recryptBatch was never called.
+*/
+double Cyfhel::recryptionsPerSecond() const {
+   lock_guard<mutex> lock(m_recryptBatchMutex);
+   if(m_recryptSeconds <= 0)
+   {
+      return 0;
+   }
+   return m_recryptedCtxts/m_recryptSeconds;
+}
+
+/*
+	@name: matrix
+	@description: Give the handle of a plaintext matrix, to multiply encrypted vectors by it (matVecMul). The handle is
+	              created at the first call for these entries and kept by this object until the context changes (keyGen,
+	              restoreEnv), so that the constants of its diagonals are only built once. The handles are found by a hash
+	              of the entries, checked against the entries of the matrix. At most maxMatrices handles are kept, the
+	              least recently used one is dropped first: to multiply by many matrices, keep their handles.
+	              A kept handle built with another variant (when variant is not automatic) or another cache file is rebuilt.
+
+	@param: The method matrix takes one mandatory parameter and two optional parameters: a vector<vector<long>>, a Variant and a string.
+	-param1: a mandatory vector<vector<long>> which corresponds to the entries of the matrix, row by row.
+	-param2 (optional)(Default: automatic): dense, sparse, or automatic to choose with the cost model of planMatMul
+	                                        measured on this context (see getm_matMulCostModel).
+	-param3 (optional)(Default: ""): the file where the constants are kept from one run to the next (see CyMatrix), "" for none.
+
+	@return: Return a shared_ptr to the CyMatrix.
+*/
+std::shared_ptr<CyMatrix> Cyfhel::matrix(vector< vector<long> > const& data, CyMatrix::Variant variant, string const& cacheFile){
+   long rows = data.size();
+   unsigned long hash = fnv1a(&rows, sizeof(rows));
+   for(long i=0; i<rows; i++)
+   {
+      long size = data[i].size();
+      hash = fnv1a(&size, sizeof(size), hash);
+      if(size > 0)
+      {
+         hash = fnv1a(data[i].data(), size*sizeof(long), hash);
+      }
+   }
+
+   lock_guard<mutex> lock(m_matricesMutex);
+   map< unsigned long, pair< std::shared_ptr<CyMatrix>, unsigned long > >::iterator it = m_matrices.find(hash);
+   if(it != m_matrices.end())
+   {
+      CyMatrix const& kept = *it->second.first;
+      if(kept.hasEntries(data) && (variant == CyMatrix::automatic || variant == kept.getm_variant()) &&
+         cacheFile == kept.getm_cacheFile())
+      {
+         it->second.second = ++m_matricesClock;
+         return it->second.first;
+      }
+      // Another matrix with the same hash, or the same one built differently: replace it.
+      m_matrices.erase(it);
+   }
+   if(m_matrices.size() >= maxMatrices)
+   {
+      map< unsigned long, pair< std::shared_ptr<CyMatrix>, unsigned long > >::iterator oldest = m_matrices.begin();
+      for(it = m_matrices.begin(); it != m_matrices.end(); ++it)
+      {
+         if(it->second.second < oldest->second.second)
+         {
+            oldest = it;
+         }
+      }
+      m_matrices.erase(oldest);
+   }
+   std::shared_ptr<CyMatrix> handle(new CyMatrix(*m_encryptedArray, data, variant, cacheFile, m_matMulCostModel));
+   if(m_isVerbose)
+   {
+      std::cout << "New " << *handle << endl;
+   }
+   m_matrices[hash] = make_pair(handle, ++m_matricesClock);
+   return handle;
+}
+
+/*
+	@name: matVecMul
+	@description: Replace cyctxt, an encryption of the vector x, by an encryption of the product M*x. The first product
+	              by a matrix builds the constants of its diagonals, the next ones reuse them. Several threads can use
+	              the same matrix at the same time. The product uses one level.
+
+	@param: The method matVecMul takes two mandatory parameters: a CyCtxt and a CyMatrix.
+	-param1: a mandatory CyCtxt which corresponds to the encrypted vector x, replaced by M*x.
+	-param2: a mandatory CyMatrix which corresponds to M, created for this object.
+*/
+void Cyfhel::matVecMul(CyCtxt& cyctxt, CyMatrix& matrix){
+   applyExecutionPolicy();
+   matrix.multiply(cyctxt);
+}
+
+/*
+	@name: matVecMul
+	@description: Same as matVecMul with the handle of the matrix given by the method matrix.
+
+	@param: The method matVecMul takes two mandatory parameters: a CyCtxt and a vector<vector<long>>.
+	-param1: a mandatory CyCtxt which corresponds to the encrypted vector x, replaced by M*x.
+	-param2: a mandatory vector<vector<long>> which corresponds to the entries of M, row by row.
+*/
+void Cyfhel::matVecMul(CyCtxt& cyctxt, vector< vector<long> > const& data){
+   matVecMul(cyctxt, *matrix(data));
+}
+
+/*
+	@name: slotLayout
+	@description: Choose where the entries of a rows x cols matrix go in the slots (see CySlotLayout), so that the
+	              rotations of the workload run along the cheapest dimensions of the hypercube. Encrypt the slot values
+	              given by the encode method of the layout, decrypt with isDecryptedPtxt_vectResize = false and decode.
+
+	@param: The method slotLayout takes one mandatory parameter and three optional parameters: four long.
+	-param1: a mandatory long which corresponds to the number of rows.
+	-param2 (optional)(Default: 1): the number of columns, 1 for a vector.
+	-param3 (optional)(Default: 0): the number of rotations (or sum steps) along the rows in the workload.
+	-param4 (optional)(Default: 0): the number of rotations (or sum steps) along the columns in the workload.
+
+	@return: Return the CySlotLayout.
+*/
+CySlotLayout Cyfhel::slotLayout(long rows, long cols, long rowAxisRotations, long colAxisRotations) const {
+   CySlotLayout layout(*m_encryptedArray, rows, cols, rowAxisRotations, colAxisRotations, m_matMulCostModel);
+   if(m_isVerbose)
+   {
+      std::cout << layout << endl;
+   }
+   return layout;
+}
+
+/*
+	@name: encryptMatrix
+	@description: Encrypt a matrix column by column: each column is cut in tiles of m_numberOfSlots rows, each tile
+	              encrypted in a CyCtxt (see CyCtxtMatrix). All the rows must have the same size.
+
+	@param: The method encryptMatrix takes one mandatory parameter: a vector<vector<long>>.
+	-param1: a mandatory vector<vector<long>> which corresponds to the entries of the matrix, row by row.
+
+	@return: Return the CyCtxtMatrix.
+*/
+CyCtxtMatrix Cyfhel::encryptMatrix(vector< vector<long> > const& data) const {
+   if(data.empty() || data[0].empty())
+   {
+      cerr<<"Error: cannot encrypt an empty matrix."<<endl;
+   }
+   CyCtxtMatrix matrix(max(1L, (long) data.size()), max(1L, data.empty() ? 0L : (long) data[0].size()), m_numberOfSlots);
+   for(long j=0; j<matrix.getm_cols(); j++)
+   {
+      vector<CyCtxt> tiles;
+      for(long t=0; t<matrix.rowTiles(); t++)
+      {
+         vector<long> column;
+         for(long i=t*m_numberOfSlots; i<t*m_numberOfSlots + matrix.tileSize(t); i++)
+         {
+            column.push_back(i < (long) data.size() && j < (long) data[i].size() ? data[i][j] : 0);
+         }
+         tiles.push_back(encrypt(column));
+      }
+      matrix.setColumn(j, tiles);
+   }
+   return matrix;
+}
+
+/*
+	@name: decryptMatrix
+	@description: Decrypt a CyCtxtMatrix.
+
+	@param: The method decryptMatrix takes one mandatory parameter: a CyCtxtMatrix.
+	-param1: a mandatory CyCtxtMatrix which corresponds to the encrypted matrix.
+
+	@return: Return the entries of the matrix, row by row.
+*/
+vector< vector<long> > Cyfhel::decryptMatrix(CyCtxtMatrix& matrix) const {
+   vector< vector<long> > data(matrix.getm_rows(), vector<long>(matrix.getm_cols(), 0));
+   for(long j=0; j<matrix.getm_cols(); j++)
+   {
+      if((long) matrix.column(j).size() != matrix.rowTiles())
+      {
+         cerr<<"Error: the column "<<j<<" of the encrypted matrix is not set."<<endl;
+         continue;
+      }
+      for(long t=0; t<matrix.rowTiles(); t++)
+      {
+         vector<long> column = decrypt(matrix.tile(j, t), false);
+         for(long i=0; i<matrix.tileSize(t); i++)
+         {
+            data[t*matrix.getm_tileRows() + i][j] = column[i];
+         }
+      }
+   }
+   return data;
+}
+
+/*
+	@name: matMul
+	@description: Product of the encrypted matrix A (n x k) by the plaintext matrix B (k x m). The column l of the result
+	              is the sum of the columns j of A multiplied by the constants B[j][l] (the zero entries are skipped), so
+	              no rotation is needed. The columns of the result are computed concurrently following the execution
+	              policy. The product uses no level.
+
+	@param: The method matMul takes two mandatory parameters: a CyCtxtMatrix and a vector<vector<long>>.
+	-param1: a mandatory CyCtxtMatrix which corresponds to A.
+	-param2: a mandatory vector<vector<long>> which corresponds to the entries of B, row by row.
+
+	@return: Return the CyCtxtMatrix A*B.
+*/
+CyCtxtMatrix Cyfhel::matMul(CyCtxtMatrix const& A, vector< vector<long> > const& B){
+   applyExecutionPolicy();
+   if((long) B.size() != A.getm_cols() || B[0].empty() || !A.isComplete())
+   {
+      cerr<<"Error: cannot multiply a "<<A.getm_rows()<<"x"<<A.getm_cols()<<" encrypted matrix by a "<<B.size()<<" rows matrix."<<endl;
+      return CyCtxtMatrix(A.getm_rows(), A.getm_cols(), A.getm_tileRows());
+   }
+   const long p2r = getp2r();
+   const long m = B[0].size();
+   CyCtxtMatrix product(A.getm_rows(), m, A.getm_tileRows());
+
+   forEachTask(m, [&A, &B, &product, p2r](long l) {
+      vector<CyCtxt> tiles;
+      for(long t=0; t<A.rowTiles(); t++)
+      {
+         CyCtxt tile(A.tile(0, t));
+         Ctxt& acc = tile;
+         acc = Ctxt(ZeroCtxtLike, A.tile(0, t));
+         for(long j=0; j<A.getm_cols(); j++)
+         {
+            const long b = l < (long) B[j].size() ? ((B[j][l] % p2r) + p2r) % p2r : 0;
+            if(b == 0)
+            {
+               continue;
+            }
+            Ctxt term = A.tile(j, t);
+            term.multByConstant(to_ZZ(b));
+            acc += term;
+         }
+         tile.setm_sizeOfPlaintext(A.tileSize(t));
+         tiles.push_back(tile);
+      }
+      product.setColumn(l, tiles);
+   });
+   return product;
+}
+
+/*
+	@name: matMul
+	@description: Product of the encrypted matrices A (n x k) and B (k x m). Each entry B[j][l] is replicated in all the
+	              slots of a ciphertext (replicateAll when most of the slots of the tile are used, one replicate per slot
+	              otherwise), then multiplied by the column j of A: the column l of the result is the sum of these
+	              products, relinearized once per tile. The columns of the result are computed concurrently following the
+	              execution policy. The product uses one level.
+
+	@param: The method matMul takes two mandatory parameters: a CyCtxtMatrix and a CyCtxtMatrix.
+	-param1: a mandatory CyCtxtMatrix which corresponds to A.
+	-param2: a mandatory CyCtxtMatrix which corresponds to B.
+
+	@return: Return the CyCtxtMatrix A*B.
+*/
+CyCtxtMatrix Cyfhel::matMul(CyCtxtMatrix const& A, CyCtxtMatrix const& B){
+   applyExecutionPolicy();
+   if(B.getm_rows() != A.getm_cols() || B.getm_tileRows() != A.getm_tileRows() || !A.isComplete() || !B.isComplete())
+   {
+      cerr<<"Error: cannot multiply a "<<A.getm_rows()<<"x"<<A.getm_cols()<<" encrypted matrix by a "<<B.getm_rows()<<"x"<<B.getm_cols()<<" one."<<endl;
+      return CyCtxtMatrix(A.getm_rows(), B.getm_cols(), A.getm_tileRows());
+   }
+   CyCtxtMatrix product(A.getm_rows(), B.getm_cols(), A.getm_tileRows());
+   EncryptedArray const& ea = *m_encryptedArray;
+   // Under this number of used slots, replicating them one by one is cheaper than replicateAll.
+   const long replicateAllBound = max(1L, (long) (m_numberOfSlots/log2((double) max(2L, m_numberOfSlots))));
+
+   forEachTask(B.getm_cols(), [&A, &B, &product, &ea, replicateAllBound](long l) {
+      vector<Ctxt> acc;
+      for(long t=0; t<A.rowTiles(); t++)
+      {
+         acc.push_back(Ctxt(ZeroCtxtLike, A.tile(0, t)));
+      }
+      for(long u=0; u<B.rowTiles(); u++)
+      {
+         const long offset = u*B.getm_tileRows();
+         // Add A[., offset+s] * B[offset+s][l] to the column l.
+         auto process = [&A, &acc, offset](long s, Ctxt const& replicated) {
+            for(long t=0; t<A.rowTiles(); t++)
+            {
+               Ctxt term = A.tile(offset + s, t);
+               term *= replicated;
+               acc[t] += term;
+            }
+         };
+         const long used = B.tileSize(u);
+         if(used >= replicateAllBound)
+         {
+            ColumnReplicator handler(used, process);
+            replicateAll(ea, B.tile(l, u), &handler);
+         }
+         else
+         {
+            for(long s=0; s<used; s++)
+            {
+               Ctxt replicated = B.tile(l, u);
+               replicate(ea, replicated, s);
+               process(s, replicated);
+            }
+         }
+      }
+      vector<CyCtxt> tiles;
+      for(long t=0; t<A.rowTiles(); t++)
+      {
+         acc[t].reLinearize();
+         CyCtxt tile(A.tile(0, t));
+         Ctxt& tileCtxt = tile;
+         tileCtxt = acc[t];
+         tile.setm_sizeOfPlaintext(A.tileSize(t));
+         tiles.push_back(tile);
+      }
+      product.setColumn(l, tiles);
+   });
+   return product;
+}
+
+
+/*
+	@name: segmentsPerCtxt
+	@description: Number of segments of width slots packed in a CyCtxt: m_numberOfSlots/width.
+
+	@param: The method segmentsPerCtxt takes one mandatory parameter: a long.
+	-param1: a mandatory long which corresponds to the width of the segments.
+
+	@return: Return the number of segments, 0 if width is not between 1 and m_numberOfSlots.
+*/
+long Cyfhel::segmentsPerCtxt(long width) const {
+   if(width < 1 || width > m_numberOfSlots)
+   {
+      return 0;
+   }
+   return m_numberOfSlots/width;
+}
+
+/*
+	@name: packSegments
+	@description: Lay out vectors in consecutive segments of width slots, the layout of CyCtxt::segmentSum and
+	              CyCtxt::segmentScalarProd: the vector s goes to the slots s*width, s*width+1, ..., padded with zeros up
+	              to the next segment. At most segmentsPerCtxt(width) vectors, of at most width values each.
+
+	@param: The method packSegments takes two mandatory parameters: a vector<vector<long>> and a long.
+	-param1: a mandatory vector<vector<long>> which corresponds to the vectors.
+	-param2: a mandatory long which corresponds to the width of the segments.
+
+	@return: Return the m_numberOfSlots slot values, empty if the vectors do not fit.
+*/
+vector<long> Cyfhel::packSegments(vector< vector<long> > const& vectors, long width) const {
+   if((long) vectors.size() > segmentsPerCtxt(width))
+   {
+      cerr<<"Error: at most "<<segmentsPerCtxt(width)<<" segments of "<<width<<" slots fit in a CyCtxt."<<endl;
+      return vector<long>();
+   }
+   vector<long> slots(m_numberOfSlots, 0);
+   for(long s=0; s<(long) vectors.size(); s++)
+   {
+      if((long) vectors[s].size() > width)
+      {
+         cerr<<"Error: the vector "<<s<<" does not fit in a segment of "<<width<<" slots."<<endl;
+         return vector<long>();
+      }
+      std::copy(vectors[s].begin(), vectors[s].end(), slots.begin() + s*width);
+   }
+   return slots;
+}
+
+/*
+	@name: encryptSegments
+	@description: Encrypt vectors laid out in segments of width slots (see packSegments).
+
+	@param: The method encryptSegments takes two mandatory parameters: a vector<vector<long>> and a long.
+	-param1: a mandatory vector<vector<long>> which corresponds to the vectors.
+	-param2: a mandatory long which corresponds to the width of the segments.
+
+	@return: Return the CyCtxt.
+*/
+CyCtxt Cyfhel::encryptSegments(vector< vector<long> > const& vectors, long width) const {
+   vector<long> slots = packSegments(vectors, width);
+   return encrypt(slots);
+}
+
+/*
+	@name: unpackSegments
+	@description: Results of a segmented reduction: the first slot of each segment of width slots (all the slots of a
+	              segment hold its result after CyCtxt::segmentSum).
+
+	@param: The method unpackSegments takes two mandatory parameters and one optional parameter: a vector<long>, a long and
+	        a long.
+	-param1: a mandatory vector<long> which corresponds to the decrypted slots.
+	-param2: a mandatory long which corresponds to the width of the segments.
+	-param3 (optional)(Default: 0): the number of segments to return, 0 for segmentsPerCtxt(width).
+
+	@return: Return the value of each segment.
+*/
+vector<long> Cyfhel::unpackSegments(vector<long> const& slots, long width, long count) const {
+   long segments = std::min(segmentsPerCtxt(width), width > 0 ? (long) slots.size()/width : 0L);
+   if(count <= 0 || count > segments)
+   {
+      count = segments;
+   }
+   vector<long> values(count);
+   for(long s=0; s<count; s++)
+   {
+      values[s] = slots[s*width];
+   }
+   return values;
+}
+
+/*
+	@name: polynomialEvalAsync
+	@description: Asynchronous version of polynomialEval: the encryption and the evaluation run on the default
+	              CyWorkStealingPool (see CyWorkStealingPool::getDefault) and the result is given by the future.
+	              The vectors are copied. This Cyfhel object must live until the future is ready.
+
+	@param: The method polynomialEvalAsync takes two mandatory parameters: a vector of long and a vector of long.
+	-param1: a mandatory vector of long which corresponds to the points of the polynomial evaluation.
+    -param2: a mandatory vector of long which corresponds to the coefficients of the polynome.
+
+    @return: Return a std::future of the CyCtxt P(cx).
+*/
+std::future<CyCtxt> Cyfhel::polynomialEvalAsync(vector<long> const& vectorPtsEval, vector<long> const& coeffPoly){
+   return CyWorkStealingPool::getDefault()->async([this, vectorPtsEval, coeffPoly]() mutable {
+       return this->polynomialEval(vectorPtsEval, coeffPoly);
+   });
+}
+
+/*
+	@name: polynomialEvalAsync
+	@description: Asynchronous version of polynomialEval with a ZZX polynome. See above.
+
+	@param: The method polynomialEvalAsync takes two mandatory parameters: a vector of long and a ZZX.
+	-param1: a mandatory vector of long which corresponds to the points of the polynomial evaluation.
+    -param2: a mandatory ZZX which corresponds to the polynome.
+
+    @return: Return a std::future of the CyCtxt P(cx).
+*/
+std::future<CyCtxt> Cyfhel::polynomialEvalAsync(vector<long> const& vectorPtsEval, ZZX const& poly){
+   return CyWorkStealingPool::getDefault()->async([this, vectorPtsEval, poly]() mutable {
+       return this->polynomialEval(vectorPtsEval, poly);
+   });
+}
+
+
 /*
 	@name: polynomialEvalAllRandom
 	@description: Choose a  size sizeVectorPtsEval of a vector. the method will then generate sizeVectorPtsEval points x = [x1, x2, ..., xn]. 
@@ -635,6 +1845,7 @@ bool Cyfhel::testPolynomialEvalAllRandom(long const& sizeVectorPtsEval, long con
 	@return: Return a CyCtxt which corresponds to encrypted vector.
 */
 CyCtxt Cyfhel::encrypt(vector<long> &ptxt_vect, bool isPtxt_vectResize) const {
+	applyExecutionPolicy();
 	// Create a vector of size nddSlots and fill it first with values from plaintext, then with zeros.
 	long vector_size = ptxt_vect.size();
 	// Empty cyphertext object.
@@ -681,6 +1892,7 @@ CyCtxt Cyfhel::encrypt(vector<long> &ptxt_vect, bool isPtxt_vectResize) const {
 	@return: Return a vector of long which corresponds to decrypted vector.
 */
 vector<long> Cyfhel::decrypt(Ctxt& ctxt_vect, bool isDecryptedPtxt_vectResize) const {
+	applyExecutionPolicy();
 	// The size of the original plaintext.
 	long vector_size = ctxt_vect.getm_sizeOfPlaintext();
 	vector<long> ptxt_vect(m_numberOfSlots, 0);// Empty vector of values
@@ -695,6 +1907,43 @@ vector<long> Cyfhel::decrypt(Ctxt& ctxt_vect, bool isDecryptedPtxt_vectResize) c
 	return ptxt_vect;
 }
 
+//------ASYNCHRONOUS ENCRYPTION------
+/*
+	@name: encryptAsync
+	@description: Asynchronous version of encrypt: the encryption runs on the default CyWorkStealingPool, so the caller
+	              can prepare the next batch or do I/O meanwhile. The plaintext is copied. This Cyfhel object must live
+	              until the future is ready.
+
+	@param: The method encryptAsync takes one mandatory parameter: a vector of long.
+	-param1: a mandatory vector of long which corresponds to vector to encrypt.
+
+	@return: Return a std::future of the CyCtxt which corresponds to encrypted vector.
+*/
+std::future<CyCtxt> Cyfhel::encryptAsync(vector<long> const& ptxt_vect) const {
+	return CyWorkStealingPool::getDefault()->async([this, ptxt_vect]() mutable {
+		return this->encrypt(ptxt_vect, false);
+	});
+}
+
+/*
+	@name: decryptAsync
+	@description: Asynchronous version of decrypt, run on the default CyWorkStealingPool. The ciphertext is copied.
+	              This Cyfhel object must live until the future is ready.
+
+	@param: The method decryptAsync takes one mandatory parameter and one optional parameter: a Ctxt and a bool.
+	-param1: a mandatory Ctxt which corresponds to vector to decrypt.
+	-param2 (optional)(Default: true): resize the result to the size of the original plaintext.
+
+	@return: Return a std::future of the vector of long which corresponds to decrypted vector.
+*/
+std::future< vector<long> > Cyfhel::decryptAsync(Ctxt const& ctxt_vect, bool isDecryptedPtxt_vectResize) const {
+	Ctxt copy = ctxt_vect;
+	return CyWorkStealingPool::getDefault()->async([this, copy, isDecryptedPtxt_vectResize]() mutable {
+		return this->decrypt(copy, isDecryptedPtxt_vectResize);
+	});
+}
+
+
 //------AUXILIARY------
 
 
@@ -703,6 +1952,8 @@ vector<long> Cyfhel::decrypt(Ctxt& ctxt_vect, bool isDecryptedPtxt_vectResize) c
 /*
 	@name: saveEnv
 	@description: Public method which allow to saves the context, m_secretKey and m_G polynomial in a .aenv file. The method return 1 if all ok and 0 otherwise.
+	              If the object is bootstrappable, the precomputed recryption data (linear maps caches, powerful basis tables,
+	              unpacking constants) is also saved in binary in a .arcd file, so that restoreEnv does not recompute it.
 
 	@param: The method saveEnv takes one mandatory parameter: a string.
 	-param1: a mandatory string which corresponds to the name of the file without the extention.
@@ -722,6 +1973,14 @@ bool Cyfhel::saveEnv(string const& fileName) const {
 		keyFile << m_G <<endl;                    // Write m_G poly (m_encryptedArray can't be written, we save
 		                                          // m_G in order to reconstruct m_encryptedArray in restoreEnv)
 		keyFile.close();
+
+		if(isBootstrappable())
+		{
+			fstream recryptFile(fileName+".arcd", fstream::out|fstream::trunc|fstream::binary);
+			assert(recryptFile.is_open());
+			m_context->rcData.write(recryptFile, *m_context);// Write the recryption data
+			recryptFile.close();
+		}
 	}
 	catch(exception& e)
 	{
@@ -734,6 +1993,8 @@ bool Cyfhel::saveEnv(string const& fileName) const {
 /*
 	@name: restoreEnv
 	@description: Public method which allow to restores the context, m_secretKey and m_G polynomial from a .aenv file. The method return 1 if all ok and 0 otherwise.
+	              If the context was bootstrappable, the recryption data is read from the .arcd file; if this file is missing,
+	              truncated or was written for another context, the recryption data is recomputed.
 
 	@param: The method restoreEnv takes one mandatory parameter: a string.
 	-param1: a mandatory string which corresponds to the name of the file without the extention to restore the context, m_secretKey and m_G polynomial.
@@ -751,16 +2012,31 @@ bool Cyfhel::restoreEnv(string const& fileName) {
 
         readContextBase(keyFile, m1, p1, r1, gens, ords);// Read m, p, r, gens, ords
 
+        clearCaches();// The cached objects were built on the previous context
         m_context = new FHEcontext(m1, p1, r1, gens, ords);// Prepare empty context object
 
         m_secretKey = new FHESecKey(*m_context);// Prepare empty FHESecKey object
         
-        keyFile >> *m_context;// Read the rest of the context
+        readContext(keyFile, *m_context, false);// Read the rest of the context, without the recryption data
+        if(m_context->rcData.mvec.length() > 0)
+        {
+            fstream recryptFile(fileName+".arcd", fstream::in|fstream::binary);
+            RecryptData& rcData = m_context->rcData;
+            if(!recryptFile.is_open() || !rcData.read(recryptFile, *m_context))
+            {
+                if(m_isVerbose)
+                {
+                    std::cerr << "restoreEnv: no valid " << fileName << ".arcd, the recryption data is recomputed." << endl;
+                }
+                m_context->makeBootstrappable(rcData.mvec, rcData.hwt, rcData.conservative, rcData.cacheType);
+            }
+        }
         keyFile >> *m_secretKey;// Read Secret Key
         keyFile >> m_G;// Read m_G Poly
         m_encryptedArray = new EncryptedArray(*m_context, m_G);// Reconstruct m_encryptedArray using m_G
         m_publicKey = (FHEPubKey*) m_secretKey;// Reconstruct Public Key from Secret Key
         m_numberOfSlots = m_encryptedArray->size();// Refill m_numberOfSlots
+        calibrateMatMul();// Costs of the products by a matrix on this context
         m_global_m = m1;
         m_global_p = p1;
         m_global_r = r1;
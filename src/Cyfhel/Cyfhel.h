@@ -10,6 +10,10 @@
 #include <cmath>
 #include <sys/time.h>
 #include <string.h>
+#include <future>
+#include <functional>
+#include <map>
+#include <mutex>
 
 #include <boost/unordered_map.hpp>
 #include <boost/lexical_cast.hpp>
@@ -28,9 +32,15 @@
 #include "PAlgebra.h"
 
 #include "CyCtxt.h"
+#include "CyExecutionPolicy.h"
+#include "CyMatrix.h"
+#include "CyCtxtMatrix.h"
+#include "CySlotLayout.h"
 
 #include "polyEval.h"
 
+class CyWorkStealingPool;
+
 //The Cyfhel Class
 class Cyfhel {
 
@@ -45,6 +55,18 @@ class Cyfhel {
 	long m_global_m, m_global_p, m_global_r;
 	long m_numberOfSlots;// Nº of slots in scheme
 	bool m_isVerbose;// Flag to print messages on console
+	CyExecutionPolicy m_executionPolicy;// Own execution policy, used if m_hasExecutionPolicy
+	bool m_hasExecutionPolicy;// False to follow the global execution policy
+	mutable std::mutex m_poolMutex;// Protects m_pool
+	mutable std::shared_ptr<CyWorkStealingPool> m_pool;// Pool following m_executionPolicy, started by the first batch (see batchPool)
+	map< long, std::shared_ptr<ZZX const> > m_packingMasks;// Encoded masks of the n first slots, per n (see recryptBatch)
+	mutable std::mutex m_recryptBatchMutex;// Protects m_packingMasks and the statistics of recryptBatch
+	long m_recryptedCtxts;// Nº of CyCtxt recrypted by recryptBatch
+	double m_recryptSeconds;// Time spent in recryptBatch
+	map< unsigned long, pair< std::shared_ptr<CyMatrix>, unsigned long > > m_matrices;// Matrices of matVecMul and their last use, per hash of their entries
+	unsigned long m_matricesClock;// Incremented at each use of m_matrices
+	std::mutex m_matricesMutex;// Protects m_matrices and m_matricesClock
+	MatMulCostModel m_matMulCostModel;// Costs of the rotations measured on the current context (see calibrateMatMul)
         
 
     /******COMPARISON OPERATORS OVERLOAD******/
@@ -59,7 +81,22 @@ class Cyfhel {
 	void keyGen(long const& p, long const& r, long const& c, long const& d, long const& sec, long const& w = 64,
                     long L = -1, long m = -1, long const& R = 3, long const& s = 0,
                     const vector<long>& gens = vector<long>(),
-                    const vector<long>& ords = vector<long>());//Performs Key Generation using HElib functions.
+                    const vector<long>& ords = vector<long>(),
+                    const vector<long>& mvec = vector<long>());//Performs Key Generation using HElib functions. Bootstrappable if mvec is given.
+
+	void applyExecutionPolicy() const;//Apply the execution policy of this object to the calling thread.
+
+	CyExecutionPolicy batchExecutionPolicy() const;//Policy of the batch methods: own policy, else global policy, else one CyCtxt per thread.
+
+	std::shared_ptr<ZZX const> packingMask(long size);//Encoded mask of the size first slots, cached.
+
+	std::shared_ptr<CyWorkStealingPool> batchPool() const;//Pool of the batch methods: the default pool, or a pool following the own policy.
+
+	void forEachTask(long nbTasks, std::function<void(long)> const& task) const;//Run task(0), ..., task(nbTasks-1) on batchPool.
+
+	void clearCaches();//Forget the objects built on the previous context (keyGen, restoreEnv).
+
+	void calibrateMatMul();//Measure m_matMulCostModel on the current context (keyGen, restoreEnv).
 
 
  public:
@@ -74,9 +111,14 @@ class Cyfhel {
 
 	Cyfhel(vector<long> cryptoParameters, bool isVerbose = false);
 
+	Cyfhel(vector<long> const& mvec, long p, long r, long L, long c = 3, long m = -1, vector<long> const& gens = vector<long>(), vector<long> const& ords = vector<long>(), bool isVerbose = false);//Bootstrappable scheme, m = product of mvec
+
 	/******COPY CONSTRUCTOR******/
 	Cyfhel(Cyfhel const& cyfhelToCopy);
 
+	/******ASSIGNMENT OPERATOR******/
+	Cyfhel& operator=(Cyfhel const& cyfhelToCopy);//Copy the attributes, each object keeps its own mutexes
+
 	/******DESTRUCTOR BY DEFAULT******/
 	virtual ~Cyfhel();
 
@@ -91,6 +133,14 @@ class Cyfhel {
 
 	bool getm_isVerbose() const;//Getter of attribute m_isVerbose
 
+	CyExecutionPolicy getm_executionPolicy() const;//Execution policy of this object (its own or the global one)
+
+	bool isBootstrappable() const;//True if the ciphertexts can be recrypted
+
+	EncryptedArray const& getm_encryptedArray() const;//Getter of attribute m_encryptedArray
+
+	MatMulCostModel getm_matMulCostModel() const;//Getter of attribute m_matMulCostModel
+
 	/******SETTERS******/
 	void setm_numberOfSlots(long numberOfSlots);//Setter of attribute m_numberOfSlots
 
@@ -102,6 +152,10 @@ class Cyfhel {
 
 	void setm_isVerbose(bool isVerbose);//Setter of attribute m_isVerbose
 
+	void setm_executionPolicy(CyExecutionPolicy const& executionPolicy);//Give its own execution policy to this object
+
+	void useGlobalExecutionPolicy();//Follow the global execution policy again
+
        
     /******PROTOTYPES OF PUBLIC METHODS******/
 
@@ -120,6 +174,53 @@ class Cyfhel {
     CyCtxt polynomialEval(vector<long>& vectorPtsEval, ZZX const& poly); // Given a vector of evaluation points and a polynome (type ZZX).
                                                                          // Give a CyCtxt which is the polynomial evaluation of the encrypted evaluation points.
 
+    void polynomialEvalBatch(vector<CyCtxt>& vectorCtxt, ZZX const& poly); // Replace each CyCtxt of vectorCtxt by its polynomial evaluation. The polynome is
+                                                                           // prepared once and the CyCtxt are evaluated in parallel.
+
+    ZZX lookupTablePolynome(vector<long> const& table, long ptxtSpace = 0) const; // Polynome P such as P(x) = table[x] mod ptxtSpace for 0 <= x < table.size().
+
+    void applyLookupTable(CyCtxt& cyctxt, vector<long> const& table); // Replace each slot value x of cyctxt by table[x], for 0 <= x < table.size() <= p.
+
+    CyCtxt maxOfVector(CyCtxt const& cyctxt, long n = 0, long nbits = 0, CyCtxt *argmax = 0); // Maximum of the n first slots of cyctxt, in its slot 0 (p = 2).
+                                                                                           // If argmax is given, its slot 0 gets the index of the maximum.
+
+    void recryptBatch(vector<CyCtxt>& vectorCtxt); // Recrypt all the CyCtxt. The partially used CyCtxt are packed together
+                                                   // so that less recryptions are run.
+
+    double recryptionsPerSecond() const; // Nº of CyCtxt recrypted per second by recryptBatch so far.
+
+    std::shared_ptr<CyMatrix> matrix(vector< vector<long> > const& data, CyMatrix::Variant variant = CyMatrix::automatic,
+                                     string const& cacheFile = ""); // Handle of the matrix data, created at the first call.
+
+    void matVecMul(CyCtxt& cyctxt, CyMatrix& matrix); // Replace the encrypted vector x of cyctxt by M*x.
+
+    void matVecMul(CyCtxt& cyctxt, vector< vector<long> > const& matrix); // Same with the handle of the matrix (see matrix).
+
+    CySlotLayout slotLayout(long rows, long cols = 1, long rowAxisRotations = 0, long colAxisRotations = 0) const; // Layout of a rows x cols matrix
+                                                                                                              // for these numbers of rotations.
+
+    CyCtxtMatrix encryptMatrix(vector< vector<long> > const& data) const; // Encrypt the matrix data, column by column.
+
+    vector< vector<long> > decryptMatrix(CyCtxtMatrix& matrix) const; // Decrypt the CyCtxtMatrix, row by row.
+
+    CyCtxtMatrix matMul(CyCtxtMatrix const& A, vector< vector<long> > const& B); // Encrypted A times plaintext B.
+
+    CyCtxtMatrix matMul(CyCtxtMatrix const& A, CyCtxtMatrix const& B); // Encrypted A times encrypted B.
+
+    long segmentsPerCtxt(long width) const; // Nº of segments of width slots in a CyCtxt (see CyCtxt::segmentSum).
+
+    vector<long> packSegments(vector< vector<long> > const& vectors, long width) const; // Slots holding vectors[s] in the
+                                                                                        // segment s, padded with zeros.
+
+    CyCtxt encryptSegments(vector< vector<long> > const& vectors, long width) const; // Encryption of packSegments.
+
+    vector<long> unpackSegments(vector<long> const& slots, long width, long count = 0) const; // First slot of the count
+                                                                                             // first segments.
+
+    std::future<CyCtxt> polynomialEvalAsync(vector<long> const& vectorPtsEval, vector<long> const& coeffPoly); // Asynchronous polynomialEval.
+
+    std::future<CyCtxt> polynomialEvalAsync(vector<long> const& vectorPtsEval, ZZX const& poly); // Asynchronous polynomialEval.
+
     bool testPolynomialEvalAllRandom(long const& sizeVectorPtsEval = 1, long const& d = 1, bool const& isMonic = false);
 
 
@@ -128,6 +229,11 @@ class Cyfhel {
         
 	vector<long> decrypt(Ctxt& ctxt_vect, bool isDecryptedPtxt_vectResize = true) const;//Decryption
 
+	//------ASYNCHRONOUS ENCRYPTION------
+	std::future<CyCtxt> encryptAsync(vector<long> const& ptxt_vect) const;//Encryption on the default CyWorkStealingPool
+
+	std::future< vector<long> > decryptAsync(Ctxt const& ctxt_vect, bool isDecryptedPtxt_vectResize = true) const;//Decryption on the default CyWorkStealingPool
+
 
 	//------AUXILIARY------
 
@@ -0,0 +1,132 @@
+/*
+#   Benchmark_Circuit
+#   --------------------------------------------------------------------
+#   Perform NB_BENCHMARK independent operations *, first one after the
+#   other, then as the nodes of a CyCircuit run on the work-stealing pool,
+#   and compare the average time per operation.
+#   --------------------------------------------------------------------
+#   Author: Remy AUDA & Alexandre AUDA
+#   Date: 19/10/2026
+#   --------------------------------------------------------------------
+#   License: GNU GPL v3
+#
+#   Demo_Cyfhel is free software: you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation, either version 3 of the License, or
+#   (at your option) any later version.
+#
+#   Demo_Cyfhel is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#   --------------------------------------------------------------------
+*/
+
+/* Import all the packages useful for the Demo.*/
+#include <NTL/ZZ.h>
+#include <NTL/BasicThreadPool.h>
+#include <FHE.h>
+#include <timing.h>
+#include <EncryptedArray.h>
+#include <NTL/lzz_pXFactoring.h>
+
+#include <Cyfhel.h>
+#include "Timer.h"
+#include "LibMatrix.h"
+#include "CyScheduler.h"
+
+#include <cassert>
+#include <cstdio>
+
+/* The vector size of the plaintext that we will use for the demo.*/
+#define VECTOR_SIZE 5
+
+/* Define the number of operations of the Benchmark*/
+#define NB_BENCHMARK 1000
+
+
+int main(int argc, char *argv[])
+{
+	long nbThreads = 0;// 0: all the cores.
+	if(argc > 1)
+	{
+		nbThreads = atol(argv[1]);
+	}
+
+	vector<long> v1; // Initialization of v1.
+	vector<long> v2; // Initialization of v2.
+
+	// Initialization of v1 and v2.
+	for(int i=0; i<VECTOR_SIZE; i++)
+	{
+		v1.push_back(i);
+		v2.push_back(2);
+	}
+
+    // Display the title of the program.
+    std::cout <<"" <<endl;
+    std::cout <<"     ************Benchmark_Circuit************" <<endl;
+    std::cout <<"" <<endl;
+
+    std::cout <<"******Generation of the keys for encryption******"<<endl<<endl;
+
+	Cyfhel cy(true);
+
+    CyCtxt c1 = cy.encrypt(v1);
+    CyCtxt c2 = cy.encrypt(v2);
+
+    std::cout <<"******Perform "<< NB_BENCHMARK <<" operations * one after the other******"<<endl<<endl;
+
+    Timer timerSequential(true);
+    timerSequential.start();
+    for(int k=0; k<NB_BENCHMARK; k++)
+    {
+        CyCtxt cMultiply1_2 = c1 * c2;
+    }
+    timerSequential.stop();
+    timerSequential.benchmarkInSeconds();
+
+    std::cout <<"******Perform "<< NB_BENCHMARK <<" operations * in a circuit******"<<endl<<endl;
+
+    // The operations are independent nodes of the circuit, the pool runs them concurrently.
+    CyCircuit circuit;
+    long n1 = circuit.input(c1);
+    long n2 = circuit.input(c2);
+    for(int k=0; k<NB_BENCHMARK; k++)
+    {
+        circuit.multiply(n1, n2);
+    }
+
+    CyWorkStealingPool pool(nbThreads);
+    std::cout << pool.getm_numberOfThreads() << " threads, " << pool.getm_innerThreads() << " NTL threads each." << endl;
+
+    Timer timerCircuit(true);
+    timerCircuit.start();
+    circuit.run(pool);
+    timerCircuit.stop();
+    timerCircuit.benchmarkInSeconds();
+
+    double averageOfExecutionTime = timerCircuit.getm_benchmarkSecond()/NB_BENCHMARK;// Average time of one operation in the circuit.
+
+    std::cout << "Speedup: " << timerSequential.getm_benchmarkSecond()/timerCircuit.getm_benchmarkSecond() << endl;
+
+    LibMatrix::writeDoubleInFileWithEraseData("Result_Benchmark_Circuit", averageOfExecutionTime);// Write the double averageOfExecutionTime in the file Result_Benchmark_Circuit in the directory ResultOfBenchmark.
+
+    LibMatrix::writeStringInFileWithEraseData("ResultVerbose_Benchmark_Circuit", LibMatrix::transformSecondToYearMonthWeekHourMinSecMilli(averageOfExecutionTime));// Write the string verbose of the average of execution time in the file ResultVerbose_Benchmark_Circuit in the directory ResultOfBenchmark.
+
+
+    // Skip a line.
+    std::cout <<"\n"<<endl;
+
+    // Display the end of the program.
+    std::cout <<"     ************End of Benchmark_Circuit************" <<endl;
+
+    // Skip a line.
+    std::cout <<"\n"<<endl;
+
+    // If success, return 0.
+    return 0;
+};
@@ -0,0 +1,164 @@
+/*
+#   Benchmark_ExtractDigits
+#   --------------------------------------------------------------------
+#   Time of extractDigits for 1 to MAX_THREADS threads, on one ciphertext
+#   (the liftings of the digits run concurrently) and on NB_CTXT
+#   ciphertexts (the ciphertexts run concurrently). The bits are checked.
+#   --------------------------------------------------------------------
+#   Author: Remy AUDA & Alexandre AUDA
+#   Date: 19/10/2026
+#   --------------------------------------------------------------------
+#   License: GNU GPL v3
+#
+#   Demo_Cyfhel is free software: you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation, either version 3 of the License, or
+#   (at your option) any later version.
+#
+#   Demo_Cyfhel is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#   --------------------------------------------------------------------
+*/
+
+/* Import all the packages useful for the Demo.*/
+#include <NTL/ZZ.h>
+#include <NTL/BasicThreadPool.h>
+#include <FHE.h>
+#include <timing.h>
+#include <EncryptedArray.h>
+#include <NTL/lzz_pXFactoring.h>
+
+#include <Cyfhel.h>
+#include "Timer.h"
+#include "LibMatrix.h"
+#include "CyExecutionPolicy.h"
+
+#include <cassert>
+#include <cstdio>
+
+/* The vector size of the plaintext that we will use for the demo.*/
+#define VECTOR_SIZE 8
+
+/* Define the number of bits extracted.*/
+#define NB_BITS 8
+
+/* Define the number of ciphertexts of the batch.*/
+#define NB_CTXT 4
+
+/* Define the max number of threads of the Benchmark.*/
+#define MAX_THREADS 16
+
+
+/*
+	@name: checkBits
+	@description: Decrypt the bits and compare them with the bits of v.
+
+	@return: Return the number of mismatches.
+*/
+static long checkBits(Cyfhel& cy, vector<Ctxt>& bits, vector<long> const& v){
+	long errors = 0;
+	for(long j=0; j<(long) bits.size(); j++)
+	{
+		vector<long> r = cy.decrypt(bits[j]);
+		for(long i=0; i<(long) v.size(); i++)
+		{
+			if(r[i] != ((v[i] >> j) & 1))
+			{
+				errors++;
+			}
+		}
+	}
+	return errors;
+}
+
+
+int main(int argc, char *argv[])
+{
+	long maxThreads = MAX_THREADS;
+	if(argc > 1)
+	{
+		maxThreads = atol(argv[1]);
+	}
+
+    // Display the title of the program.
+    std::cout <<"" <<endl;
+    std::cout <<"     ************Benchmark_ExtractDigits************" <<endl;
+    std::cout <<"" <<endl;
+
+    std::cout <<"******Generation of the keys for encryption******"<<endl<<endl;
+
+	// p = 2 and r = NB_BITS: the digits are the bits of the values.
+	Cyfhel cy(false, 2, NB_BITS, 2, 1, 80, 64, 40);
+
+	vector< vector<long> > values;
+	vector<Ctxt> ctxts;
+	for(long k=0; k<NB_CTXT; k++)
+	{
+		vector<long> v;
+		for(long i=0; i<VECTOR_SIZE; i++)
+		{
+			v.push_back(RandomBnd(1L << NB_BITS));
+		}
+		values.push_back(v);
+		ctxts.push_back(cy.encrypt(v));
+	}
+
+	LibMatrix::removeAllDataInFile("Result_Benchmark_ExtractDigits");
+	LibMatrix::writeStringInFileWithoutEraseData("Result_Benchmark_ExtractDigits", "threads oneCtxtSeconds batchSeconds\n");
+
+	long errors = 0;
+	for(long threads=1; threads<=maxThreads; threads*=2)
+	{
+		CyExecutionPolicy::innerOnly(threads).applyToCurrentThread();
+
+		// One ciphertext.
+		vector<Ctxt> bits;
+		Timer timerOne(false);
+		timerOne.start();
+		extractDigits(bits, ctxts[0], NB_BITS);
+		timerOne.stop();
+		double oneSeconds = timerOne.benchmarkInSeconds(false);
+		errors += checkBits(cy, bits, values[0]);
+
+		// The batch.
+		vector< vector<Ctxt> > batchBits;
+		Timer timerBatch(false);
+		timerBatch.start();
+		extractDigits(batchBits, ctxts, NB_BITS);
+		timerBatch.stop();
+		double batchSeconds = timerBatch.benchmarkInSeconds(false);
+		for(long k=0; k<NB_CTXT; k++)
+		{
+			errors += checkBits(cy, batchBits[k], values[k]);
+		}
+
+		std::cout << threads << " threads: " << oneSeconds << " s for 1 CyCtxt, " << batchSeconds << " s for " << NB_CTXT << " CyCtxt" << endl;
+
+		std::ostringstream line;
+		line << threads << " " << oneSeconds << " " << batchSeconds << "\n";
+		LibMatrix::writeStringInFileWithoutEraseData("Result_Benchmark_ExtractDigits", line.str());
+	}
+
+    // Skip a line.
+    std::cout <<"\n"<<endl;
+
+	if(errors != 0)
+	{
+		std::cout << "Benchmark_ExtractDigits FAILED: " << errors << " mismatches." << endl;
+		return 1;
+	}
+
+    // Display the end of the program.
+    std::cout <<"     ************End of Benchmark_ExtractDigits************" <<endl;
+
+    // Skip a line.
+    std::cout <<"\n"<<endl;
+
+    // If success, return 0.
+    return 0;
+};
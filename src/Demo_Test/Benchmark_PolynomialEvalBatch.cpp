@@ -0,0 +1,147 @@
+/*
+#   Benchmark_PolynomialEvalBatch
+#   --------------------------------------------------------------------
+#   Evaluate the same polynome on NB_CTXT ciphertexts, first one after the
+#   other with polyEval, then with polynomialEvalBatch which prepares the
+#   polynome once and evaluates the ciphertexts in parallel. The results
+#   are checked.
+#   --------------------------------------------------------------------
+#   Author: Remy AUDA & Alexandre AUDA
+#   Date: 19/10/2026
+#   --------------------------------------------------------------------
+#   License: GNU GPL v3
+#
+#   Demo_Cyfhel is free software: you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation, either version 3 of the License, or
+#   (at your option) any later version.
+#
+#   Demo_Cyfhel is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#   --------------------------------------------------------------------
+*/
+
+/* Import all the packages useful for the Demo.*/
+#include <NTL/ZZ.h>
+#include <NTL/BasicThreadPool.h>
+#include <FHE.h>
+#include <timing.h>
+#include <EncryptedArray.h>
+#include <NTL/lzz_pXFactoring.h>
+
+#include <Cyfhel.h>
+#include "Timer.h"
+#include "LibMatrix.h"
+
+#include <cassert>
+#include <cstdio>
+
+/* The vector size of the plaintext that we will use for the demo.*/
+#define VECTOR_SIZE 5
+
+/* Define the number of ciphertexts of the batch.*/
+#define NB_CTXT 32
+
+/* Define the degree of the polynome.*/
+#define DEGREE 15
+
+
+int main(int argc, char *argv[])
+{
+    // Display the title of the program.
+    std::cout <<"" <<endl;
+    std::cout <<"     ************Benchmark_PolynomialEvalBatch************" <<endl;
+    std::cout <<"" <<endl;
+
+    std::cout <<"******Generation of the keys for encryption******"<<endl<<endl;
+
+	Cyfhel cy(false, 1031, 1, 2, 1, 80, 64, 12);
+	const long p2r = cy.getp2r();
+
+	// The polynome, with random coefficients.
+	vector<long> coeffPoly;
+	for(long i=0; i<=DEGREE; i++)
+	{
+		coeffPoly.push_back(RandomBnd(p2r));
+	}
+	ZZX poly = cy.createPolynomeWithCoeff(coeffPoly);
+
+	// The batch of ciphertexts.
+	vector< vector<long> > vectorPts;
+	vector<CyCtxt> vectorCtxt;
+	for(long k=0; k<NB_CTXT; k++)
+	{
+		vector<long> v;
+		for(long i=0; i<VECTOR_SIZE; i++)
+		{
+			v.push_back(RandomBnd(p2r));
+		}
+		vectorPts.push_back(v);
+		vectorCtxt.push_back(cy.encrypt(v));
+	}
+
+    std::cout <<"******Evaluate the polynome on "<< NB_CTXT <<" CyCtxt one after the other******"<<endl<<endl;
+
+	Timer timerSequential(true);
+	timerSequential.start();
+	for(long k=0; k<NB_CTXT; k++)
+	{
+		CyCtxt cEvalPoly = vectorCtxt[k];
+		polyEval(cEvalPoly, poly, vectorCtxt[k]);
+	}
+	timerSequential.stop();
+	timerSequential.benchmarkInSeconds();
+
+    std::cout <<"******Evaluate the polynome on "<< NB_CTXT <<" CyCtxt with polynomialEvalBatch******"<<endl<<endl;
+
+	Timer timerBatch(true);
+	timerBatch.start();
+	cy.polynomialEvalBatch(vectorCtxt, poly);
+	timerBatch.stop();
+	timerBatch.benchmarkInSeconds();
+
+	std::cout << "Speedup: " << timerSequential.getm_benchmarkSecond()/timerBatch.getm_benchmarkSecond() << endl;
+
+	// Check the results.
+	long errors = 0;
+	for(long k=0; k<NB_CTXT; k++)
+	{
+		vector<long> r = cy.decrypt(vectorCtxt[k]);
+		for(long i=0; i<VECTOR_SIZE; i++)
+		{
+			if(r[i] != polyEvalMod(poly, vectorPts[k][i], p2r))
+			{
+				errors++;
+			}
+		}
+	}
+
+	double averageOfExecutionTime = timerBatch.getm_benchmarkSecond()/NB_CTXT;// Average time of one evaluation in the batch.
+
+	LibMatrix::writeDoubleInFileWithEraseData("Result_Benchmark_PolynomialEvalBatch", averageOfExecutionTime);// Write the double averageOfExecutionTime in the file Result_Benchmark_PolynomialEvalBatch in the directory ResultOfBenchmark.
+
+	LibMatrix::writeStringInFileWithEraseData("ResultVerbose_Benchmark_PolynomialEvalBatch", LibMatrix::transformSecondToYearMonthWeekHourMinSecMilli(averageOfExecutionTime));// Write the string verbose of the average of execution time in the file ResultVerbose_Benchmark_PolynomialEvalBatch in the directory ResultOfBenchmark.
+
+    // Skip a line.
+    std::cout <<"\n"<<endl;
+
+	if(errors != 0)
+	{
+		std::cout << "Benchmark_PolynomialEvalBatch FAILED: " << errors << " mismatches." << endl;
+		return 1;
+	}
+
+    // Display the end of the program.
+    std::cout <<"     ************End of Benchmark_PolynomialEvalBatch************" <<endl;
+
+    // Skip a line.
+    std::cout <<"\n"<<endl;
+
+    // If success, return 0.
+    return 0;
+};
@@ -0,0 +1,141 @@
+/*
+#   Benchmark_RecryptBatch
+#   --------------------------------------------------------------------
+#   Recrypt NB_CTXT partially used ciphertexts, first one after the other
+#   with CyCtxt::recrypt, then with recryptBatch which packs them in fully
+#   used ciphertexts and recrypts each pack once. The results are checked.
+#   --------------------------------------------------------------------
+#   Author: Remy AUDA & Alexandre AUDA
+#   Date: 19/10/2026
+#   --------------------------------------------------------------------
+#   License: GNU GPL v3
+#
+#   Demo_Cyfhel is free software: you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation, either version 3 of the License, or
+#   (at your option) any later version.
+#
+#   Demo_Cyfhel is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#   --------------------------------------------------------------------
+*/
+
+/* Import all the packages useful for the Demo.*/
+#include <NTL/ZZ.h>
+#include <NTL/BasicThreadPool.h>
+#include <FHE.h>
+#include <timing.h>
+#include <EncryptedArray.h>
+#include <NTL/lzz_pXFactoring.h>
+
+#include <Cyfhel.h>
+#include "Timer.h"
+#include "LibMatrix.h"
+
+#include <cassert>
+#include <cstdio>
+
+/* The vector size of the plaintext that we will use for the demo.*/
+#define VECTOR_SIZE 5
+
+/* Define the number of ciphertexts of the batch.*/
+#define NB_CTXT 24
+
+
+int main(int argc, char *argv[])
+{
+    // Display the title of the program.
+    std::cout <<"" <<endl;
+    std::cout <<"     ************Benchmark_RecryptBatch************" <<endl;
+    std::cout <<"" <<endl;
+
+    std::cout <<"******Generation of the keys and of the bootstrapping data******"<<endl<<endl;
+
+	// m = 1705 = 11*155, p = 2, r = 1, L = 25 (the parameters of Test_bootstrapping).
+	vector<long> mvec;
+	mvec.push_back(11);
+	mvec.push_back(155);
+	vector<long> gens;
+	gens.push_back(156);
+	gens.push_back(936);
+	vector<long> ords;
+	ords.push_back(10);
+	ords.push_back(6);
+	Cyfhel cy(mvec, 2, 1, 25, 3, 1705, gens, ords);
+
+	// The batch of ciphertexts.
+	vector< vector<long> > vectorPts;
+	vector<CyCtxt> vectorCtxt;
+	for(long k=0; k<NB_CTXT; k++)
+	{
+		vector<long> v;
+		for(long i=0; i<VECTOR_SIZE; i++)
+		{
+			v.push_back(RandomBnd(2));
+		}
+		vectorPts.push_back(v);
+		vectorCtxt.push_back(cy.encrypt(v));
+	}
+
+    std::cout <<"******Recrypt "<< NB_CTXT <<" CyCtxt one after the other******"<<endl<<endl;
+
+	vector<CyCtxt> vectorCtxtCopy(vectorCtxt);
+	Timer timerSequential(true);
+	timerSequential.start();
+	for(long k=0; k<NB_CTXT; k++)
+	{
+		vectorCtxtCopy[k].recrypt();
+	}
+	timerSequential.stop();
+	timerSequential.benchmarkInSeconds();
+
+    std::cout <<"******Recrypt "<< NB_CTXT <<" CyCtxt with recryptBatch******"<<endl<<endl;
+
+	Timer timerBatch(true);
+	timerBatch.start();
+	cy.recryptBatch(vectorCtxt);
+	timerBatch.stop();
+	timerBatch.benchmarkInSeconds();
+
+	std::cout << "Speedup: " << timerSequential.getm_benchmarkSecond()/timerBatch.getm_benchmarkSecond() << endl;
+	std::cout << "Recryptions per second: " << cy.recryptionsPerSecond() << endl;
+
+	// Check the results.
+	long errors = 0;
+	for(long k=0; k<NB_CTXT; k++)
+	{
+		vector<long> r = cy.decrypt(vectorCtxt[k]);
+		for(long i=0; i<VECTOR_SIZE; i++)
+		{
+			if(r[i] != vectorPts[k][i])
+			{
+				errors++;
+			}
+		}
+	}
+
+	LibMatrix::writeDoubleInFileWithEraseData("Result_Benchmark_RecryptBatch", cy.recryptionsPerSecond());// Write the number of recryptions per second in the file Result_Benchmark_RecryptBatch in the directory ResultOfBenchmark.
+
+    // Skip a line.
+    std::cout <<"\n"<<endl;
+
+	if(errors != 0)
+	{
+		std::cout << "Benchmark_RecryptBatch FAILED: " << errors << " mismatches." << endl;
+		return 1;
+	}
+
+    // Display the end of the program.
+    std::cout <<"     ************End of Benchmark_RecryptBatch************" <<endl;
+
+    // Skip a line.
+    std::cout <<"\n"<<endl;
+
+    // If success, return 0.
+    return 0;
+};
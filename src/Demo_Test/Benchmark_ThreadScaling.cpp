@@ -0,0 +1,153 @@
+/*
+#   Benchmark_ThreadScaling
+#   --------------------------------------------------------------------
+#   Throughput of independent operations * for 1 to 64 threads, with
+#   several splits between the outer level (operations run concurrently
+#   on a CyWorkStealingPool) and the inner level (NTL threads inside each
+#   operation), as chosen by CyExecutionPolicy.
+#   --------------------------------------------------------------------
+#   Author: Remy AUDA & Alexandre AUDA
+#   Date: 19/10/2026
+#   --------------------------------------------------------------------
+#   License: GNU GPL v3
+#
+#   Demo_Cyfhel is free software: you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation, either version 3 of the License, or
+#   (at your option) any later version.
+#
+#   Demo_Cyfhel is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#   --------------------------------------------------------------------
+*/
+
+/* Import all the packages useful for the Demo.*/
+#include <NTL/ZZ.h>
+#include <NTL/BasicThreadPool.h>
+#include <FHE.h>
+#include <timing.h>
+#include <EncryptedArray.h>
+#include <NTL/lzz_pXFactoring.h>
+
+#include <Cyfhel.h>
+#include "Timer.h"
+#include "LibMatrix.h"
+#include "CyScheduler.h"
+#include "CyExecutionPolicy.h"
+
+#include <cassert>
+#include <cstdio>
+
+/* The vector size of the plaintext that we will use for the demo.*/
+#define VECTOR_SIZE 5
+
+/* Define the number of operations for each measure.*/
+#define NB_OPERATIONS 128
+
+/* Define the max number of threads of the Benchmark.*/
+#define MAX_THREADS 64
+
+
+/*
+	@name: measure
+	@description: Run NB_OPERATIONS independent operations * on a pool following policy.
+
+	@return: Return the number of operations per second.
+*/
+static double measure(CyCircuit& circuit, CyExecutionPolicy const& policy){
+	Timer timer(false);
+	timer.start();
+	circuit.run(policy);
+	timer.stop();
+	return NB_OPERATIONS/timer.benchmarkInSeconds(false);
+}
+
+
+int main(int argc, char *argv[])
+{
+	long maxThreads = MAX_THREADS;
+	if(argc > 1)
+	{
+		maxThreads = atol(argv[1]);
+	}
+
+	vector<long> v1; // Initialization of v1.
+	vector<long> v2; // Initialization of v2.
+
+	for(int i=0; i<VECTOR_SIZE; i++)
+	{
+		v1.push_back(i);
+		v2.push_back(2);
+	}
+
+    // Display the title of the program.
+    std::cout <<"" <<endl;
+    std::cout <<"     ************Benchmark_ThreadScaling************" <<endl;
+    std::cout <<"" <<endl;
+
+    std::cout <<"******Generation of the keys for encryption******"<<endl<<endl;
+
+	Cyfhel cy(true);
+
+    CyCtxt c1 = cy.encrypt(v1);
+    CyCtxt c2 = cy.encrypt(v2);
+
+    CyCircuit circuit;
+    long n1 = circuit.input(c1);
+    long n2 = circuit.input(c2);
+    for(int k=0; k<NB_OPERATIONS; k++)
+    {
+        circuit.multiply(n1, n2);
+    }
+
+    std::cout << CyExecutionPolicy::hardwareThreads() << " hardware threads." << endl << endl;
+
+    LibMatrix::removeAllDataInFile("Result_Benchmark_ThreadScaling");
+    LibMatrix::writeStringInFileWithoutEraseData("Result_Benchmark_ThreadScaling", "threads outer inner operationsPerSecond\n");
+
+    for(long total=1; total<=maxThreads; total*=2)
+    {
+        // Three splits: everything inside the operations, everything outside, and the balanced one.
+        vector<long> outers;
+        outers.push_back(1);
+        long balanced = max(1L, (long) floor(sqrt((double) total)));
+        if(balanced != 1 && balanced != total)
+        {
+            outers.push_back(balanced);
+        }
+        if(total != 1)
+        {
+            outers.push_back(total);
+        }
+
+        for(unsigned long k=0; k<outers.size(); k++)
+        {
+            CyExecutionPolicy policy = CyExecutionPolicy::split(outers[k], total);
+            double throughput = measure(circuit, policy);
+
+            std::cout << total << " threads (" << policy << "): " << throughput << " operations/s" << endl;
+
+            std::ostringstream line;
+            line << total << " " << policy.getm_outerThreads() << " " << policy.getm_innerThreads() << " " << throughput << "\n";
+            LibMatrix::writeStringInFileWithoutEraseData("Result_Benchmark_ThreadScaling", line.str());
+        }
+    }
+
+
+    // Skip a line.
+    std::cout <<"\n"<<endl;
+
+    // Display the end of the program.
+    std::cout <<"     ************End of Benchmark_ThreadScaling************" <<endl;
+
+    // Skip a line.
+    std::cout <<"\n"<<endl;
+
+    // If success, return 0.
+    return 0;
+};
@@ -0,0 +1,130 @@
+/*
+#   Demo_Cyfhel_Async
+#   --------------------------------------------------------------------
+#   Pipeline with the asynchronous API: the encryption of the next batch
+#   is started while the current batch is evaluated, and the results are
+#   decrypted in the background and checked.
+#   --------------------------------------------------------------------
+#   Author: Remy AUDA & Alexandre AUDA
+#   Date: 19/10/2026
+#   --------------------------------------------------------------------
+#   License: GNU GPL v3
+#
+#   Demo_Cyfhel is free software: you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation, either version 3 of the License, or
+#   (at your option) any later version.
+#
+#   Demo_Cyfhel is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#   --------------------------------------------------------------------
+*/
+
+/* Import all the packages useful for the Demo.*/
+#include <NTL/ZZ.h>
+#include <NTL/BasicThreadPool.h>
+#include <FHE.h>
+#include <timing.h>
+#include <EncryptedArray.h>
+#include <NTL/lzz_pXFactoring.h>
+
+#include <Cyfhel.h>
+#include "Timer.h"
+#include "CyScheduler.h"
+
+#include <future>
+#include <cassert>
+#include <cstdio>
+
+/* The vector size of the plaintext that we will use for the demo.*/
+#define VECTOR_SIZE 8
+
+/* Number of batches of the pipeline.*/
+#define NB_BATCHES 6
+
+
+int main(int argc, char *argv[])
+{
+    // Display the title of the program.
+    std::cout <<"" <<endl;
+    std::cout <<"     ************Demo_Cyfhel_Async************" <<endl;
+    std::cout <<"" <<endl;
+
+    std::cout <<"******Generation of the keys for encryption******"<<endl<<endl;
+
+	Cyfhel cy(false, 1031, 1, 2, 1, 80, 64, 8);
+	const long p2r = cy.getp2r();
+
+	// The plaintexts of the batches.
+	vector< vector<long> > batches;
+	for(long k=0; k<NB_BATCHES; k++)
+	{
+		vector<long> v;
+		for(long i=0; i<VECTOR_SIZE; i++)
+		{
+			v.push_back((k*VECTOR_SIZE + i) % 30);
+		}
+		batches.push_back(v);
+	}
+
+	Timer timerDemo(true);
+	timerDemo.start();
+
+	// Start the encryption of the first batch, then at each step start the encryption of the next batch
+	// before evaluating the current one: (x+1)*x + x.
+	vector< std::future< vector<long> > > results;
+	std::future<CyCtxt> nextBatch = cy.encryptAsync(batches[0]);
+	for(long k=0; k<NB_BATCHES; k++)
+	{
+		CyCtxt c = nextBatch.get();
+		if(k+1 < NB_BATCHES)
+		{
+			nextBatch = cy.encryptAsync(batches[k+1]);
+		}
+		std::future<CyCtxt> cPlusOne = CyAsync::add(c, 1);
+		std::future<CyCtxt> cProduct = CyAsync::multiply(cPlusOne.get(), c);
+		std::future<CyCtxt> cResult = CyAsync::add(cProduct.get(), c);
+		results.push_back(cy.decryptAsync(cResult.get()));
+	}
+
+	long errors = 0;
+	for(long k=0; k<NB_BATCHES; k++)
+	{
+		vector<long> r = results[k].get();
+		for(long i=0; i<VECTOR_SIZE; i++)
+		{
+			long x = batches[k][i];
+			if(r[i] != ((x+1)*x + x) % p2r)
+			{
+				errors++;
+			}
+		}
+		std::cout << "Batch " << k << ": " << r << endl;
+	}
+
+	timerDemo.stop();
+	timerDemo.benchmarkInSeconds();
+
+    // Skip a line.
+    std::cout <<"\n"<<endl;
+
+	if(errors != 0)
+	{
+		std::cout << "Demo_Cyfhel_Async FAILED: " << errors << " mismatches." << endl;
+		return 1;
+	}
+
+    // Display the end of the program.
+    std::cout <<"     ************End of Demo_Cyfhel_Async************" <<endl;
+
+    // Skip a line.
+    std::cout <<"\n"<<endl;
+
+    // If success, return 0.
+    return 0;
+};
@@ -0,0 +1,144 @@
+/*
+#   Demo_Cyfhel_Bootstrapping
+#   --------------------------------------------------------------------
+#   Bootstrappable Cyfhel: a chain of NB_MULTIPLICATIONS products, deeper
+#   than the modulus chain allows, runs with the automatic recryption.
+#   An explicit recrypt is also checked.
+#   --------------------------------------------------------------------
+#   Author: Remy AUDA & Alexandre AUDA
+#   Date: 19/10/2026
+#   --------------------------------------------------------------------
+#   License: GNU GPL v3
+#
+#   Demo_Cyfhel is free software: you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation, either version 3 of the License, or
+#   (at your option) any later version.
+#
+#   Demo_Cyfhel is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#   --------------------------------------------------------------------
+*/
+
+/* Import all the packages useful for the Demo.*/
+#include <NTL/ZZ.h>
+#include <NTL/BasicThreadPool.h>
+#include <FHE.h>
+#include <timing.h>
+#include <EncryptedArray.h>
+#include <NTL/lzz_pXFactoring.h>
+
+#include <Cyfhel.h>
+#include "Timer.h"
+
+#include <cassert>
+#include <cstdio>
+
+/* The vector size of the plaintext that we will use for the demo.*/
+#define VECTOR_SIZE 10
+
+/* The number of products of the chain.*/
+#define NB_MULTIPLICATIONS 40
+
+/* Recrypt the products with less levels left.*/
+#define MIN_LEVEL 3
+
+
+int main(int argc, char *argv[])
+{
+    // Display the title of the program.
+    std::cout <<"" <<endl;
+    std::cout <<"     ************Demo_Cyfhel_Bootstrapping************" <<endl;
+    std::cout <<"" <<endl;
+
+    std::cout <<"******Generation of the keys and of the bootstrapping data******"<<endl<<endl;
+
+	// m = 1705 = 11*155, p = 2, r = 1, L = 25 (the parameters of Test_bootstrapping).
+	vector<long> mvec;
+	mvec.push_back(11);
+	mvec.push_back(155);
+	vector<long> gens;
+	gens.push_back(156);
+	gens.push_back(936);
+	vector<long> ords;
+	ords.push_back(10);
+	ords.push_back(6);
+	Cyfhel cy(mvec, 2, 1, 25, 3, 1705, gens, ords);
+
+	if(!cy.isBootstrappable())
+	{
+		std::cout << "Demo_Cyfhel_Bootstrapping FAILED: the scheme is not bootstrappable." << endl;
+		return 1;
+	}
+
+	vector<long> v;
+	vector<long> ones(VECTOR_SIZE, 1);
+	for(long i=0; i<VECTOR_SIZE; i++)
+	{
+		v.push_back(RandomBnd(2));
+	}
+	std::cout << "v -> " << v << endl << endl;
+
+	long errors = 0;
+
+	Timer timerDemo(true);
+	timerDemo.start();
+
+    std::cout <<"******Explicit recrypt******"<<endl<<endl;
+	CyCtxt c = cy.encrypt(v);
+	c.recrypt();
+	vector<long> rRecrypt = cy.decrypt(c);
+	std::cout << "Decrypt -> " << rRecrypt << endl;
+	for(long i=0; i<VECTOR_SIZE; i++)
+	{
+		if(rRecrypt[i] != v[i])
+		{
+			errors++;
+		}
+	}
+
+    std::cout <<"******"<< NB_MULTIPLICATIONS <<" products with the automatic recryption******"<<endl<<endl;
+	CyCtxt::setAutoRecrypt(MIN_LEVEL);
+	CyCtxt cOnes = cy.encrypt(ones);
+	CyCtxt cChain = cy.encrypt(v);
+	for(long k=0; k<NB_MULTIPLICATIONS; k++)
+	{
+		cChain = cChain * cOnes;
+	}
+	CyCtxt::disableAutoRecrypt();
+	vector<long> rChain = cy.decrypt(cChain);
+	std::cout << "Decrypt -> " << rChain << endl;
+	for(long i=0; i<VECTOR_SIZE; i++)
+	{
+		if(rChain[i] != v[i])
+		{
+			errors++;
+		}
+	}
+
+	timerDemo.stop();
+	timerDemo.benchmarkInSeconds();
+
+    // Skip a line.
+    std::cout <<"\n"<<endl;
+
+	if(errors != 0)
+	{
+		std::cout << "Demo_Cyfhel_Bootstrapping FAILED: " << errors << " mismatches." << endl;
+		return 1;
+	}
+
+    // Display the end of the program.
+    std::cout <<"     ************End of Demo_Cyfhel_Bootstrapping************" <<endl;
+
+    // Skip a line.
+    std::cout <<"\n"<<endl;
+
+    // If success, return 0.
+    return 0;
+};
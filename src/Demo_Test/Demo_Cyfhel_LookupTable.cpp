@@ -0,0 +1,143 @@
+/*
+#   Demo_Cyfhel_LookupTable
+#   --------------------------------------------------------------------
+#   Threshold and buckets of encrypted values with lookup tables: each
+#   table is interpolated once into a polynome, then evaluated on the
+#   ciphertexts. The results are checked.
+#   --------------------------------------------------------------------
+#   Author: Remy AUDA & Alexandre AUDA
+#   Date: 19/10/2026
+#   --------------------------------------------------------------------
+#   License: GNU GPL v3
+#
+#   Demo_Cyfhel is free software: you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation, either version 3 of the License, or
+#   (at your option) any later version.
+#
+#   Demo_Cyfhel is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#   --------------------------------------------------------------------
+*/
+
+/* Import all the packages useful for the Demo.*/
+#include <NTL/ZZ.h>
+#include <NTL/BasicThreadPool.h>
+#include <FHE.h>
+#include <timing.h>
+#include <EncryptedArray.h>
+#include <NTL/lzz_pXFactoring.h>
+
+#include <Cyfhel.h>
+#include "Timer.h"
+
+#include <cassert>
+#include <cstdio>
+
+/* The vector size of the plaintext that we will use for the demo.*/
+#define VECTOR_SIZE 10
+
+/* The domain of the values: 0, ..., DOMAIN_SIZE-1.*/
+#define DOMAIN_SIZE 32
+
+/* The threshold of the demo.*/
+#define THRESHOLD 12
+
+/* The width of the buckets of the demo.*/
+#define BUCKET_WIDTH 8
+
+
+/*
+	@name: check
+	@description: Decrypt c and compare each slot with table[v[i]].
+
+	@return: Return the number of mismatches.
+*/
+static long check(Cyfhel& cy, CyCtxt& c, vector<long> const& v, vector<long> const& table){
+	vector<long> r = cy.decrypt(c);
+	std::cout << "Decrypt -> " << r << endl;
+	long errors = 0;
+	for(long i=0; i<(long) v.size(); i++)
+	{
+		if(r[i] != table[v[i]])
+		{
+			errors++;
+		}
+	}
+	return errors;
+}
+
+
+int main(int argc, char *argv[])
+{
+    // Display the title of the program.
+    std::cout <<"" <<endl;
+    std::cout <<"     ************Demo_Cyfhel_LookupTable************" <<endl;
+    std::cout <<"" <<endl;
+
+    std::cout <<"******Generation of the keys for encryption******"<<endl<<endl;
+
+	Cyfhel cy(false, 257, 1, 2, 1, 80, 64, 16);
+
+	// The lookup tables: x >= THRESHOLD, and x / BUCKET_WIDTH.
+	vector<long> threshold;
+	vector<long> buckets;
+	for(long x=0; x<DOMAIN_SIZE; x++)
+	{
+		threshold.push_back(x >= THRESHOLD ? 1 : 0);
+		buckets.push_back(x / BUCKET_WIDTH);
+	}
+
+	vector<long> v;
+	for(long i=0; i<VECTOR_SIZE; i++)
+	{
+		v.push_back(RandomBnd(DOMAIN_SIZE));
+	}
+	std::cout << "x -> " << v << endl << endl;
+
+	long errors = 0;
+
+	Timer timerDemo(true);
+	timerDemo.start();
+
+    std::cout <<"******Threshold x >= "<< THRESHOLD <<"******"<<endl<<endl;
+	CyCtxt cThreshold = cy.encrypt(v);
+	cy.applyLookupTable(cThreshold, threshold);
+	errors += check(cy, cThreshold, v, threshold);
+
+    std::cout <<"******Buckets of width "<< BUCKET_WIDTH <<"******"<<endl<<endl;
+	CyCtxt cBuckets = cy.encrypt(v);
+	cy.applyLookupTable(cBuckets, buckets);
+	errors += check(cy, cBuckets, v, buckets);
+
+    std::cout <<"******Threshold again, with the cached polynome******"<<endl<<endl;
+	CyCtxt cThreshold2 = cy.encrypt(v);
+	cy.applyLookupTable(cThreshold2, threshold);
+	errors += check(cy, cThreshold2, v, threshold);
+
+	timerDemo.stop();
+	timerDemo.benchmarkInSeconds();
+
+    // Skip a line.
+    std::cout <<"\n"<<endl;
+
+	if(errors != 0)
+	{
+		std::cout << "Demo_Cyfhel_LookupTable FAILED: " << errors << " mismatches." << endl;
+		return 1;
+	}
+
+    // Display the end of the program.
+    std::cout <<"     ************End of Demo_Cyfhel_LookupTable************" <<endl;
+
+    // Skip a line.
+    std::cout <<"\n"<<endl;
+
+    // If success, return 0.
+    return 0;
+};
@@ -0,0 +1,150 @@
+/*
+#   Demo_Cyfhel_MatMul
+#   --------------------------------------------------------------------
+#   Products of encrypted matrices tiled across several CyCtxt: an
+#   encrypted matrix by a plaintext one and by an encrypted one, with
+#   more rows than slots so that the columns take several CyCtxt.
+#   The results are checked.
+#   --------------------------------------------------------------------
+#   Author: Remy AUDA & Alexandre AUDA
+#   Date: 19/10/2026
+#   --------------------------------------------------------------------
+#   License: GNU GPL v3
+#
+#   Demo_Cyfhel is free software: you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation, either version 3 of the License, or
+#   (at your option) any later version.
+#
+#   Demo_Cyfhel is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#   --------------------------------------------------------------------
+*/
+
+/* Import all the packages useful for the Demo.*/
+#include <NTL/ZZ.h>
+#include <NTL/BasicThreadPool.h>
+#include <FHE.h>
+#include <timing.h>
+#include <EncryptedArray.h>
+#include <NTL/lzz_pXFactoring.h>
+
+#include <Cyfhel.h>
+#include "Timer.h"
+
+#include <cassert>
+#include <cstdio>
+
+/* The inner size of the products of the demo.*/
+#define INNER_SIZE 6
+
+/* The number of columns of the right matrices.*/
+#define NB_COLUMNS 3
+
+
+/*
+	@name: randomMatrix
+	@description: Random matrix of rows x cols entries modulo p2r.
+
+	@return: Return the entries of the matrix, row by row.
+*/
+static vector< vector<long> > randomMatrix(long rows, long cols, long p2r){
+	vector< vector<long> > M(rows, vector<long>(cols));
+	for(long i=0; i<rows; i++)
+	{
+		for(long j=0; j<cols; j++)
+		{
+			M[i][j] = RandomBnd(p2r);
+		}
+	}
+	return M;
+}
+
+/*
+	@name: check
+	@description: Compare the decrypted product with A*B mod p2r.
+
+	@return: Return the number of mismatches.
+*/
+static long check(vector< vector<long> > const& result, vector< vector<long> > const& A, vector< vector<long> > const& B, long p2r){
+	long errors = 0;
+	for(unsigned long i=0; i<A.size(); i++)
+	{
+		for(unsigned long l=0; l<B[0].size(); l++)
+		{
+			long expected = 0;
+			for(unsigned long j=0; j<B.size(); j++)
+			{
+				expected = (expected + A[i][j]*B[j][l]) % p2r;
+			}
+			if(result[i][l] != expected)
+			{
+				errors++;
+			}
+		}
+	}
+	return errors;
+}
+
+
+int main(int argc, char *argv[])
+{
+    // Display the title of the program.
+    std::cout <<"" <<endl;
+    std::cout <<"     ************Demo_Cyfhel_MatMul************" <<endl;
+    std::cout <<"" <<endl;
+
+    std::cout <<"******Generation of the keys for encryption******"<<endl<<endl;
+
+	Cyfhel cy(false, 1031, 1, 2, 1, 80, 64, 8);
+	const long p2r = cy.getp2r();
+	// More rows than slots: each column of A takes two CyCtxt.
+	const long rows = cy.getm_numberOfSlots() + 2;
+
+	vector< vector<long> > A = randomMatrix(rows, INNER_SIZE, p2r);
+	vector< vector<long> > B = randomMatrix(INNER_SIZE, NB_COLUMNS, p2r);
+
+	long errors = 0;
+
+	Timer timerDemo(true);
+	timerDemo.start();
+
+    std::cout <<"******Encryption of A******"<<endl<<endl;
+	CyCtxtMatrix encryptedA = cy.encryptMatrix(A);
+	std::cout << encryptedA << endl;
+
+    std::cout <<"******Encrypted A times plaintext B******"<<endl<<endl;
+	CyCtxtMatrix product = cy.matMul(encryptedA, B);
+	errors += check(cy.decryptMatrix(product), A, B, p2r);
+
+    std::cout <<"******Encrypted A times encrypted B******"<<endl<<endl;
+	CyCtxtMatrix encryptedB = cy.encryptMatrix(B);
+	CyCtxtMatrix product2 = cy.matMul(encryptedA, encryptedB);
+	errors += check(cy.decryptMatrix(product2), A, B, p2r);
+
+	timerDemo.stop();
+	timerDemo.benchmarkInSeconds();
+
+    // Skip a line.
+    std::cout <<"\n"<<endl;
+
+	if(errors != 0)
+	{
+		std::cout << "Demo_Cyfhel_MatMul FAILED: " << errors << " mismatches." << endl;
+		return 1;
+	}
+
+    // Display the end of the program.
+    std::cout <<"     ************End of Demo_Cyfhel_MatMul************" <<endl;
+
+    // Skip a line.
+    std::cout <<"\n"<<endl;
+
+    // If success, return 0.
+    return 0;
+};
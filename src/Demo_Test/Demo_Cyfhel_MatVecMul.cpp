@@ -0,0 +1,162 @@
+/*
+#   Demo_Cyfhel_MatVecMul
+#   --------------------------------------------------------------------
+#   Products of encrypted vectors by plaintext matrices: a dense matrix
+#   and a tridiagonal (sparse) one, each used for several vectors with
+#   the constants of its diagonals built once. The constants of the
+#   dense matrix are kept in a cache file, read again by a second handle.
+#   The results are checked.
+#   --------------------------------------------------------------------
+#   Author: Remy AUDA & Alexandre AUDA
+#   Date: 19/10/2026
+#   --------------------------------------------------------------------
+#   License: GNU GPL v3
+#
+#   Demo_Cyfhel is free software: you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation, either version 3 of the License, or
+#   (at your option) any later version.
+#
+#   Demo_Cyfhel is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#   --------------------------------------------------------------------
+*/
+
+/* Import all the packages useful for the Demo.*/
+#include <NTL/ZZ.h>
+#include <NTL/BasicThreadPool.h>
+#include <FHE.h>
+#include <timing.h>
+#include <EncryptedArray.h>
+#include <NTL/lzz_pXFactoring.h>
+
+#include <Cyfhel.h>
+#include "Timer.h"
+
+#include <cassert>
+#include <cstdio>
+
+/* The size of the matrices of the demo.*/
+#define MATRIX_SIZE 8
+
+/* Number of vectors multiplied by each matrix.*/
+#define NB_VECTORS 3
+
+/* The cache file of the dense matrix.*/
+#define CACHE_FILE "Demo_Cyfhel_MatVecMul.cache"
+
+
+/*
+	@name: check
+	@description: Encrypt NB_VECTORS random vectors, multiply them by matrix and compare with M*x mod p2r.
+
+	@return: Return the number of mismatches.
+*/
+static long check(Cyfhel& cy, CyMatrix& matrix, vector< vector<long> > const& M, long p2r){
+	long errors = 0;
+	for(long k=0; k<NB_VECTORS; k++)
+	{
+		vector<long> x;
+		for(long i=0; i<MATRIX_SIZE; i++)
+		{
+			x.push_back(RandomBnd(p2r));
+		}
+		CyCtxt c = cy.encrypt(x);
+		cy.matVecMul(c, matrix);
+		vector<long> r = cy.decrypt(c);
+		std::cout << "Decrypt -> " << r << endl;
+		for(long i=0; i<MATRIX_SIZE; i++)
+		{
+			long expected = 0;
+			for(long j=0; j<MATRIX_SIZE; j++)
+			{
+				expected = (expected + M[i][j]*x[j]) % p2r;
+			}
+			if(r[i] != expected)
+			{
+				errors++;
+			}
+		}
+	}
+	return errors;
+}
+
+
+int main(int argc, char *argv[])
+{
+    // Display the title of the program.
+    std::cout <<"" <<endl;
+    std::cout <<"     ************Demo_Cyfhel_MatVecMul************" <<endl;
+    std::cout <<"" <<endl;
+
+    std::cout <<"******Generation of the keys for encryption******"<<endl<<endl;
+
+	Cyfhel cy(false, 1031, 1, 2, 1, 80, 64, 8);
+	const long p2r = cy.getp2r();
+	remove(CACHE_FILE);
+
+	vector< vector<long> > dense(MATRIX_SIZE, vector<long>(MATRIX_SIZE));
+	vector< vector<long> > tridiagonal(MATRIX_SIZE, vector<long>(MATRIX_SIZE, 0));
+	for(long i=0; i<MATRIX_SIZE; i++)
+	{
+		for(long j=0; j<MATRIX_SIZE; j++)
+		{
+			dense[i][j] = RandomBnd(p2r);
+		}
+		for(long j=max(0L, i-1); j<=min(MATRIX_SIZE-1L, i+1); j++)
+		{
+			tridiagonal[i][j] = RandomBnd(p2r);
+		}
+	}
+
+	long errors = 0;
+
+	Timer timerDemo(true);
+	timerDemo.start();
+
+    std::cout <<"******Dense matrix, constants written in "<< CACHE_FILE <<"******"<<endl<<endl;
+	std::shared_ptr<CyMatrix> denseMatrix = cy.matrix(dense, CyMatrix::dense, CACHE_FILE);
+	std::cout << *denseMatrix << endl;
+	errors += check(cy, *denseMatrix, dense, p2r);
+
+    std::cout <<"******Dense matrix, constants read from "<< CACHE_FILE <<"******"<<endl<<endl;
+	CyMatrix denseMatrix2(cy.getm_encryptedArray(), dense, CyMatrix::dense, CACHE_FILE);
+	errors += check(cy, denseMatrix2, dense, p2r);
+	if(!denseMatrix2.isCacheLoaded())
+	{
+		std::cout << "The cache file was not used." << endl;
+		errors++;
+	}
+
+    std::cout <<"******Tridiagonal matrix******"<<endl<<endl;
+	std::shared_ptr<CyMatrix> sparseMatrix = cy.matrix(tridiagonal);
+	std::cout << *sparseMatrix << endl;
+	errors += check(cy, *sparseMatrix, tridiagonal, p2r);
+
+	timerDemo.stop();
+	timerDemo.benchmarkInSeconds();
+	remove(CACHE_FILE);
+
+    // Skip a line.
+    std::cout <<"\n"<<endl;
+
+	if(errors != 0)
+	{
+		std::cout << "Demo_Cyfhel_MatVecMul FAILED: " << errors << " mismatches." << endl;
+		return 1;
+	}
+
+    // Display the end of the program.
+    std::cout <<"     ************End of Demo_Cyfhel_MatVecMul************" <<endl;
+
+    // Skip a line.
+    std::cout <<"\n"<<endl;
+
+    // If success, return 0.
+    return 0;
+};
@@ -0,0 +1,139 @@
+/*
+#   Demo_Cyfhel_MaxOfVector
+#   --------------------------------------------------------------------
+#   Encrypted comparisons with a plaintext space 2^r: compareGT and max
+#   slot by slot, then the maximum of a vector and its index with
+#   maxOfVector. The results are checked.
+#   --------------------------------------------------------------------
+#   Author: Remy AUDA & Alexandre AUDA
+#   Date: 19/10/2026
+#   --------------------------------------------------------------------
+#   License: GNU GPL v3
+#
+#   Demo_Cyfhel is free software: you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation, either version 3 of the License, or
+#   (at your option) any later version.
+#
+#   Demo_Cyfhel is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#   --------------------------------------------------------------------
+*/
+
+/* Import all the packages useful for the Demo.*/
+#include <NTL/ZZ.h>
+#include <NTL/BasicThreadPool.h>
+#include <FHE.h>
+#include <timing.h>
+#include <EncryptedArray.h>
+#include <NTL/lzz_pXFactoring.h>
+
+#include <Cyfhel.h>
+#include "Timer.h"
+
+#include <cassert>
+#include <cstdio>
+
+/* The vector size of the plaintext that we will use for the demo.*/
+#define VECTOR_SIZE 8
+
+/* The number of bits of the values.*/
+#define NB_BITS 4
+
+
+int main(int argc, char *argv[])
+{
+    // Display the title of the program.
+    std::cout <<"" <<endl;
+    std::cout <<"     ************Demo_Cyfhel_MaxOfVector************" <<endl;
+    std::cout <<"" <<endl;
+
+    std::cout <<"******Generation of the keys for encryption******"<<endl<<endl;
+
+	// p = 2 and r = 8: values of NB_BITS bits can be compared.
+	Cyfhel cy(false, 2, 8, 2, 1, 80, 64, 40);
+
+	vector<long> v1;
+	vector<long> v2;
+	for(long i=0; i<VECTOR_SIZE; i++)
+	{
+		v1.push_back(RandomBnd(1L << NB_BITS));
+		v2.push_back(RandomBnd(1L << NB_BITS));
+	}
+	std::cout << "v1 -> " << v1 << endl;
+	std::cout << "v2 -> " << v2 << endl << endl;
+
+	CyCtxt c1 = cy.encrypt(v1);
+	CyCtxt c2 = cy.encrypt(v2);
+
+	long errors = 0;
+
+	Timer timerDemo(true);
+	timerDemo.start();
+
+    std::cout <<"******v1 > v2******"<<endl<<endl;
+	vector<long> rGreater = cy.decrypt(c1.compareGT(c2, NB_BITS));
+	std::cout << "Decrypt -> " << rGreater << endl;
+	for(long i=0; i<VECTOR_SIZE; i++)
+	{
+		if(rGreater[i] != (v1[i] > v2[i] ? 1 : 0))
+		{
+			errors++;
+		}
+	}
+
+    std::cout <<"******max(v1, v2)******"<<endl<<endl;
+	vector<long> rMax = cy.decrypt(c1.max(c2, NB_BITS));
+	std::cout << "Decrypt -> " << rMax << endl;
+	for(long i=0; i<VECTOR_SIZE; i++)
+	{
+		if(rMax[i] != std::max(v1[i], v2[i]))
+		{
+			errors++;
+		}
+	}
+
+    std::cout <<"******Maximum of v1 and its index******"<<endl<<endl;
+	CyCtxt cArgmax = c1;
+	vector<long> rMaxOfVector = cy.decrypt(cy.maxOfVector(c1, VECTOR_SIZE, NB_BITS, &cArgmax));
+	vector<long> rArgmax = cy.decrypt(cArgmax);
+	long expectedArgmax = 0;
+	for(long i=1; i<VECTOR_SIZE; i++)
+	{
+		if(v1[i] > v1[expectedArgmax])
+		{
+			expectedArgmax = i;
+		}
+	}
+	std::cout << "Maximum -> " << rMaxOfVector[0] << " at index " << rArgmax[0] << endl;
+	if(rMaxOfVector[0] != v1[expectedArgmax] || rArgmax[0] != expectedArgmax)
+	{
+		errors++;
+	}
+
+	timerDemo.stop();
+	timerDemo.benchmarkInSeconds();
+
+    // Skip a line.
+    std::cout <<"\n"<<endl;
+
+	if(errors != 0)
+	{
+		std::cout << "Demo_Cyfhel_MaxOfVector FAILED: " << errors << " mismatches." << endl;
+		return 1;
+	}
+
+    // Display the end of the program.
+    std::cout <<"     ************End of Demo_Cyfhel_MaxOfVector************" <<endl;
+
+    // Skip a line.
+    std::cout <<"\n"<<endl;
+
+    // If success, return 0.
+    return 0;
+};
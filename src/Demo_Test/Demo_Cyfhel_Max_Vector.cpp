@@ -27,6 +27,7 @@ NTL_CLIENT
 
 #include <Cyfhel.h>
 #include <CyCtxt.h>
+#include <CyScheduler.h>
 
 #include <cassert>
 #include <cstdio>
@@ -258,6 +259,7 @@ int main(int argc, char *argv[])
   long p = 2;
   long r=0;
   long m = 0;
+  long threads = 0;
   bool dry = false;
 
   amap.arg("x", x, "value x");
@@ -265,6 +267,7 @@ int main(int argc, char *argv[])
   amap.arg("p", p, "plaintext base");
   amap.arg("r", r, "lifting");
   amap.arg("m", m, "the cyclotomic ring", "heuristic");
+  amap.arg("threads", threads, "threads running the comparisons", "all cores");
   amap.arg("noPrint", noPrint, "suppress printouts");
   amap.arg("dry", dry, "dry=1 for a dry-run");
 
@@ -321,29 +324,45 @@ int main(int argc, char *argv[])
   tMethod2.start();
   vector<CyCtxt> vectc2;
 
-  vector<long> v3;
-  v3.push_back(1);
-
-  //vector<long> vtest;
-  //vector<long> vtest2;
+  // The VEC_SIZE*(VEC_SIZE-1) comparisons are independent: build them as a circuit and let the
+  // work-stealing pool run them concurrently. vectc2[i] is the product of all the comparisons of i.
+  CyCircuit circuit;
+  vector<long> inputs;
+  for(int i=0; i<VEC_SIZE; i++){
+      inputs.push_back(circuit.input(c1[i]));
+  }
 
+  vector<long> products;
   for(int i=0; i<VEC_SIZE; i++){
-      // c2 is initialize as Encrypt(1).
-      CyCtxt c2 = cy.encrypt(v3);
-      int j= 0;
-      while(j!=VEC_SIZE){
+      vector<long> maxij;
+      for(int j=0; j<VEC_SIZE; j++){
           if(i!=j){
-			 CyCtxt maxij = cypherBitsRemy(cy, c1[i], c1[j], p, r, m, noPrint, dry);
-			 //vtest = cy.decrypt(maxij);
-			 //vtest.resize(1);
-			 //cout <<"maxij = "<<vtest<<endl;
-			 c2 *= maxij;
-			 //vtest2 = cy.decrypt(c2);
-			 //cout <<"c2 = "<<vtest2<<endl;
-              }
-          j++;
+              maxij.push_back(circuit.operation({inputs[i], inputs[j]},
+                  [&cy, p, r, m, dry](vector<CyCtxt const*> const& in){
+                      CyCtxt x = *in[0];
+                      CyCtxt y = *in[1];
+                      return cypherBitsRemy(cy, x, y, p, r, m, noPrint, dry);
+                  }));
+          }
+      }
+      // Multiply the comparisons as a balanced tree, the products of each level are independent too.
+      while(maxij.size() > 1){
+          vector<long> next;
+          for(unsigned long k=0; k+1<maxij.size(); k+=2){
+              next.push_back(circuit.multiply(maxij[k], maxij[k+1]));
+          }
+          if(maxij.size() % 2 == 1){
+              next.push_back(maxij.back());
           }
-          vectc2.push_back(c2);
+          maxij = next;
+      }
+      products.push_back(maxij[0]);
+  }
+
+  circuit.run(threads);
+
+  for(int i=0; i<VEC_SIZE; i++){
+      vectc2.push_back(circuit.getResult(products[i]));
   }
 
   tMethod2.stop();
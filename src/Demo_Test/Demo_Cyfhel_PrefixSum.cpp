@@ -0,0 +1,107 @@
+/*
+#   Demo_Cyfhel_PrefixSum
+#   --------------------------------------------------------------------
+#   Running sums of the slots of a CyCtxt by CyCtxt::prefixSum, timed
+#   against runningSums of HElib. Both results are checked against the
+#   plaintext running sums.
+#   --------------------------------------------------------------------
+#   Author: Remy AUDA & Alexandre AUDA
+#   Date: 19/10/2026
+#   --------------------------------------------------------------------
+#   License: GNU GPL v3
+#
+#   Demo_Cyfhel is free software: you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation, either version 3 of the License, or
+#   (at your option) any later version.
+#
+#   Demo_Cyfhel is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#   --------------------------------------------------------------------
+*/
+
+/* Import all the packages useful for the Demo.*/
+#include <NTL/ZZ.h>
+#include <NTL/BasicThreadPool.h>
+#include <FHE.h>
+#include <timing.h>
+#include <EncryptedArray.h>
+#include <NTL/lzz_pXFactoring.h>
+
+#include <Cyfhel.h>
+#include "Timer.h"
+
+#include <cassert>
+#include <cstdio>
+
+
+int main(int argc, char *argv[])
+{
+    // Display the title of the program.
+    std::cout <<"" <<endl;
+    std::cout <<"     ************Demo_Cyfhel_PrefixSum************" <<endl;
+    std::cout <<"" <<endl;
+
+    std::cout <<"******Generation of the keys for encryption******"<<endl<<endl;
+
+	Cyfhel cy(false, 1031, 1, 2, 1, 80, 64, 8);
+	const long p2r = cy.getp2r();
+	const long nslots = cy.getm_numberOfSlots();
+
+	vector<long> v(nslots), expected(nslots);
+	for(long i=0; i<nslots; i++)
+	{
+		v[i] = RandomBnd(p2r);
+		expected[i] = ((i > 0 ? expected[i-1] : 0) + v[i]) % p2r;
+	}
+	CyCtxt c = cy.encrypt(v);
+	CyCtxt c2 = c;
+
+    std::cout <<"******CyCtxt::prefixSum******"<<endl<<endl;
+	Timer timerPrefixSum(true);
+	timerPrefixSum.start();
+	c.prefixSum();// The masks are encoded by this first call
+	timerPrefixSum.stop();
+	timerPrefixSum.benchmarkInSeconds();
+
+    std::cout <<"******runningSums******"<<endl<<endl;
+	Timer timerRunningSums(true);
+	timerRunningSums.start();
+	runningSums(cy.getm_encryptedArray(), c2);
+	timerRunningSums.stop();
+	timerRunningSums.benchmarkInSeconds();
+
+	vector<long> r = cy.decrypt(c, false);
+	vector<long> r2 = cy.decrypt(c2, false);
+	long errors = 0;
+	for(long i=0; i<nslots; i++)
+	{
+		if(r[i] != expected[i] || r2[i] != expected[i])
+		{
+			errors++;
+		}
+	}
+
+    // Skip a line.
+    std::cout <<"\n"<<endl;
+
+	if(errors != 0)
+	{
+		std::cout << "Demo_Cyfhel_PrefixSum FAILED: " << errors << " mismatches." << endl;
+		return 1;
+	}
+
+    // Display the end of the program.
+    std::cout <<"     ************End of Demo_Cyfhel_PrefixSum************" <<endl;
+
+    // Skip a line.
+    std::cout <<"\n"<<endl;
+
+    // If success, return 0.
+    return 0;
+};
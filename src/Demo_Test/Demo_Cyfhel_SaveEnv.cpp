@@ -0,0 +1,203 @@
+/*
+#   Demo_Cyfhel_SaveEnv
+#   --------------------------------------------------------------------
+#   Round trip of a bootstrappable environment: saveEnv writes the .aenv
+#   and .arcd files, restoreEnv reads them into a fresh Cyfhel object,
+#   which must recrypt correctly. A .arcd file written for another
+#   context must be rejected by RecryptData::read, and a truncated .arcd
+#   file must make restoreEnv recompute the recryption data.
+#   --------------------------------------------------------------------
+#   Author: Remy AUDA & Alexandre AUDA
+#   Date: 19/10/2026
+#   --------------------------------------------------------------------
+#   License: GNU GPL v3
+#
+#   Demo_Cyfhel is free software: you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation, either version 3 of the License, or
+#   (at your option) any later version.
+#
+#   Demo_Cyfhel is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#   --------------------------------------------------------------------
+*/
+
+/* Import all the packages useful for the Demo.*/
+#include <NTL/ZZ.h>
+#include <NTL/BasicThreadPool.h>
+#include <FHE.h>
+#include <timing.h>
+#include <EncryptedArray.h>
+#include <NTL/lzz_pXFactoring.h>
+
+#include <Cyfhel.h>
+#include "Timer.h"
+
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+/* The vector size of the plaintext that we will use for the demo.*/
+#define VECTOR_SIZE 10
+
+/* The names of the saved environments.*/
+#define ENV_NAME "Demo_Cyfhel_SaveEnv"
+#define TRUNCATED_ENV_NAME "Demo_Cyfhel_SaveEnv_truncated"
+
+
+/* Read a whole file in a string.*/
+string readFile(string const& fileName)
+{
+	ifstream file(fileName.c_str(), ios::in|ios::binary);
+	stringstream content;
+	content << file.rdbuf();
+	return content.str();
+}
+
+/* Write a string in a file.*/
+void writeFile(string const& fileName, string const& content)
+{
+	ofstream file(fileName.c_str(), ios::out|ios::trunc|ios::binary);
+	file << content;
+}
+
+/* Restore the environment fileName in a fresh Cyfhel object, recrypt an encryption of v and count the wrong slots.*/
+long restoreAndRecrypt(string const& fileName, vector<long> const& v)
+{
+	Cyfhel cy(false, 2, 1, 2, 1, 80, 64, 4);
+	if(!cy.restoreEnv(fileName) || !cy.isBootstrappable())
+	{
+		std::cout << "restoreEnv(" << fileName << ") failed." << endl;
+		return VECTOR_SIZE;
+	}
+	CyCtxt c = cy.encrypt(v);
+	c.recrypt();
+	vector<long> r = cy.decrypt(c);
+	std::cout << "Decrypt -> " << r << endl;
+	long errors = 0;
+	for(long i=0; i<VECTOR_SIZE; i++)
+	{
+		if(r[i] != v[i])
+		{
+			errors++;
+		}
+	}
+	return errors;
+}
+
+
+int main(int argc, char *argv[])
+{
+    // Display the title of the program.
+    std::cout <<"" <<endl;
+    std::cout <<"     ************Demo_Cyfhel_SaveEnv************" <<endl;
+    std::cout <<"" <<endl;
+
+    std::cout <<"******Generation of the keys and of the bootstrapping data******"<<endl<<endl;
+
+	// m = 1705 = 11*155, p = 2, r = 1, L = 25 (the parameters of Test_bootstrapping).
+	vector<long> mvec;
+	mvec.push_back(11);
+	mvec.push_back(155);
+	vector<long> gens;
+	gens.push_back(156);
+	gens.push_back(936);
+	vector<long> ords;
+	ords.push_back(10);
+	ords.push_back(6);
+	Cyfhel cy(mvec, 2, 1, 25, 3, 1705, gens, ords);
+
+	vector<long> v;
+	for(long i=0; i<VECTOR_SIZE; i++)
+	{
+		v.push_back(RandomBnd(2));
+	}
+	std::cout << "v -> " << v << endl << endl;
+
+	long errors = 0;
+
+	Timer timerDemo(true);
+	timerDemo.start();
+
+    std::cout <<"******Save and restore******"<<endl<<endl;
+	if(!cy.saveEnv(ENV_NAME))
+	{
+		std::cout << "Demo_Cyfhel_SaveEnv FAILED: saveEnv failed." << endl;
+		return 1;
+	}
+	errors += restoreAndRecrypt(ENV_NAME, v);
+
+    std::cout <<"******RecryptData::read******"<<endl<<endl;
+	FHEcontext const& context = cy.getm_encryptedArray().getContext();
+	string recryptData = readFile(string(ENV_NAME)+".arcd");
+	{
+		// The data written by saveEnv is read back as it was computed.
+		istringstream in(recryptData);
+		RecryptData rcData;
+		if(!rcData.read(in, context) || rcData != context.rcData || rcData.e != context.rcData.e ||
+		   rcData.ePrime != context.rcData.ePrime || rcData.unpackSlotEncoding != context.rcData.unpackSlotEncoding)
+		{
+			std::cout << "The saved recryption data is not read back." << endl;
+			errors++;
+		}
+	}
+	{
+		// The fingerprint of the context is the first long of the file: another context is rejected.
+		string wrongFingerprint = recryptData;
+		wrongFingerprint[0] ^= 1;
+		istringstream in(wrongFingerprint);
+		RecryptData rcData;
+		if(rcData.read(in, context) || rcData.alMod != NULL)
+		{
+			std::cout << "Recryption data with a wrong fingerprint is accepted." << endl;
+			errors++;
+		}
+	}
+	{
+		// A truncated stream leaves the data uninitialized.
+		istringstream in(recryptData.substr(0, recryptData.size()/2));
+		RecryptData rcData;
+		if(rcData.read(in, context) || rcData.alMod != NULL)
+		{
+			std::cout << "Truncated recryption data is accepted." << endl;
+			errors++;
+		}
+	}
+
+    std::cout <<"******Restore with a truncated .arcd file******"<<endl<<endl;
+	writeFile(string(TRUNCATED_ENV_NAME)+".aenv", readFile(string(ENV_NAME)+".aenv"));
+	writeFile(string(TRUNCATED_ENV_NAME)+".arcd", recryptData.substr(0, recryptData.size()/2));
+	errors += restoreAndRecrypt(TRUNCATED_ENV_NAME, v);
+
+	timerDemo.stop();
+	timerDemo.benchmarkInSeconds();
+
+	remove((string(ENV_NAME)+".aenv").c_str());
+	remove((string(ENV_NAME)+".arcd").c_str());
+	remove((string(TRUNCATED_ENV_NAME)+".aenv").c_str());
+	remove((string(TRUNCATED_ENV_NAME)+".arcd").c_str());
+
+    // Skip a line.
+    std::cout <<"\n"<<endl;
+
+	if(errors != 0)
+	{
+		std::cout << "Demo_Cyfhel_SaveEnv FAILED: " << errors << " mismatches." << endl;
+		return 1;
+	}
+
+    // Display the end of the program.
+    std::cout <<"     ************End of Demo_Cyfhel_SaveEnv************" <<endl;
+
+    // Skip a line.
+    std::cout <<"\n"<<endl;
+
+    // If success, return 0.
+    return 0;
+};
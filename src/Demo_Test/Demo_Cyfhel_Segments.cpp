@@ -0,0 +1,122 @@
+/*
+#   Demo_Cyfhel_Segments
+#   --------------------------------------------------------------------
+#   Many independent scalar products in one CyCtxt: the vectors are
+#   packed in segments of WIDTH slots, multiplied and reduced within
+#   each segment by CyCtxt::segmentScalarProd. The results are checked
+#   against the plaintext scalar products.
+#   --------------------------------------------------------------------
+#   Author: Remy AUDA & Alexandre AUDA
+#   Date: 19/10/2026
+#   --------------------------------------------------------------------
+#   License: GNU GPL v3
+#
+#   Demo_Cyfhel is free software: you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation, either version 3 of the License, or
+#   (at your option) any later version.
+#
+#   Demo_Cyfhel is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#   --------------------------------------------------------------------
+*/
+
+/* Import all the packages useful for the Demo.*/
+#include <NTL/ZZ.h>
+#include <NTL/BasicThreadPool.h>
+#include <FHE.h>
+#include <timing.h>
+#include <EncryptedArray.h>
+#include <NTL/lzz_pXFactoring.h>
+
+#include <Cyfhel.h>
+#include "Timer.h"
+
+#include <cassert>
+#include <cstdio>
+
+/* The length of the vectors, and the maximum number of scalar products of the demo.*/
+#define WIDTH 16
+#define MAX_PRODUCTS 64
+
+
+int main(int argc, char *argv[])
+{
+    // Display the title of the program.
+    std::cout <<"" <<endl;
+    std::cout <<"     ************Demo_Cyfhel_Segments************" <<endl;
+    std::cout <<"" <<endl;
+
+    std::cout <<"******Generation of the keys for encryption******"<<endl<<endl;
+
+	Cyfhel cy(false, 1031, 1, 2, 1, 80, 64, 8);
+	const long p2r = cy.getp2r();
+	const long count = std::min((long) MAX_PRODUCTS, cy.segmentsPerCtxt(WIDTH));
+	std::cout << count << " scalar products of length " << WIDTH << " in " << cy.getm_numberOfSlots() << " slots" << endl;
+
+	vector< vector<long> > u(count, vector<long>(WIDTH)), v(count, vector<long>(WIDTH));
+	vector<long> expected(count, 0);
+	for(long s=0; s<count; s++)
+	{
+		for(long i=0; i<WIDTH; i++)
+		{
+			u[s][i] = RandomBnd(p2r);
+			v[s][i] = RandomBnd(p2r);
+			expected[s] = (expected[s] + u[s][i]*v[s][i]) % p2r;
+		}
+	}
+
+	Timer timerDemo(true);
+	timerDemo.start();
+
+    std::cout <<"******Segmented scalar products******"<<endl<<endl;
+	CyCtxt cu = cy.encryptSegments(u, WIDTH);
+	CyCtxt cv = cy.encryptSegments(v, WIDTH);
+	cu.segmentScalarProd(cv, WIDTH);
+	vector<long> slots = cy.decrypt(cu, false);
+	vector<long> results = cy.unpackSegments(slots, WIDTH, count);
+
+	timerDemo.stop();
+	timerDemo.benchmarkInSeconds();
+
+	// Every slot of a segment holds its scalar product, the slots after the last segment 0.
+	long errors = 0;
+	for(long i=0; i<(long) slots.size(); i++)
+	{
+		long s = i/WIDTH;
+		if(slots[i] != (s < count ? expected[s] : 0))
+		{
+			errors++;
+		}
+	}
+	for(long s=0; s<count; s++)
+	{
+		if(results[s] != expected[s])
+		{
+			errors++;
+		}
+	}
+
+    // Skip a line.
+    std::cout <<"\n"<<endl;
+
+	if(errors != 0)
+	{
+		std::cout << "Demo_Cyfhel_Segments FAILED: " << errors << " mismatches." << endl;
+		return 1;
+	}
+
+    // Display the end of the program.
+    std::cout <<"     ************End of Demo_Cyfhel_Segments************" <<endl;
+
+    // Skip a line.
+    std::cout <<"\n"<<endl;
+
+    // If success, return 0.
+    return 0;
+};
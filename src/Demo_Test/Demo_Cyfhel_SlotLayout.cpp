@@ -0,0 +1,140 @@
+/*
+#   Demo_Cyfhel_SlotLayout
+#   --------------------------------------------------------------------
+#   A small matrix placed in the slots by a CySlotLayout chosen for
+#   its rotations: row sums, a shift of the columns and a shift of the
+#   rows, compared with the linear (row-major) layout of the same
+#   matrix. The results are checked.
+#   --------------------------------------------------------------------
+#   Author: Remy AUDA & Alexandre AUDA
+#   Date: 19/10/2026
+#   --------------------------------------------------------------------
+#   License: GNU GPL v3
+#
+#   Demo_Cyfhel is free software: you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation, either version 3 of the License, or
+#   (at your option) any later version.
+#
+#   Demo_Cyfhel is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#   --------------------------------------------------------------------
+*/
+
+/* Import all the packages useful for the Demo.*/
+#include <NTL/ZZ.h>
+#include <NTL/BasicThreadPool.h>
+#include <FHE.h>
+#include <timing.h>
+#include <EncryptedArray.h>
+#include <NTL/lzz_pXFactoring.h>
+
+#include <Cyfhel.h>
+#include "Timer.h"
+
+#include <cassert>
+#include <cstdio>
+
+/* The size of the matrix of the demo.*/
+#define ROWS 2
+#define COLS 3
+
+
+/*
+	@name: run
+	@description: Encrypt M in layout, compute its row sums, shift its columns by 1 and its rows by 1, and compare with
+	              the plaintext results.
+
+	@return: Return the number of mismatches.
+*/
+static long run(Cyfhel& cy, CySlotLayout const& layout, vector< vector<long> > const& M, long p2r){
+	std::cout << layout << endl;
+	long errors = 0;
+
+	vector<long> slots = layout.encode(M);
+	CyCtxt sums = cy.encrypt(slots);
+	CyCtxt shifted = sums;
+
+	layout.sum(sums, CySlotLayout::colAxis);
+	layout.rotate(shifted, CySlotLayout::colAxis, 1);
+	layout.rotate(shifted, CySlotLayout::rowAxis, 1);
+
+	vector< vector<long> > S = layout.decode(cy.decrypt(sums, false));
+	vector< vector<long> > R = layout.decode(cy.decrypt(shifted, false));
+	for(long i=0; i<ROWS; i++)
+	{
+		long rowSum = 0;
+		for(long j=0; j<COLS; j++)
+		{
+			rowSum = (rowSum + M[i][j]) % p2r;
+		}
+		for(long j=0; j<COLS; j++)
+		{
+			if(S[i][j] != rowSum || R[(i+1)%ROWS][(j+1)%COLS] != M[i][j])
+			{
+				errors++;
+			}
+		}
+	}
+	return errors;
+}
+
+
+int main(int argc, char *argv[])
+{
+    // Display the title of the program.
+    std::cout <<"" <<endl;
+    std::cout <<"     ************Demo_Cyfhel_SlotLayout************" <<endl;
+    std::cout <<"" <<endl;
+
+    std::cout <<"******Generation of the keys for encryption******"<<endl<<endl;
+
+	Cyfhel cy(false, 1031, 1, 2, 1, 80, 64, 8);
+	const long p2r = cy.getp2r();
+
+	vector< vector<long> > M(ROWS, vector<long>(COLS));
+	for(long i=0; i<ROWS; i++)
+	{
+		for(long j=0; j<COLS; j++)
+		{
+			M[i][j] = RandomBnd(p2r);
+		}
+	}
+
+	long errors = 0;
+
+	Timer timerDemo(true);
+	timerDemo.start();
+
+    std::cout <<"******Layout chosen for the rotations******"<<endl<<endl;
+	errors += run(cy, cy.slotLayout(ROWS, COLS, 1, 3), M, p2r);
+
+    std::cout <<"******Linear layout******"<<endl<<endl;
+	errors += run(cy, cy.slotLayout(ROWS, COLS), M, p2r);
+
+	timerDemo.stop();
+	timerDemo.benchmarkInSeconds();
+
+    // Skip a line.
+    std::cout <<"\n"<<endl;
+
+	if(errors != 0)
+	{
+		std::cout << "Demo_Cyfhel_SlotLayout FAILED: " << errors << " mismatches." << endl;
+		return 1;
+	}
+
+    // Display the end of the program.
+    std::cout <<"     ************End of Demo_Cyfhel_SlotLayout************" <<endl;
+
+    // Skip a line.
+    std::cout <<"\n"<<endl;
+
+    // If success, return 0.
+    return 0;
+};
@@ -0,0 +1,190 @@
+/*
+#   Test_Cyfhel_Threads
+#   --------------------------------------------------------------------
+#   Stress test: N threads run mixed CyCtxt operations against one shared
+#   Cyfhel object (same keys, same encrypted array) and check every result
+#   against the same computation on the plaintexts.
+#   --------------------------------------------------------------------
+#   Author: Remy AUDA & Alexandre AUDA
+#   Date: 19/10/2026
+#   --------------------------------------------------------------------
+#   License: GNU GPL v3
+#
+#   Demo_Cyfhel is free software: you can redistribute it and/or modify
+#   it under the terms of the GNU General Public License as published by
+#   the Free Software Foundation, either version 3 of the License, or
+#   (at your option) any later version.
+#
+#   Demo_Cyfhel is distributed in the hope that it will be useful,
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#   GNU General Public License for more details.
+#
+#   You should have received a copy of the GNU General Public License
+#   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#   --------------------------------------------------------------------
+*/
+
+/* Import all the packages useful for the Test.*/
+#include <NTL/ZZ.h>
+#include <NTL/BasicThreadPool.h>
+#include <FHE.h>
+#include <timing.h>
+#include <EncryptedArray.h>
+#include <NTL/lzz_pXFactoring.h>
+
+#include <Cyfhel.h>
+#include "Timer.h"
+
+#include <thread>
+#include <atomic>
+#include <cassert>
+#include <cstdio>
+
+/* The vector size of the plaintext that we will use for the test.*/
+#define VECTOR_SIZE 8
+
+/* Define the max value of an element in the vector (value will be choosen between 0 and RANGEOFRANDOM).*/
+#define RANGEOFRANDOM 50
+
+/* Default number of threads and of iterations per thread.*/
+#define NB_THREADS 8
+#define NB_ITERATIONS 4
+
+
+/*
+	@name: longMod
+	@description: Return a modulo m, in [0, m).
+*/
+static long longMod(long a, long m){
+	return (a % m + m) % m;
+}
+
+/*
+	@name: runWorker
+	@description: One thread of the stress test. Encrypts fresh vectors, runs a mix of +, -, *, square, cube,
+	              scalar product and operations with a long, decrypts, and compares with the plaintext computation.
+	              The number of mismatches is added to errors.
+*/
+static void runWorker(Cyfhel const& cy, long id, long iterations, std::atomic<long>& errors){
+	const long p2r = cy.getp2r();
+
+	for(long k=0; k<iterations; k++)
+	{
+		// Per-thread plaintexts, values depend on the thread and the iteration.
+		vector<long> v1, v2, v3;
+		for(long i=0; i<VECTOR_SIZE; i++)
+		{
+			v1.push_back((id*7 + k*3 + i) % (RANGEOFRANDOM+1));
+			v2.push_back((id + 2*k + 5*i) % (RANGEOFRANDOM+1));
+			v3.push_back((3*id + k + i*i) % (RANGEOFRANDOM+1));
+		}
+
+		CyCtxt c1 = cy.encrypt(v1);
+		CyCtxt c2 = cy.encrypt(v2);
+		CyCtxt c3 = cy.encrypt(v3);
+
+		// Mixed operations: relinearization (key switching) happens in every multiplication.
+		CyCtxt cMixed = (c1 + c2) * c3 - c1;
+		CyCtxt cSquare = c2.returnSquare();
+		CyCtxt cCube = c3.returnCube();
+		CyCtxt cPlusLong = c1 + 3;
+		CyCtxt cScalar = c1.returnScalarProd(c2);
+
+		vector<long> rMixed = cy.decrypt(cMixed);
+		vector<long> rSquare = cy.decrypt(cSquare);
+		vector<long> rCube = cy.decrypt(cCube);
+		vector<long> rPlusLong = cy.decrypt(cPlusLong);
+		vector<long> rScalar = cy.decrypt(cScalar);
+
+		long scalar = 0;
+		for(long i=0; i<VECTOR_SIZE; i++)
+		{
+			scalar = longMod(scalar + v1[i]*v2[i], p2r);
+		}
+
+		for(long i=0; i<VECTOR_SIZE; i++)
+		{
+			bool ok = true;
+			ok = ok && rMixed[i] == longMod((v1[i]+v2[i])*v3[i] - v1[i], p2r);
+			ok = ok && rSquare[i] == longMod(v2[i]*v2[i], p2r);
+			ok = ok && rCube[i] == longMod(v3[i]*v3[i]*v3[i], p2r);
+			ok = ok && rPlusLong[i] == longMod(v1[i] + 3, p2r);
+			ok = ok && rScalar[i] == scalar;
+			if(!ok)
+			{
+				errors++;
+			}
+		}
+	}
+}
+
+
+int main(int argc, char *argv[])
+{
+	long nbThreads = NB_THREADS;
+	long nbIterations = NB_ITERATIONS;
+	if(argc > 1)
+	{
+		nbThreads = atol(argv[1]);
+	}
+	if(argc > 2)
+	{
+		nbIterations = atol(argv[2]);
+	}
+
+    // Display the title of the program.
+    std::cout <<"" <<endl;
+    std::cout <<"     ************Test_Cyfhel_Threads************" <<endl;
+    std::cout <<"" <<endl;
+
+    std::cout <<"******Generation of the keys for encryption******"<<endl<<endl;
+
+	// One Cyfhel object shared (read-only) by all the threads.
+	Cyfhel cy(false, 1031, 1, 2, 1, 80, 64, 8);
+
+	std::cout <<"******Run "<< nbThreads <<" threads of "<< nbIterations <<" iterations******"<<endl<<endl;
+
+	std::atomic<long> errors(0);
+
+	// Sequential reference run, to compare the throughput.
+	Timer timerSequential(true);
+	timerSequential.start();
+	runWorker(cy, 0, nbIterations, errors);
+	timerSequential.stop();
+	std::cout << "One thread: ";
+	timerSequential.benchmarkInSeconds();
+
+	Timer timerThreads(true);
+	timerThreads.start();
+	vector<std::thread> threads;
+	for(long t=0; t<nbThreads; t++)
+	{
+		threads.push_back(std::thread(runWorker, std::cref(cy), t, nbIterations, std::ref(errors)));
+	}
+	for(long t=0; t<nbThreads; t++)
+	{
+		threads[t].join();
+	}
+	timerThreads.stop();
+	std::cout << nbThreads << " threads: ";
+	timerThreads.benchmarkInSeconds();
+
+	// Skip a line.
+	std::cout <<"\n"<<endl;
+
+	if(errors != 0)
+	{
+		std::cout << "Test_Cyfhel_Threads FAILED: " << errors << " mismatches." << endl;
+		return 1;
+	}
+
+	// Display the end of the program.
+	std::cout <<"     ************Test_Cyfhel_Threads: all results match************" <<endl;
+
+	// Skip a line.
+	std::cout <<"\n"<<endl;
+
+	// If success, return 0.
+	return 0;
+};